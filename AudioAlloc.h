@@ -0,0 +1,48 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * AudioAlloc.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _AUDIOALLOC_H_
+#define _AUDIOALLOC_H_
+
+#include <new>
+
+//Uncomment (or add -DNRF52AUDIO_STATIC_ALLOC to the build flags) to build the
+//library without any heap use. Objects the library creates for itself are then
+//built in storage inside the object that owns them:
+// - SDWavFile and BundleWavFile keep their BufferedFileReader inside the file
+// - ChainedSDWavFile and SmoothSwingWavFile keep their SDWavFiles inside themselves
+// - I2SWavPlayer keeps its default I2S output inside itself
+// - AudioRuntime keeps its task stacks and mutex inside itself
+//                (needs configSUPPORT_STATIC_ALLOCATION in FreeRTOSConfig.h)
+//The SD library still mallocs a small handle for each file it opens, when
+//the file is created. Nothing is allocated while playing.
+//Objects get bigger, so create them in static storage rather than on the
+//stack. Anything the application creates can be placement-constructed in
+//its own storage:
+//
+//   static uint8_t saHumStorage[sizeof(SDWavFile)] __attribute__((aligned(4)));
+//   SDWavFile* lpHum = new(saHumStorage) SDWavFile("hum.wav"); //After SD.begin()
+//   ...
+//   lpHum->~SDWavFile();
+//
+//#define NRF52AUDIO_STATIC_ALLOC
+
+#endif /* _AUDIOALLOC_H_ */
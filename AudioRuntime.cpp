@@ -0,0 +1,204 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * AudioRuntime.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "AudioRuntime.h"
+
+AudioRuntime* volatile AudioRuntime::spActiveRuntime = nullptr;
+
+AudioRuntime::AudioRuntime(I2SWavPlayer* apPlayer, IOScheduler* apScheduler)
+{
+	mpPlayer = apPlayer;
+	mpIOScheduler = apScheduler;
+	mAudioTaskHandle = nullptr;
+	mIOTaskHandle = nullptr;
+	mReaderMutex = nullptr;
+	mNumBlocks = 0;
+}
+
+AudioRuntime::~AudioRuntime()
+{
+	End();
+}
+
+bool AudioRuntime::Begin(uint32_t aAudioStackSize,
+						 UBaseType_t aAudioPriority,
+						 uint32_t aIOStackSize,
+						 UBaseType_t aIOPriority)
+{
+	if(nullptr != spActiveRuntime || nullptr == mpPlayer)
+	{
+		return false;
+	}
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	if(aAudioStackSize > AUDIO_TASK_STACK_SIZE || aIOStackSize > IO_TASK_STACK_SIZE)
+	{
+		return false;
+	}
+
+	mReaderMutex = xSemaphoreCreateMutexStatic(&mReaderMutexBuffer);
+#else
+	mReaderMutex = xSemaphoreCreateMutex();
+#endif
+	if(nullptr == mReaderMutex)
+	{
+		return false;
+	}
+
+	if(nullptr != mpIOScheduler)
+	{
+		//The I/O task services the scheduler, the mixer only consumes what was read ahead
+		mpPlayer->SetIOScheduler(mpIOScheduler, false);
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+		mIOTaskHandle = xTaskCreateStatic(IOTask, "AudioIO", aIOStackSize, this, aIOPriority, maIOStack, &mIOTaskBuffer);
+		if(nullptr == mIOTaskHandle)
+#else
+		if(pdPASS != xTaskCreate(IOTask, "AudioIO", aIOStackSize, this, aIOPriority, &mIOTaskHandle))
+#endif
+		{
+			mIOTaskHandle = nullptr;
+			End();
+			return false;
+		}
+	}
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	mAudioTaskHandle = xTaskCreateStatic(AudioTask, "AudioMix", aAudioStackSize, this, aAudioPriority, maAudioStack, &mAudioTaskBuffer);
+	if(nullptr == mAudioTaskHandle)
+#else
+	if(pdPASS != xTaskCreate(AudioTask, "AudioMix", aAudioStackSize, this, aAudioPriority, &mAudioTaskHandle))
+#endif
+	{
+		mAudioTaskHandle = nullptr;
+		End();
+		return false;
+	}
+
+	mNumBlocks = 0;
+	spActiveRuntime = this;
+	mpPlayer->StartPlayback();
+
+	//Interrupt whenever the hardware picks up a new buffer
+	NVIC_SetPriority(I2S_IRQn, AUDIO_I2S_IRQ_PRIORITY);
+	NVIC_ClearPendingIRQ(I2S_IRQn);
+	NVIC_EnableIRQ(I2S_IRQn);
+	NRF_I2S->INTENSET = I2S_INTENSET_TXPTRUPD_Msk;
+
+	return true;
+}
+
+void AudioRuntime::End()
+{
+	if(this == spActiveRuntime)
+	{
+		NRF_I2S->INTENCLR = I2S_INTENCLR_TXPTRUPD_Msk;
+		NVIC_DisableIRQ(I2S_IRQn);
+		spActiveRuntime = nullptr;
+		mpPlayer->StopPlayback();
+	}
+
+	//Wait for any mixing or reading in progress to finish before deleting the tasks
+	if(nullptr != mReaderMutex)
+	{
+		xSemaphoreTake(mReaderMutex, portMAX_DELAY);
+	}
+
+	if(nullptr != mAudioTaskHandle)
+	{
+		vTaskDelete(mAudioTaskHandle);
+		mAudioTaskHandle = nullptr;
+	}
+
+	if(nullptr != mIOTaskHandle)
+	{
+		vTaskDelete(mIOTaskHandle);
+		mIOTaskHandle = nullptr;
+
+		//Go back to servicing the scheduler while mixing
+		mpPlayer->SetIOScheduler(mpIOScheduler);
+	}
+
+	if(nullptr != mReaderMutex)
+	{
+		xSemaphoreGive(mReaderMutex);
+		vSemaphoreDelete(mReaderMutex);
+		mReaderMutex = nullptr;
+	}
+}
+
+void AudioRuntime::HandleI2SInterrupt()
+{
+	AudioRuntime* lpRuntime = spActiveRuntime;
+
+	if(nullptr == lpRuntime || 0 == NRF_I2S->EVENTS_TXPTRUPD)
+	{
+		return;
+	}
+
+	//The audio task clears the event when it hands the hardware the next buffer.
+	//Mask the interrupt until then so it doesn't keep firing.
+	NRF_I2S->INTENCLR = I2S_INTENCLR_TXPTRUPD_Msk;
+
+	BaseType_t lHigherPriorityTaskWoken = pdFALSE;
+	vTaskNotifyGiveFromISR(lpRuntime->mAudioTaskHandle, &lHigherPriorityTaskWoken);
+	portYIELD_FROM_ISR(lHigherPriorityTaskWoken);
+}
+
+void AudioRuntime::AudioTask(void* apRuntime)
+{
+	AudioRuntime* lpRuntime = (AudioRuntime*)apRuntime;
+
+	for(;;)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		xSemaphoreTake(lpRuntime->mReaderMutex, portMAX_DELAY);
+		lpRuntime->mpPlayer->ContinuePlayback();
+		xSemaphoreGive(lpRuntime->mReaderMutex);
+
+		lpRuntime->mNumBlocks++;
+
+		//Refill read buffers while we wait for the next interrupt
+		if(nullptr != lpRuntime->mIOTaskHandle)
+		{
+			xTaskNotifyGive(lpRuntime->mIOTaskHandle);
+		}
+
+		NRF_I2S->INTENSET = I2S_INTENSET_TXPTRUPD_Msk;
+	}
+}
+
+void AudioRuntime::IOTask(void* apRuntime)
+{
+	AudioRuntime* lpRuntime = (AudioRuntime*)apRuntime;
+
+	for(;;)
+	{
+		//Wake up after every mixed block, or periodically if playback has stalled
+		ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IO_TASK_PERIOD_MS));
+
+		xSemaphoreTake(lpRuntime->mReaderMutex, portMAX_DELAY);
+		lpRuntime->mpIOScheduler->Service();
+		xSemaphoreGive(lpRuntime->mReaderMutex);
+	}
+}
@@ -0,0 +1,197 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * AudioRuntime.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _AUDIORUNTIME_H_
+#define _AUDIORUNTIME_H_
+
+#include <Arduino.h>
+#include "AudioAlloc.h"
+#include "I2SWavPlayer.h"
+#include "IOScheduler.h"
+
+#if defined(NRF52AUDIO_STATIC_ALLOC) && !configSUPPORT_STATIC_ALLOCATION
+#error "NRF52AUDIO_STATIC_ALLOC needs configSUPPORT_STATIC_ALLOCATION set to 1 in FreeRTOSConfig.h"
+#endif
+
+//Stack size of the audio task (in 32-bit words)
+#ifndef AUDIO_TASK_STACK_SIZE
+#define AUDIO_TASK_STACK_SIZE 512
+#endif
+
+//Priority of the audio task. Should be higher than anything else that runs for long.
+#ifndef AUDIO_TASK_PRIORITY
+#define AUDIO_TASK_PRIORITY 4
+#endif
+
+//Stack size of the I/O task (in 32-bit words). SD card reads need more stack than mixing.
+#ifndef IO_TASK_STACK_SIZE
+#define IO_TASK_STACK_SIZE 1024
+#endif
+
+//Priority of the I/O task. Should be lower than the audio task.
+#ifndef IO_TASK_PRIORITY
+#define IO_TASK_PRIORITY 2
+#endif
+
+//Longest the I/O task waits for the audio task before servicing the scheduler anyway (ms)
+#ifndef IO_TASK_PERIOD_MS
+#define IO_TASK_PERIOD_MS 20
+#endif
+
+//NVIC priority of the I2S interrupt. Must not be higher (numerically lower) than
+//configMAX_SYSCALL_INTERRUPT_PRIORITY since the handler calls FreeRTOS.
+#ifndef AUDIO_I2S_IRQ_PRIORITY
+#define AUDIO_I2S_IRQ_PRIORITY 3
+#endif
+
+//Defines the I2S interrupt handler the runtime is driven by. The library
+//doesn't define it itself, so sketches that don't use the runtime are free to
+//use the interrupt. Put this at file scope in one source file of any sketch
+//that uses AudioRuntime:
+//
+//   AUDIO_RUNTIME_I2S_IRQ_HANDLER()
+//
+#define AUDIO_RUNTIME_I2S_IRQ_HANDLER()     \
+	extern "C" void I2S_IRQHandler(void)    \
+	{                                       \
+		AudioRuntime::HandleI2SInterrupt(); \
+	}
+
+/**
+ * Runs an I2SWavPlayer from FreeRTOS tasks instead of a polling loop.
+ *
+ * The audio task sleeps until the I2S interrupt reports that the hardware has
+ * picked up a buffer, then mixes the next block. After each block it notifies
+ * the I/O task, which refills file read buffers through an IOScheduler while
+ * the audio task sleeps again. A mutex makes sure the two never touch the
+ * file readers at the same time.
+ *
+ * While the runtime is running, nothing else should call the player directly.
+ * Use the player's Queue functions to control it from other tasks or interrupts.
+ * The runtime is driven by the I2S interrupt, so the player must use its
+ * default I2S output (see I2SWavPlayer::SetOutputSink()), and the sketch must
+ * define the handler with AUDIO_RUNTIME_I2S_IRQ_HANDLER().
+ */
+class AudioRuntime
+{
+public:
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apPlayer - Player to run, must be initialized
+	 *  apScheduler - (optional) Scheduler for the I/O task to service, nullptr if none
+	 */
+	AudioRuntime(I2SWavPlayer* apPlayer, IOScheduler* apScheduler = nullptr);
+
+	/**
+	 * Destructor. Stops the tasks if they are running.
+	 */
+	~AudioRuntime();
+
+	/**
+	 * Start playback and the audio and I/O tasks. Only one runtime can run at a time.
+	 * When NRF52AUDIO_STATIC_ALLOC is defined the task stacks are kept in the
+	 * runtime, so the stack sizes can't be bigger than the defaults.
+	 * Args:
+	 *  aAudioStackSize - Audio task stack size (32-bit words)
+	 *  aAudioPriority - Audio task priority
+	 *  aIOStackSize - I/O task stack size (32-bit words)
+	 *  aIOPriority - I/O task priority
+	 * Returns: TRUE if the tasks were started, FALSE otherwise
+	 */
+	bool Begin(uint32_t aAudioStackSize = AUDIO_TASK_STACK_SIZE,
+			   UBaseType_t aAudioPriority = AUDIO_TASK_PRIORITY,
+			   uint32_t aIOStackSize = IO_TASK_STACK_SIZE,
+			   UBaseType_t aIOPriority = IO_TASK_PRIORITY);
+
+	/**
+	 * Stop playback and delete the tasks.
+	 */
+	void End();
+
+	/**
+	 * Check if the runtime tasks are running.
+	 */
+	inline bool IsRunning()
+	{
+		return nullptr != mAudioTaskHandle;
+	}
+
+	/**
+	 * Fetch how many blocks the audio task has mixed.
+	 */
+	inline unsigned long GetNumBlocks()
+	{
+		return mNumBlocks;
+	}
+
+	/**
+	 * Called by the I2S interrupt handler (see AUDIO_RUNTIME_I2S_IRQ_HANDLER()).
+	 * Not for use by applications.
+	 */
+	static void HandleI2SInterrupt();
+
+protected:
+
+	/**
+	 * Audio task entry point.
+	 * Args:
+	 *  apRuntime - The AudioRuntime that created the task
+	 */
+	static void AudioTask(void* apRuntime);
+
+	/**
+	 * I/O task entry point.
+	 * Args:
+	 *  apRuntime - The AudioRuntime that created the task
+	 */
+	static void IOTask(void* apRuntime);
+
+	//Player being run
+	I2SWavPlayer* mpPlayer;
+
+	//Scheduler serviced by the I/O task (nullptr if none)
+	IOScheduler* mpIOScheduler;
+
+	//Task handles (nullptr if not running)
+	TaskHandle_t mAudioTaskHandle;
+	TaskHandle_t mIOTaskHandle;
+
+	//Keeps the audio and I/O tasks from using the file readers at the same time
+	SemaphoreHandle_t mReaderMutex;
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	//Storage the tasks and mutex are built in
+	StaticTask_t mAudioTaskBuffer;
+	StaticTask_t mIOTaskBuffer;
+	StackType_t maAudioStack[AUDIO_TASK_STACK_SIZE];
+	StackType_t maIOStack[IO_TASK_STACK_SIZE];
+	StaticSemaphore_t mReaderMutexBuffer;
+#endif
+
+	//Number of blocks mixed by the audio task
+	volatile unsigned long mNumBlocks;
+
+	//Runtime that owns the I2S interrupt (nullptr if none)
+	static AudioRuntime* volatile spActiveRuntime;
+};
+
+#endif /* _AUDIORUNTIME_H_ */
@@ -0,0 +1,257 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * BiquadFilter.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include <math.h>
+#include "BiquadFilter.h"
+
+BiquadFilter::BiquadFilter()
+{
+	//Pass through
+	maCoefs[eeB0] = 1 << BIQUAD_COEF_SHIFT;
+	maCoefs[eeB1] = 0;
+	maCoefs[eeB2] = 0;
+	maCoefs[eeA1] = 0;
+	maCoefs[eeA2] = 0;
+
+	mType = eeLowPass;
+	mSampleRate = 22050;
+	mFrequency = 0.0;
+	mQ = 0.0;
+	mGainDb = 0.0;
+	mTargetFrequency = 0.0;
+	mTargetQ = 0.0;
+	mTargetGainDb = 0.0;
+
+	mIsSmoothing = false;
+	mIsConfigured = false;
+
+	Reset();
+}
+
+BiquadFilter::~BiquadFilter()
+{
+	//Nothing to do
+}
+
+void BiquadFilter::Configure(EBiquadType aType, float aFrequency, float aQ, uint32_t aSampleRate, float aGainDb)
+{
+	//Keep the frequency just below Nyquist and the Q positive so the filter stays stable
+	float lNyquist = aSampleRate / 2.0f;
+	if(aFrequency > lNyquist * 0.99f)
+	{
+		aFrequency = lNyquist * 0.99f;
+	}
+	if(aFrequency < 1.0f)
+	{
+		aFrequency = 1.0f;
+	}
+	if(aQ < 0.1f)
+	{
+		aQ = 0.1f;
+	}
+	if(aGainDb > BIQUAD_MAX_GAIN_DB)
+	{
+		aGainDb = BIQUAD_MAX_GAIN_DB;
+	}
+	else if(aGainDb < -BIQUAD_MAX_GAIN_DB)
+	{
+		aGainDb = -BIQUAD_MAX_GAIN_DB;
+	}
+
+	mTargetFrequency = aFrequency;
+	mTargetQ = aQ;
+	mTargetGainDb = aGainDb;
+
+	if(!mIsConfigured || aType != mType || aSampleRate != mSampleRate)
+	{
+		//Nothing sensible to glide from
+		mType = aType;
+		mSampleRate = aSampleRate;
+		mFrequency = aFrequency;
+		mQ = aQ;
+		mGainDb = aGainDb;
+		mIsConfigured = true;
+		mIsSmoothing = false;
+
+		CalculateCoefficients();
+	}
+	else
+	{
+		mIsSmoothing = true;
+	}
+}
+
+void BiquadFilter::Process(int16_t* apBuffer, int aNumSamples)
+{
+	int32_t lX1 = mX1;
+	int32_t lX2 = mX2;
+	int32_t lY1 = mY1;
+	int32_t lY2 = mY2;
+	int64_t lError = mError;
+
+	int lSampleIndex = 0;
+	while(lSampleIndex < aNumSamples)
+	{
+		int lEnd = aNumSamples;
+		if(mIsSmoothing)
+		{
+			SmoothParameters();
+
+			//Only run one smoothing block with these coefficients
+			if(lEnd > lSampleIndex + BIQUAD_SMOOTH_BLOCK)
+			{
+				lEnd = lSampleIndex + BIQUAD_SMOOTH_BLOCK;
+			}
+		}
+
+		int32_t lB0 = maCoefs[eeB0];
+		int32_t lB1 = maCoefs[eeB1];
+		int32_t lB2 = maCoefs[eeB2];
+		int32_t lA1 = maCoefs[eeA1];
+		int32_t lA2 = maCoefs[eeA2];
+
+		for(; lSampleIndex < lEnd; lSampleIndex++)
+		{
+			int32_t lX0 = apBuffer[lSampleIndex];
+
+			int64_t lAccumulator = (int64_t)lB0 * lX0
+								 + (int64_t)lB1 * lX1
+								 + (int64_t)lB2 * lX2
+								 - (int64_t)lA1 * lY1
+								 - (int64_t)lA2 * lY2
+								 + lError;
+
+			//Feed the bits lost by the shift into the next sample. Without this the
+			//rounding error is amplified by low cutoff filters into audible noise.
+			int32_t lY0 = (int32_t)(lAccumulator >> BIQUAD_COEF_SHIFT);
+			lError = lAccumulator - ((int64_t)lY0 << BIQUAD_COEF_SHIFT);
+
+			//Clip to 16 bits, keeping the clipped value in the history
+			if(lY0 > INT16_MAX)
+			{
+				lY0 = INT16_MAX;
+			}
+			else if(lY0 < INT16_MIN)
+			{
+				lY0 = INT16_MIN;
+			}
+
+			lX2 = lX1;
+			lX1 = lX0;
+			lY2 = lY1;
+			lY1 = lY0;
+
+			apBuffer[lSampleIndex] = lY0;
+		}
+	}
+
+	mX1 = lX1;
+	mX2 = lX2;
+	mY1 = lY1;
+	mY2 = lY2;
+	mError = lError;
+}
+
+void BiquadFilter::Reset()
+{
+	mX1 = 0;
+	mX2 = 0;
+	mY1 = 0;
+	mY2 = 0;
+	mError = 0;
+}
+
+void BiquadFilter::SmoothParameters()
+{
+	mFrequency += (mTargetFrequency - mFrequency) * BIQUAD_SMOOTH_FACTOR;
+	mQ += (mTargetQ - mQ) * BIQUAD_SMOOTH_FACTOR;
+	mGainDb += (mTargetGainDb - mGainDb) * BIQUAD_SMOOTH_FACTOR;
+
+	//Snap to the targets once the difference can't be heard
+	if(fabsf(mTargetFrequency - mFrequency) < 1.0f
+			&& fabsf(mTargetQ - mQ) < 0.01f
+			&& fabsf(mTargetGainDb - mGainDb) < 0.1f)
+	{
+		mFrequency = mTargetFrequency;
+		mQ = mTargetQ;
+		mGainDb = mTargetGainDb;
+		mIsSmoothing = false;
+	}
+
+	CalculateCoefficients();
+}
+
+void BiquadFilter::CalculateCoefficients()
+{
+	float lOmega = 2.0f * (float)M_PI * mFrequency / mSampleRate;
+	float lCos = cosf(lOmega);
+	float lAlpha = sinf(lOmega) / (2.0f * mQ);
+	float lGain = powf(10.0f, mGainDb / 40.0f);
+
+	float lB0 = 1.0f;
+	float lB1 = 0.0f;
+	float lB2 = 0.0f;
+	float lA0 = 1.0f + lAlpha;
+	float lA1 = -2.0f * lCos;
+	float lA2 = 1.0f - lAlpha;
+
+	switch(mType)
+	{
+	case eeLowPass:
+		lB0 = (1.0f - lCos) / 2.0f;
+		lB1 = 1.0f - lCos;
+		lB2 = lB0;
+		break;
+	case eeHighPass:
+		lB0 = (1.0f + lCos) / 2.0f;
+		lB1 = -(1.0f + lCos);
+		lB2 = lB0;
+		break;
+	case eeBandPass:
+		lB0 = lAlpha;
+		lB1 = 0.0f;
+		lB2 = -lAlpha;
+		break;
+	case eeNotch:
+		lB0 = 1.0f;
+		lB1 = -2.0f * lCos;
+		lB2 = 1.0f;
+		break;
+	case eePeaking:
+		lB0 = 1.0f + lAlpha * lGain;
+		lB1 = -2.0f * lCos;
+		lB2 = 1.0f - lAlpha * lGain;
+		lA0 = 1.0f + lAlpha / lGain;
+		lA2 = 1.0f - lAlpha / lGain;
+		break;
+	default:
+		break;
+	}
+
+	//Normalize and convert to fixed point
+	float lScale = (float)(1 << BIQUAD_COEF_SHIFT) / lA0;
+	maCoefs[eeB0] = lrintf(lB0 * lScale);
+	maCoefs[eeB1] = lrintf(lB1 * lScale);
+	maCoefs[eeB2] = lrintf(lB2 * lScale);
+	maCoefs[eeA1] = lrintf(lA1 * lScale);
+	maCoefs[eeA2] = lrintf(lA2 * lScale);
+}
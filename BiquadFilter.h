@@ -0,0 +1,158 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * BiquadFilter.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _BIQUADFILTER_H_
+#define _BIQUADFILTER_H_
+
+#include "IAudioEffect.h"
+
+//Number of fractional bits in the filter coefficients (Q3.29)
+#define BIQUAD_COEF_SHIFT 29
+
+//Largest boost or cut allowed for peaking filters (dB). Keeps the
+//coefficients inside the Q3.29 range.
+#define BIQUAD_MAX_GAIN_DB 12.0f
+
+//How many samples are processed between coefficient smoothing steps
+#define BIQUAD_SMOOTH_BLOCK 16
+
+//Each smoothing step moves the frequency, Q and gain this fraction of the
+//way to their new values
+#define BIQUAD_SMOOTH_FACTOR 0.125f
+
+enum EBiquadType
+{
+	eeLowPass,
+	eeHighPass,
+	eeBandPass,
+	eeNotch,
+	eePeaking
+};
+
+/**
+ * Second order IIR filter in Direct Form I with fixed-point coefficients and
+ * first order error feedback.
+ * Coefficients are calculated with the RBJ audio EQ cookbook formulas when
+ * the filter is configured, and samples are processed in fixed point.
+ * Changing the frequency, Q or gain while playing glides them to their new
+ * values over a few blocks so sweeps don't click. Coefficients are recalculated
+ * for every step of the glide (every BIQUAD_SMOOTH_BLOCK samples), which keeps
+ * each step a well behaved filter. That takes a handful of single precision
+ * float operations per step, cheap on the FPU, but not free.
+ */
+class BiquadFilter : public IAudioEffect
+{
+public:
+	/**
+	 * Constructor. The filter passes audio through unchanged until configured.
+	 */
+	BiquadFilter();
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~BiquadFilter();
+
+	/**
+	 * Set the filter response. The first call, or a call that changes the type
+	 * or sample rate, takes effect immediately. Other calls glide to the new response.
+	 * Args:
+	 *  aType - Filter type
+	 *  aFrequency - Cutoff or center frequency (Hz)
+	 *  aQ - Quality factor (0.707 for a flat low/high pass)
+	 *  aSampleRate - Sample rate of the audio being filtered (Hz)
+	 *  aGainDb - (optional) Gain for peaking filters (dB, +/- BIQUAD_MAX_GAIN_DB)
+	 */
+	void Configure(EBiquadType aType, float aFrequency, float aQ, uint32_t aSampleRate, float aGainDb = 0.0);
+
+	/**
+	 * Process a block of samples in place.
+	 * Args:
+	 *  apBuffer - Samples to process
+	 *  aNumSamples - Number of samples in the buffer
+	 */
+	virtual void Process(int16_t* apBuffer, int aNumSamples);
+
+	/**
+	 * Clear the filter history.
+	 */
+	virtual void Reset();
+
+protected:
+
+	/**
+	 * Move the frequency, Q and gain one step closer to their targets
+	 * and recalculate the coefficients.
+	 */
+	void SmoothParameters();
+
+	/**
+	 * Calculate the coefficients for the current parameters.
+	 */
+	void CalculateCoefficients();
+
+	//Coefficient indexes
+	enum
+	{
+		eeB0,
+		eeB1,
+		eeB2,
+		eeA1,
+		eeA2,
+		eeNumCoefs
+	};
+
+	//Coefficients in use (Q3.29, a0 normalized to 1)
+	int32_t maCoefs[eeNumCoefs];
+
+	//Filter type
+	EBiquadType mType;
+
+	//Sample rate (Hz)
+	uint32_t mSampleRate;
+
+	//Current parameters
+	float mFrequency;
+	float mQ;
+	float mGainDb;
+
+	//Parameters being glided to
+	float mTargetFrequency;
+	float mTargetQ;
+	float mTargetGainDb;
+
+	//TRUE while the current parameters don't match the targets
+	bool mIsSmoothing;
+
+	//TRUE once Configure() has been called
+	bool mIsConfigured;
+
+	//Filter history
+	int32_t mX1;
+	int32_t mX2;
+	int32_t mY1;
+	int32_t mY2;
+
+	//Rounding error carried into the next sample
+	int64_t mError;
+};
+
+#endif /* _BIQUADFILTER_H_ */
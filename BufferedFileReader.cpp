@@ -23,12 +23,36 @@
 #include "BufferedFileReader.h"
 #include "Arduino.h"
 
-BufferedFileReader::BufferedFileReader(File* apFileHandle)
+unsigned long BufferedFileReader::sNumReadCalls = 0;
+unsigned long BufferedFileReader::sReadMicros = 0;
+unsigned long BufferedFileReader::sNumPrefetchMisses = 0;
+ReadLatencyHistogram* BufferedFileReader::spLatencyHistogram = nullptr;
+
+BufferedFileReader::BufferedFileReader(File* apFileHandle,
+									   uint32_t aRegionStart,
+									   uint32_t aRegionSize)
 {
 	mpFileHandle = apFileHandle;
 	mDataBufferPos = 0;
 	mDataBufferAvailableBytes = 0;
 	mDataBlock = 0;
+
+	mpPrefetchStorage = nullptr;
+	mNumPrefetchBlocks = 0;
+	ClearPrefetch();
+
+	uint32_t lFileSize = mpFileHandle->size();
+	mRegionStart = aRegionStart;
+	if(mRegionStart > lFileSize)
+	{
+		mRegionStart = lFileSize;
+	}
+	mRegionEnd = lFileSize;
+	if(BFR_WHOLE_FILE != aRegionSize && aRegionSize < lFileSize - mRegionStart)
+	{
+		mRegionEnd = mRegionStart + aRegionSize;
+	}
+	mFilePos = mRegionStart;
 }
 
 BufferedFileReader::~BufferedFileReader()
@@ -78,7 +102,7 @@ int BufferedFileReader::FetchBufferedBytes(int8_t* apOutBuffer, int aSize)
 
 		if(mDataBufferPos >= DATA_BLOCK_SIZE)
 		{
-			if(mpFileHandle->available() > 0)
+			if(FileAvailable() > 0)
 			{
 				ReadNextDataBlock();
 			}
@@ -92,28 +116,139 @@ int BufferedFileReader::FetchBufferedBytes(int8_t* apOutBuffer, int aSize)
 	return lActualByteCount;
 }
 
+void BufferedFileReader::SeekTo(uint32_t aPos)
+{
+	if(aPos > GetRegionSize())
+	{
+		aPos = GetRegionSize();
+	}
+
+	//Region position of the bytes in the data buffer
+	uint32_t lBufferBytes = mDataBufferPos + mDataBufferAvailableBytes;
+	uint32_t lBufferStart = mFilePos - mPrefetchBytes - lBufferBytes - mRegionStart;
+
+	//Moving forward, use blocks that were already read ahead
+	while(mPrefetchCount > 0 && aPos >= lBufferStart + lBufferBytes)
+	{
+		lBufferStart += lBufferBytes;
+		ReadNextDataBlock();
+		lBufferBytes = mDataBufferAvailableBytes;
+	}
+
+	if(aPos < lBufferStart || aPos >= lBufferStart + lBufferBytes)
+	{
+		//Not buffered, read the block the position is in
+		uint32_t lBlockStart = aPos - (aPos % DATA_BLOCK_SIZE);
+
+		ClearPrefetch();
+		memset(mDataBytes, 0, DATA_BLOCK_SIZE);
+		mFilePos = mRegionStart + lBlockStart;
+		mDataBlock = lBlockStart / DATA_BLOCK_SIZE + 1;
+		mDataBufferPos = 0;
+		mDataBufferAvailableBytes = ReadFromFile(mDataBytes);
+		lBufferStart = lBlockStart;
+	}
+
+	BufferSeek(aPos - lBufferStart);
+}
+
+void BufferedFileReader::AttachPrefetchStorage(int8_t* apStorage, int aNumBlocks)
+{
+	//Anything read ahead is about to be lost, so back up and read it again later
+	mFilePos -= mPrefetchBytes;
+	ClearPrefetch();
+
+	if(aNumBlocks > BFR_MAX_PREFETCH_BLOCKS)
+	{
+		aNumBlocks = BFR_MAX_PREFETCH_BLOCKS;
+	}
+
+	mpPrefetchStorage = apStorage;
+	mNumPrefetchBlocks = (nullptr != apStorage) ? aNumBlocks : 0;
+}
+
+int BufferedFileReader::PrefetchBlock()
+{
+	int lNumBytes = 0;
+
+	if(CanPrefetch())
+	{
+		int lSlot = (mPrefetchHead + mPrefetchCount) % mNumPrefetchBlocks;
+		lNumBytes = ReadFromFile(&mpPrefetchStorage[lSlot * DATA_BLOCK_SIZE]);
+		maPrefetchSizes[lSlot] = lNumBytes;
+		mPrefetchBytes += lNumBytes;
+		mPrefetchCount++;
+	}
+
+	return lNumBytes;
+}
+
 void BufferedFileReader::ReadNextDataBlock()
 {
 //	Serial.println("Reading data block");
 	//Clear out any existing data
 	memset(mDataBytes, 0, DATA_BLOCK_SIZE);
 
-	if(mpFileHandle->available())
+	if(FileAvailable())
 	{
 		mDataBlock++;
 	}
 	mDataBufferPos = 0;
 	mDataBufferAvailableBytes = 0;
-	if(mpFileHandle->available() >= DATA_BLOCK_SIZE)
+
+	//Use data that was read ahead if there is any
+	if(mPrefetchCount > 0)
 	{
-		mpFileHandle->read(mDataBytes, DATA_BLOCK_SIZE);
-		mDataBufferAvailableBytes = DATA_BLOCK_SIZE;
+		int lNumBytes = maPrefetchSizes[mPrefetchHead];
+		memcpy(mDataBytes, &mpPrefetchStorage[mPrefetchHead * DATA_BLOCK_SIZE], lNumBytes);
+		mDataBufferAvailableBytes = lNumBytes;
+
+		mPrefetchBytes -= lNumBytes;
+		mPrefetchHead = (mPrefetchHead + 1) % mNumPrefetchBlocks;
+		mPrefetchCount--;
+		return;
 	}
-	else
+
+	if(nullptr != mpPrefetchStorage && RegionAvailable() > 0)
 	{
-		int lNumBytes = mpFileHandle->available();
-		mpFileHandle->read(mDataBytes, lNumBytes);
-		mDataBufferAvailableBytes = lNumBytes;
+		sNumPrefetchMisses++;
+	}
+
+	mDataBufferAvailableBytes = ReadFromFile(mDataBytes);
+}
+
+int BufferedFileReader::ReadFromFile(int8_t* apBuffer)
+{
+	int lNumBytes = DATA_BLOCK_SIZE;
+	if(RegionAvailable() < DATA_BLOCK_SIZE)
+	{
+		lNumBytes = RegionAvailable();
+	}
+
+	if(lNumBytes > 0)
+	{
+		unsigned long lReadStartTime = micros();
+
+		//Somebody else may be sharing the file handle, so make sure
+		//we read from where we left off
+		if(mpFileHandle->position() != mFilePos)
+		{
+			mpFileHandle->seek(mFilePos);
+		}
+
+		mpFileHandle->read(apBuffer, lNumBytes);
+		mFilePos += lNumBytes;
+		sNumReadCalls++;
+
+		unsigned long lReadTime = micros() - lReadStartTime;
+		sReadMicros += lReadTime;
+
+		ReadLatencyHistogram* lpHistogram = spLatencyHistogram;
+		if(nullptr != lpHistogram)
+		{
+			lpHistogram->Record(lNumBytes, lReadTime);
+		}
 	}
 
+	return lNumBytes;
 }
@@ -24,9 +24,16 @@
 #define BUFFEREDFILEREADER_H_
 
 #include <SD.h>
+#include "ReadLatencyHistogram.h"
 
 #define DATA_BLOCK_SIZE 1024
 
+//Region size meaning "everything from the region start to the end of the file"
+#define BFR_WHOLE_FILE 0xFFFFFFFF
+
+//Maximum number of read-ahead blocks a reader can queue
+#define BFR_MAX_PREFETCH_BLOCKS 8
+
 /**
  * This class is responsible for reading data from a file on an SD card
  * and buffering the bytes for future processing. This class is necessary
@@ -37,6 +44,14 @@
  * So, for example, if you read 2 bytes from FileA, then 2 byes from FileB,
  * then try to read the next two bytes from FileA, the FileA read will give zeros
  * because it tossed out the entire data block when FileB was read.
+ *
+ * The reader can optionally be limited to a region of the file. It keeps track
+ * of its own read position and seeks before each block read if somebody else
+ * moved the file pointer, so several readers can share a single file handle.
+ *
+ * Read-ahead storage can be attached (normally by an IOScheduler) so that
+ * blocks are read from the SD card ahead of time and the next data block
+ * is just copied out of memory when the current one runs out.
  */
 class BufferedFileReader
 {
@@ -45,8 +60,13 @@ public:
 	 * Constructor
 	 * Args:
 	 *  apFileHandle - Pointer to file to source data from
+	 *  aRegionStart - (optional) Byte offset in the file where the data starts
+	 *  aRegionSize - (optional) Number of bytes in the region. Defaults to
+	 *                everything up to the end of the file.
 	 */
-	BufferedFileReader(File* apFileHandle);
+	BufferedFileReader(File* apFileHandle,
+					   uint32_t aRegionStart = 0,
+					   uint32_t aRegionSize = BFR_WHOLE_FILE);
 
 	/**
 	 * Destructor
@@ -84,11 +104,75 @@ public:
 	{
 		mDataBufferPos = 0;
 		mDataBlock = 0;
-		mpFileHandle->seek(0);
+		mFilePos = mRegionStart;
+		ClearPrefetch();
 
 		ReadNextDataBlock();
 	}
 
+	/**
+	 * Discards all buffered data and moves the read position to the end of
+	 * the region, so the reader reports IsEnded() without closing the file.
+	 */
+	inline void Stop()
+	{
+		mDataBufferAvailableBytes = 0;
+		mFilePos = mRegionEnd;
+		ClearPrefetch();
+	}
+
+	/**
+	 * Fetch how many bytes in the region have not been moved into the
+	 * data buffer yet. This includes bytes waiting in read-ahead blocks.
+	 */
+	inline uint32_t FileAvailable()
+	{
+		return RegionAvailable() + mPrefetchBytes;
+	}
+
+	/**
+	 * Attach storage for read-ahead blocks. Any blocks already read ahead
+	 * are discarded (and will be read again later).
+	 * Args:
+	 *  apStorage - Buffer of aNumBlocks * DATA_BLOCK_SIZE bytes, or nullptr to detach
+	 *  aNumBlocks - Number of blocks that fit in the storage
+	 *               (no more than BFR_MAX_PREFETCH_BLOCKS)
+	 */
+	void AttachPrefetchStorage(int8_t* apStorage, int aNumBlocks);
+
+	/**
+	 * Check if there is room to read another block ahead.
+	 */
+	inline bool CanPrefetch()
+	{
+		return nullptr != mpPrefetchStorage
+				&& mPrefetchCount < mNumPrefetchBlocks
+				&& RegionAvailable() > 0;
+	}
+
+	/**
+	 * Read the next block from the SD card into the read-ahead queue.
+	 * Returns: Number of bytes read (0 if there was no room or no data)
+	 */
+	int PrefetchBlock();
+
+	/**
+	 * Fetch how many bytes are sitting in memory waiting to be fetched,
+	 * in both the data buffer and the read-ahead blocks.
+	 */
+	inline uint32_t GetBufferedBytes()
+	{
+		return mDataBufferAvailableBytes + mPrefetchBytes;
+	}
+
+	/**
+	 * Fetch the size of the region being read, in bytes.
+	 */
+	inline uint32_t GetRegionSize()
+	{
+		return mRegionEnd - mRegionStart;
+	}
+
 	/**
 	 * Fetch a counter that keeps track of how many data blocks have been read.
 	 */
@@ -131,6 +215,24 @@ public:
 		return mDataBufferAvailableBytes;
 	}
 
+	/**
+	 * Move the read position anywhere in the region. Positions that are already
+	 * buffered (including read-ahead blocks) are reached without touching the
+	 * SD card, anything else costs a single block read.
+	 * Args:
+	 *   aPos - New read position, in bytes from the start of the region
+	 */
+	void SeekTo(uint32_t aPos);
+
+	/**
+	 * Fetch the read position.
+	 * Returns: Position of the next byte to be fetched, in bytes from the start of the region
+	 */
+	inline uint32_t GetPosition()
+	{
+		return mFilePos - mPrefetchBytes - mDataBufferAvailableBytes - mRegionStart;
+	}
+
 	/**
 	 * Indicates if we have run out of data in both the file and the buffer.
 	 *
@@ -140,7 +242,7 @@ public:
 	{
 		bool lbIsEnded = false;
 
-		if(0 == mDataBufferAvailableBytes && !mpFileHandle->available())
+		if(0 == mDataBufferAvailableBytes && 0 == FileAvailable())
 		{
 			lbIsEnded = true;
 		}
@@ -167,6 +269,61 @@ public:
 		return DATA_BLOCK_SIZE;
 	}
 
+	/**
+	 * Fetch total number of SD card read calls made globally by all readers.
+	 * Useful for benchmarking SD bus usage.
+	 */
+	inline static unsigned long GetNumReadCalls()
+	{
+		return sNumReadCalls;
+	}
+
+	/**
+	 * Reset the global SD card read call counter to zero.
+	 */
+	inline static void ResetNumReadCalls()
+	{
+		sNumReadCalls = 0;
+	}
+
+	/**
+	 * Fetch total time spent in SD card reads made globally by all readers,
+	 * including the seek before each read. Wraps around like micros().
+	 * Returns: Read time (microseconds)
+	 */
+	inline static unsigned long GetReadMicros()
+	{
+		return sReadMicros;
+	}
+
+	/**
+	 * Fetch total number of times a reader with read-ahead storage ran out
+	 * of read-ahead data and had to read from the SD card on demand.
+	 */
+	inline static unsigned long GetNumPrefetchMisses()
+	{
+		return sNumPrefetchMisses;
+	}
+
+	/**
+	 * Record how long every SD card read made by any reader takes, including
+	 * the seek before it. Reads are timed only while a histogram is set.
+	 * Args:
+	 *  apHistogram - Histogram to record into, or nullptr to stop recording
+	 */
+	inline static void SetLatencyHistogram(ReadLatencyHistogram* apHistogram)
+	{
+		spLatencyHistogram = apHistogram;
+	}
+
+	/**
+	 * Fetch the histogram reads are recorded into (nullptr if none).
+	 */
+	inline static ReadLatencyHistogram* GetLatencyHistogram()
+	{
+		return spLatencyHistogram;
+	}
+
 protected:
 
 	/**
@@ -176,9 +333,42 @@ protected:
 	 */
 	void ReadNextDataBlock();
 
+	/**
+	 * Reads the next block of the region from the SD card.
+	 * Args:
+	 *  apBuffer - Buffer of DATA_BLOCK_SIZE bytes to read into
+	 * Returns: Number of bytes read
+	 */
+	int ReadFromFile(int8_t* apBuffer);
+
+	/**
+	 * Fetch how many bytes in the region have not been read from the SD card yet.
+	 */
+	inline uint32_t RegionAvailable()
+	{
+		return mRegionEnd - mFilePos;
+	}
+
+	/**
+	 * Discard all read-ahead blocks.
+	 */
+	inline void ClearPrefetch()
+	{
+		mPrefetchHead = 0;
+		mPrefetchCount = 0;
+		mPrefetchBytes = 0;
+	}
+
 	//File handle to read data from
 	File* mpFileHandle;
 
+	//Byte offset in the file where the region starts
+	uint32_t mRegionStart;
+	//Byte offset in the file just past the end of the region
+	uint32_t mRegionEnd;
+	//Byte offset in the file of the next block to read
+	uint32_t mFilePos;
+
 	//Buffered data bytes
 	int8_t mDataBytes[DATA_BLOCK_SIZE];
 	//Data buffer read position
@@ -187,6 +377,31 @@ protected:
 	int mDataBlock;
 	//How many valid bytes of data are available in the data buffer
 	int mDataBufferAvailableBytes;
+
+	//Read-ahead block storage (nullptr if read-ahead is not used)
+	int8_t* mpPrefetchStorage;
+	//Number of blocks that fit in the read-ahead storage
+	int mNumPrefetchBlocks;
+	//Index of the oldest read-ahead block
+	int mPrefetchHead;
+	//Number of read-ahead blocks waiting to be used
+	int mPrefetchCount;
+	//Total valid bytes in all read-ahead blocks
+	uint32_t mPrefetchBytes;
+	//Valid bytes in each read-ahead block
+	int maPrefetchSizes[BFR_MAX_PREFETCH_BLOCKS];
+
+	//Keep track of how many SD card reads were made globally
+	static unsigned long sNumReadCalls;
+
+	//Keep track of how long SD card reads took globally
+	static unsigned long sReadMicros;
+
+	//Keep track of how many times read-ahead data ran out globally
+	static unsigned long sNumPrefetchMisses;
+
+	//Where SD card read times are recorded globally (nullptr if they are not)
+	static ReadLatencyHistogram* spLatencyHistogram;
 };
 
 
@@ -0,0 +1,79 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * BundleWavFile.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "BundleWavFile.h"
+
+BundleWavFile::BundleWavFile(FontBundle* apBundle, int aSoundIndex)
+: SDWavFile() //Call superclass constructor
+{
+	mpBundle = apBundle;
+	Open(aSoundIndex);
+}
+
+BundleWavFile::BundleWavFile(FontBundle* apBundle, const char* apName)
+: SDWavFile() //Call superclass constructor
+{
+	mpBundle = apBundle;
+	Open(apBundle->FindSound(apName));
+}
+
+BundleWavFile::~BundleWavFile()
+{
+	//Let go of the bundle's handle before the superclass closes the file
+	Close();
+}
+
+void BundleWavFile::Close()
+{
+	//Don't close the shared handle, just stop using it
+	mIsLooping = false;
+	SetIOScheduler(nullptr, 0);
+	DestroyFileReader();
+	mpFileHandle = &sNullFileHandle;
+}
+
+void BundleWavFile::Open(int aSoundIndex)
+{
+	mSoundIndex = aSoundIndex;
+
+	uint32_t lOffset = 0;
+	uint32_t lSize = 0;
+	if(mpBundle->IsValid() && aSoundIndex >= 0 && aSoundIndex < mpBundle->GetNumSounds())
+	{
+		mpFilePath = mpBundle->GetEntry(aSoundIndex).mName;
+		lOffset = mpBundle->GetEntry(aSoundIndex).mOffset;
+		lSize = mpBundle->GetEntry(aSoundIndex).mSize;
+
+		//Loop the part of the sound marked in the bundle
+		SetLoopPoints(mpBundle->GetEntry(aSoundIndex).mLoopStart, mpBundle->GetEntry(aSoundIndex).mLoopEnd);
+	}
+	else
+	{
+		mSoundIndex = -1;
+	}
+
+	//Use the bundle's handle, it is shared by all sounds in the bundle
+	mpFileHandle = &mpBundle->GetFileHandle();
+	CreateFileReader(lOffset, lSize);
+
+	ReadHeader();
+	ReadDataHeader();
+}
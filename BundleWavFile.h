@@ -0,0 +1,98 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * BundleWavFile.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _BUNDLEWAVFILE_H_
+#define _BUNDLEWAVFILE_H_
+
+#include "SDWavFile.h"
+#include "FontBundle.h"
+
+/**
+ * This class plays a single sound out of a FontBundle. It is a lightweight
+ * cursor into the bundle's file: no file is opened and no directory lookup
+ * is done, all it needs is its own read buffer. Any number of these can
+ * share one bundle. When looping, the loop points stored in the bundle are used.
+ */
+class BundleWavFile : public SDWavFile
+{
+public:
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apBundle - Bundle that holds the sound
+	 *  aSoundIndex - Index of the sound in the bundle
+	 */
+	BundleWavFile(FontBundle* apBundle, int aSoundIndex);
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apBundle - Bundle that holds the sound
+	 *  apName - Name of the sound in the bundle
+	 */
+	BundleWavFile(FontBundle* apBundle, const char* apName);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~BundleWavFile();
+
+	/**
+	 * Close the sound. The bundle's file handle is left open since
+	 * other sounds may be using it.
+	 */
+	virtual void Close();
+
+	/**
+	 * Fetch the index of this sound in the bundle.
+	 * Returns: Index of the sound or -1 if the sound was not found
+	 */
+	inline int GetSoundIndex()
+	{
+		return mSoundIndex;
+	}
+
+	/**
+	 * Fetch the bundle index entry for this sound.
+	 * NOTE: Only valid if GetSoundIndex() is not -1.
+	 */
+	inline const tFontBundleEntry& GetEntry()
+	{
+		return mpBundle->GetEntry(mSoundIndex);
+	}
+
+protected:
+
+	/**
+	 * Set up the read buffer for a sound and read its headers.
+	 * Args:
+	 *  aSoundIndex - Index of the sound in the bundle
+	 */
+	void Open(int aSoundIndex);
+
+	//Bundle that holds the sound
+	FontBundle* mpBundle;
+
+	//Index of the sound in the bundle
+	int mSoundIndex;
+};
+
+#endif /* _BUNDLEWAVFILE_H_ */
@@ -24,16 +24,26 @@
 ChainedSDWavFile::ChainedSDWavFile(const char* aFilePath, const char* aNextFilePath)
 {
 	mFileIndex = 0;
+	mpEventSink = nullptr;
 
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	mpFiles[0] = new(maFileStorage[0]) SDWavFile(aFilePath);
+	mpFiles[1] = new(maFileStorage[1]) SDWavFile(aNextFilePath);
+#else
 	mpFiles[0] = new SDWavFile(aFilePath);
 	mpFiles[1] = new SDWavFile(aNextFilePath);
+#endif
 }
 
 ChainedSDWavFile::~ChainedSDWavFile()
 {
 	for(int lIdx = 0; lIdx < NUM_CHAINED_FILES; lIdx++)
 	{
+#ifdef NRF52AUDIO_STATIC_ALLOC
+		mpFiles[lIdx]->~SDWavFile();
+#else
 		delete mpFiles[lIdx];
+#endif
 	}
 }
 
@@ -63,6 +73,7 @@ void ChainedSDWavFile::Close()
 bool ChainedSDWavFile::SeekStartOfData()
 {
 	bool lSuccess = true;
+	mFileIndex = 0;
 	for(int lIdx = 0; lIdx < NUM_CHAINED_FILES; lIdx++)
 	{
 		lSuccess &= mpFiles[lIdx]->SeekStartOfData();
@@ -91,23 +102,22 @@ int ChainedSDWavFile::Fetch16BitSamples(int16_t* apBuffer, int aNumSamples)
 {
 	int lSamplesFetched = 0;
 
-	static int lWrap = 0;
-
-	if(false == mpFiles[0]->IsEnded())
+	if(0 == mFileIndex)
 	{
 		lSamplesFetched = mpFiles[0]->Fetch16BitSamples(apBuffer, aNumSamples);
+
+		if(mpFiles[0]->IsEnded())
+		{
+			mFileIndex = 1;
+		}
 	}
 
 	if(lSamplesFetched < aNumSamples)
 	{
 		int lNumSamplesToFetch =  aNumSamples-lSamplesFetched;
-		int lBufPos = 0;
-		if(lSamplesFetched > 0)
-		{
-			lBufPos = lSamplesFetched-1;
-		}
 
-		lSamplesFetched += mpFiles[1]->Fetch16BitSamples(&(apBuffer[lBufPos]), lNumSamplesToFetch);
+		//The next file picks up right after the last sample of the first one
+		lSamplesFetched += mpFiles[1]->Fetch16BitSamples(&(apBuffer[lSamplesFetched]), lNumSamplesToFetch);
 	}
 
 	return lSamplesFetched;
@@ -172,6 +182,56 @@ void ChainedSDWavFile::SetDePop(bool aStart, bool aEnd)
 
 void ChainedSDWavFile::Skip16BitSamples(int aNumSamples)
 {
-	mpFiles[mFileIndex]->Skip16BitSamples(aNumSamples);
+	if(0 == mFileIndex)
+	{
+		//Samples left in the first file, the rest of the skip carries on into the next one
+		int lBytesPerSample = (8 == mpFiles[0]->GetHeader().bitsPerSample) ? 1 : 2;
+		int lNumLeft = mpFiles[0]->Available() / lBytesPerSample;
+
+		if(aNumSamples < lNumLeft)
+		{
+			mpFiles[0]->Skip16BitSamples(aNumSamples);
+			return;
+		}
+
+		mpFiles[0]->Skip16BitSamples(lNumLeft);
+		aNumSamples -= lNumLeft;
+		mFileIndex = 1;
+	}
+
+	mpFiles[1]->Skip16BitSamples(aNumSamples);
 }
 
+void ChainedSDWavFile::SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond)
+{
+	for(int lIdx = 0; lIdx < NUM_CHAINED_FILES; lIdx++)
+	{
+		mpFiles[lIdx]->SetIOScheduler(apScheduler, aBytesPerSecond);
+	}
+}
+
+void ChainedSDWavFile::SetEventSink(IWavFileEventSink* apSink)
+{
+	mpEventSink = apSink;
+
+	for(int lIdx = 0; lIdx < NUM_CHAINED_FILES; lIdx++)
+	{
+		mpFiles[lIdx]->SetEventSink(nullptr != apSink ? this : nullptr);
+	}
+}
+
+void ChainedSDWavFile::OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition)
+{
+	if(nullptr == mpEventSink)
+	{
+		return;
+	}
+
+	//Only the last file in the chain really ends
+	if(eeWavFileEnded == aEvent && apSource != mpFiles[NUM_CHAINED_FILES-1])
+	{
+		aEvent = eeWavFileSegmentChanged;
+	}
+
+	mpEventSink->OnWavFileEvent(this, aEvent, aSamplePosition);
+}
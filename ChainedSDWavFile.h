@@ -32,9 +32,10 @@
  * The first file is played until it ends, then the second file starts
  * right after the first is done. The second file can be optionally looped by
  * calling the SetLooping() method.
+ * When the first file is done an eeWavFileSegmentChanged event is reported.
  * NOTE: It is not recommend to mix files with different sample rates in a chain.
  */
-class ChainedSDWavFile : public ISDWavFile
+class ChainedSDWavFile : public ISDWavFile, protected IWavFileEventSink
 {
 public:
 
@@ -157,16 +158,50 @@ public:
 	virtual void SetDePop(bool aStart, bool aEnd);
 
 	/**
-	 * Skips samples. All read pointers are advanced.
+	 * Skips samples in the file that is playing. A skip past the end of the
+	 * first file carries on into the next one.
 	 * Args:
 	 *  aNumSamples - Number of 16-bit samples to skip.
 	 */
 	virtual void Skip16BitSamples(int aNumSamples);
 
+	/**
+	 * Register both files' read buffers with an I/O scheduler. The second file
+	 * is read ahead too, so the transition doesn't have to wait on the SD card.
+	 * Args:
+	 *   apScheduler - Scheduler to register with, or nullptr to unregister
+	 *   aBytesPerSecond - How fast data will be consumed during playback
+	 */
+	virtual void SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond);
+
+	/**
+	 * Set where the chain reports events. The end of the first file is
+	 * reported as a segment change, the second file's loop wraps and end
+	 * are reported as they are.
+	 * Args:
+	 *   apSink - Receiver of the events, or nullptr to stop reporting
+	 */
+	virtual void SetEventSink(IWavFileEventSink* apSink);
+
 protected:
 
+	/**
+	 * Receives events from the files in the chain.
+	 */
+	virtual void OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition);
+
 	SDWavFile* mpFiles[NUM_CHAINED_FILES];
+
+	//File playing now, moves to the next one when the first file ends
 	int mFileIndex;
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	//Storage the files are built in
+	alignas(SDWavFile) uint8_t maFileStorage[NUM_CHAINED_FILES][sizeof(SDWavFile)];
+#endif
+
+	//Receiver of playback events (nullptr if none)
+	IWavFileEventSink* mpEventSink;
 };
 
 
@@ -0,0 +1,291 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * EffectChainWavFile.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include <Arduino.h>
+#include "EffectChainWavFile.h"
+
+EffectChainWavFile::EffectChainWavFile(ISDWavFile* apSource)
+{
+	mpSource = apSource;
+	mNumEffects = 0;
+	mBlockPos = 0;
+	mBlockCount = 0;
+	mpEventSink = nullptr;
+	mQuality = eeQualityFull;
+
+	for(int lIdx = 0; lIdx < EFFECT_CHAIN_MAX_EFFECTS; lIdx++)
+	{
+		mapEffects[lIdx] = nullptr;
+		maIsOptional[lIdx] = false;
+	}
+}
+
+EffectChainWavFile::~EffectChainWavFile()
+{
+	//Nothing to do, the source and effects belong to the caller
+}
+
+bool EffectChainWavFile::AddEffect(IAudioEffect* apEffect, bool aIsOptional)
+{
+	if(nullptr == apEffect || mNumEffects >= EFFECT_CHAIN_MAX_EFFECTS)
+	{
+		return false;
+	}
+
+	maIsOptional[mNumEffects] = aIsOptional;
+	mapEffects[mNumEffects++] = apEffect;
+	return true;
+}
+
+void EffectChainWavFile::ClearEffects()
+{
+	for(int lIdx = 0; lIdx < EFFECT_CHAIN_MAX_EFFECTS; lIdx++)
+	{
+		mapEffects[lIdx] = nullptr;
+		maIsOptional[lIdx] = false;
+	}
+	mNumEffects = 0;
+}
+
+void EffectChainWavFile::Close()
+{
+	mpSource->Close();
+	mBlockPos = 0;
+	mBlockCount = 0;
+}
+
+File& EffectChainWavFile::GetFileHandle()
+{
+	return mpSource->GetFileHandle();
+}
+
+const tWavFileHeader& EffectChainWavFile::GetHeader()
+{
+	return mpSource->GetHeader();
+}
+
+const tWavDataHeader& EffectChainWavFile::GetDataHeader()
+{
+	return mpSource->GetDataHeader();
+}
+
+bool EffectChainWavFile::SeekStartOfData()
+{
+	ResetEffects();
+
+	return mpSource->SeekStartOfData();
+}
+
+bool EffectChainWavFile::SeekToSample(unsigned long aSample)
+{
+	ResetEffects();
+
+	return mpSource->SeekToSample(aSample);
+}
+
+int EffectChainWavFile::Available()
+{
+	return mpSource->Available() + (mBlockCount - mBlockPos) * sizeof(int16_t);
+}
+
+int EffectChainWavFile::Fetch16BitSamples(int16_t* apBuffer, int aNumSamples)
+{
+	int lSampleIndex = 0;
+
+	while(lSampleIndex < aNumSamples)
+	{
+		if(mBlockPos >= mBlockCount && 0 == ProcessNextBlock())
+		{
+			break; //Source is out of data
+		}
+
+		int lNumToCopy = mBlockCount - mBlockPos;
+		if(lNumToCopy > aNumSamples - lSampleIndex)
+		{
+			lNumToCopy = aNumSamples - lSampleIndex;
+		}
+
+		memcpy(&apBuffer[lSampleIndex], &maBlock[mBlockPos], lNumToCopy * sizeof(int16_t));
+		mBlockPos += lNumToCopy;
+		lSampleIndex += lNumToCopy;
+	}
+
+	return lSampleIndex;
+}
+
+int EffectChainWavFile::Render(int16_t* apBuffer, int aNumFrames, int aNumChannels, bool* apEnded)
+{
+	if(1 != aNumChannels)
+	{
+		return ISDWavFile::Render(apBuffer, aNumFrames, aNumChannels, apEnded);
+	}
+
+	//Hand out samples that were already processed first
+	int lNumFrames = mBlockCount - mBlockPos;
+	if(lNumFrames > aNumFrames)
+	{
+		lNumFrames = aNumFrames;
+	}
+	memcpy(apBuffer, &maBlock[mBlockPos], lNumFrames * sizeof(int16_t));
+	mBlockPos += lNumFrames;
+
+	//Then render and process the rest in place
+	int lNumRendered = mpSource->Render(&apBuffer[lNumFrames], aNumFrames - lNumFrames, 1, apEnded);
+	ProcessEffects(&apBuffer[lNumFrames], lNumRendered);
+
+	return lNumFrames + lNumRendered;
+}
+
+tAudioFormat EffectChainWavFile::GetFormat()
+{
+	tAudioFormat lFormat = mpSource->GetFormat();
+	lFormat.mCapabilities |= eeCapNativeRender;
+
+	return lFormat;
+}
+
+void EffectChainWavFile::SetVolume(float aVolume)
+{
+	mpSource->SetVolume(aVolume);
+}
+
+void EffectChainWavFile::SetLooping(bool aLoopingEnable)
+{
+	mpSource->SetLooping(aLoopingEnable);
+}
+
+void EffectChainWavFile::Pause()
+{
+	mpSource->Pause();
+}
+
+bool EffectChainWavFile::IsPaused()
+{
+	return mpSource->IsPaused();
+}
+
+void EffectChainWavFile::UnPause()
+{
+	mpSource->UnPause();
+}
+
+bool EffectChainWavFile::IsEnded()
+{
+	return mBlockPos >= mBlockCount && mpSource->IsEnded();
+}
+
+void EffectChainWavFile::SetDePop(bool aStart, bool aEnd)
+{
+	mpSource->SetDePop(aStart, aEnd);
+}
+
+void EffectChainWavFile::Skip16BitSamples(int aNumSamples)
+{
+	int lNumBuffered = mBlockCount - mBlockPos;
+
+	if(aNumSamples <= lNumBuffered)
+	{
+		mBlockPos += aNumSamples;
+	}
+	else
+	{
+		//The effects never see the skipped samples, so their history no
+		//longer matches where the source picks up
+		ResetEffects();
+		mpSource->Skip16BitSamples(aNumSamples - lNumBuffered);
+	}
+}
+
+void EffectChainWavFile::ResetEffects()
+{
+	mBlockPos = 0;
+	mBlockCount = 0;
+
+	for(int lIdx = 0; lIdx < mNumEffects; lIdx++)
+	{
+		mapEffects[lIdx]->Reset();
+	}
+}
+
+void EffectChainWavFile::SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond)
+{
+	mpSource->SetIOScheduler(apScheduler, aBytesPerSecond);
+}
+
+float EffectChainWavFile::GetPlaybackSpeed()
+{
+	return mpSource->GetPlaybackSpeed();
+}
+
+void EffectChainWavFile::SetEventSink(IWavFileEventSink* apSink)
+{
+	mpEventSink = apSink;
+	mpSource->SetEventSink(nullptr != apSink ? this : nullptr);
+}
+
+void EffectChainWavFile::SetQuality(EQualityLevel aLevel)
+{
+	//Optional effects skipped so far pick up from a clean state
+	if(eeQualityFull == aLevel && eeQualityFull != mQuality)
+	{
+		for(int lIdx = 0; lIdx < mNumEffects; lIdx++)
+		{
+			if(maIsOptional[lIdx])
+			{
+				mapEffects[lIdx]->Reset();
+			}
+		}
+	}
+
+	mQuality = aLevel;
+	mpSource->SetQuality(aLevel);
+}
+
+void EffectChainWavFile::OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition)
+{
+	if(nullptr != mpEventSink)
+	{
+		mpEventSink->OnWavFileEvent(this, aEvent, aSamplePosition);
+	}
+}
+
+int EffectChainWavFile::ProcessNextBlock()
+{
+	mBlockPos = 0;
+	mBlockCount = mpSource->Fetch16BitSamples(maBlock, EFFECT_CHAIN_BLOCK_SIZE);
+	ProcessEffects(maBlock, mBlockCount);
+
+	return mBlockCount;
+}
+
+void EffectChainWavFile::ProcessEffects(int16_t* apBuffer, int aNumSamples)
+{
+	for(int lIdx = 0; lIdx < mNumEffects; lIdx++)
+	{
+		if(maIsOptional[lIdx] && eeQualityFull != mQuality)
+		{
+			continue;
+		}
+
+		mapEffects[lIdx]->Process(apBuffer, aNumSamples);
+	}
+}
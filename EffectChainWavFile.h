@@ -0,0 +1,259 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * EffectChainWavFile.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _EFFECTCHAINWAVFILE_H_
+#define _EFFECTCHAINWAVFILE_H_
+
+#include "ISDWavFile.h"
+#include "IAudioEffect.h"
+
+//Maximum number of effects in one chain
+#define EFFECT_CHAIN_MAX_EFFECTS 4
+
+//Number of samples pulled from the source and processed at a time
+#define EFFECT_CHAIN_BLOCK_SIZE 32
+
+/**
+ * Runs the samples of any ISDWavFile through a chain of effects before they
+ * reach the mixer. Wrap a file in one of these and give it to the player
+ * instead of the file:
+ *
+ *   EffectChainWavFile* lpHum = new EffectChainWavFile(new SDWavFile("hum.wav"));
+ *   lpHum->AddEffect(&lLowPass);
+ *   lpPlayer->SetWavFile(lpHum, 0);
+ *
+ * The mixer renders mono chunks, which are processed in place in the mixer's
+ * buffer. Samples fetched through Fetch16BitSamples() are processed
+ * EFFECT_CHAIN_BLOCK_SIZE at a time in the chain's own block, however few are
+ * asked for. The source file and the effects are not owned by the chain.
+ */
+class EffectChainWavFile : public ISDWavFile, protected IWavFileEventSink
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apSource - File to process
+	 */
+	EffectChainWavFile(ISDWavFile* apSource);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~EffectChainWavFile();
+
+	/**
+	 * Add an effect to the end of the chain.
+	 * Args:
+	 *  apEffect - Effect to add
+	 *  aIsOptional - TRUE if the effect can be skipped when the player is short
+	 *                on time (see SetQuality())
+	 * Returns: TRUE if added, FALSE if the chain is full
+	 */
+	bool AddEffect(IAudioEffect* apEffect, bool aIsOptional = false);
+
+	/**
+	 * Remove all effects from the chain.
+	 */
+	void ClearEffects();
+
+	/**
+	 * Fetch the file being processed.
+	 */
+	inline ISDWavFile* GetSource()
+	{
+		return mpSource;
+	}
+
+	/**
+	 * Close the source file.
+	 */
+	virtual void Close();
+
+	/**
+	 * Fetch the source's file handle.
+	 */
+	virtual File& GetFileHandle();
+
+	/**
+	 * Fetch the source's file header.
+	 */
+	virtual const tWavFileHeader& GetHeader();
+
+	/**
+	 * Fetch the source's data block header.
+	 */
+	virtual const tWavDataHeader& GetDataHeader();
+
+	/**
+	 * Restart the source and clear the effects' state.
+	 */
+	virtual bool SeekStartOfData();
+
+	/**
+	 * Fetch how many bytes are left, including samples already processed.
+	 */
+	virtual int Available();
+
+	/**
+	 * Fetch processed samples.
+	 * Args:
+	 *   apBuffer - Pointer to buffer to fill with data
+	 *   aNumSamples - How many samples to read
+	 * Returns: Number of samples filled
+	 */
+	virtual int Fetch16BitSamples(int16_t* apBuffer, int aNumSamples);
+
+	/**
+	 * Render processed samples. Mono blocks are pulled from the source and
+	 * processed straight in the caller's buffer, without going through
+	 * the chain's own block buffer.
+	 */
+	virtual int Render(int16_t* apBuffer, int aNumFrames, int aNumChannels = 1, bool* apEnded = nullptr);
+
+	/**
+	 * Fetch the source's format. Rendering is done natively.
+	 */
+	virtual tAudioFormat GetFormat();
+
+	/**
+	 * Set the source's volume.
+	 */
+	virtual void SetVolume(float aVolume);
+
+	/**
+	 * Enable/Disable looping of the source.
+	 */
+	virtual void SetLooping(bool aLoopingEnable);
+
+	/**
+	 * Pause the source.
+	 */
+	virtual void Pause();
+
+	/**
+	 * Check if the source is paused.
+	 */
+	virtual bool IsPaused();
+
+	/**
+	 * Unpause the source.
+	 */
+	virtual void UnPause();
+
+	/**
+	 * Check if the source has run out of data and all processed samples were fetched.
+	 */
+	virtual bool IsEnded();
+
+	/**
+	 * Enable/Disable the source's De-pop algorithm.
+	 */
+	virtual void SetDePop(bool aStart, bool aEnd);
+
+	/**
+	 * Skip samples, starting with samples already processed.
+	 * Args:
+	 *  aNumSamples - Number of 16-bit samples to skip.
+	 */
+	virtual void Skip16BitSamples(int aNumSamples);
+
+	/**
+	 * Move the source to any sample and clear the effects' state.
+	 */
+	virtual bool SeekToSample(unsigned long aSample);
+
+	/**
+	 * Register the source with an I/O scheduler.
+	 */
+	virtual void SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond);
+
+	/**
+	 * Fetch how fast the source moves through its data.
+	 */
+	virtual float GetPlaybackSpeed();
+
+	/**
+	 * Pass on the source's events as this file's events. Events are reported
+	 * when the source is read, which can be up to EFFECT_CHAIN_BLOCK_SIZE
+	 * samples before the processed samples are fetched.
+	 */
+	virtual void SetEventSink(IWavFileEventSink* apSink);
+
+	/**
+	 * Skip optional effects below eeQualityFull. They are reset when full
+	 * quality comes back, so they don't start from stale history.
+	 * Args:
+	 *   aLevel - Quality level the player is mixing at
+	 */
+	virtual void SetQuality(EQualityLevel aLevel);
+
+protected:
+
+	/**
+	 * Receives events from the source and reports them as coming from this file.
+	 */
+	virtual void OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition);
+
+	/**
+	 * Pull the next block from the source and run it through the effects.
+	 * Returns: Number of samples in the new block
+	 */
+	int ProcessNextBlock();
+
+	/**
+	 * Run samples through the effects that are switched on.
+	 * Args:
+	 *  apBuffer - Samples to process in place
+	 *  aNumSamples - Number of samples in the buffer
+	 */
+	void ProcessEffects(int16_t* apBuffer, int aNumSamples);
+
+	/**
+	 * Drop the block and clear the effects' history, for when the source
+	 * jumps to another place in the sound.
+	 */
+	void ResetEffects();
+
+	//File being processed
+	ISDWavFile* mpSource;
+
+	//Effects, applied in order
+	IAudioEffect* mapEffects[EFFECT_CHAIN_MAX_EFFECTS];
+	int mNumEffects;
+
+	//TRUE for effects that are skipped below eeQualityFull
+	bool maIsOptional[EFFECT_CHAIN_MAX_EFFECTS];
+
+	//Quality level the player is mixing at
+	EQualityLevel mQuality;
+
+	//Processed samples waiting to be fetched
+	int16_t maBlock[EFFECT_CHAIN_BLOCK_SIZE];
+	int mBlockPos;
+	int mBlockCount;
+
+	//Receiver of playback events (nullptr if none)
+	IWavFileEventSink* mpEventSink;
+};
+
+#endif /* _EFFECTCHAINWAVFILE_H_ */
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FontBundle.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "FontBundle.h"
+
+#define FONT_BUNDLE_VERSION 1
+
+FontBundle::FontBundle(const char* apFilePath)
+{
+	mNumSounds = 0;
+	mIsValid = false;
+
+	mFileHandle = SD.open(apFilePath, FILE_READ);
+
+	if(mFileHandle)
+	{
+		ReadIndex();
+	}
+}
+
+FontBundle::~FontBundle()
+{
+	Close();
+}
+
+void FontBundle::Close()
+{
+	mFileHandle.close();
+	mIsValid = false;
+}
+
+int FontBundle::FindSound(const char* apName)
+{
+	for(int lIdx = 0; lIdx < mNumSounds; lIdx++)
+	{
+		if(0 == strncmp(maEntries[lIdx].mName, apName, FONT_BUNDLE_NAME_SIZE))
+		{
+			return lIdx;
+		}
+	}
+
+	return -1;
+}
+
+void FontBundle::ReadIndex()
+{
+	tFontBundleHeader lHeader;
+
+	mFileHandle.seek(0);
+	if(sizeof(tFontBundleHeader) != mFileHandle.read(&lHeader, sizeof(tFontBundleHeader))
+		|| 0 != memcmp(lHeader.mMagic, "NFNT", 4)
+		|| FONT_BUNDLE_VERSION != lHeader.mVersion
+		|| lHeader.mNumSounds > FONT_BUNDLE_MAX_SOUNDS)
+	{
+		return;
+	}
+
+	//Read the whole index in one go
+	int lIndexSize = sizeof(tFontBundleEntry) * lHeader.mNumSounds;
+	if(lIndexSize != mFileHandle.read(maEntries, lIndexSize))
+	{
+		return;
+	}
+
+	mNumSounds = lHeader.mNumSounds;
+	mIsValid = true;
+}
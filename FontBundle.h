@@ -0,0 +1,146 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * FontBundle.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _FONTBUNDLE_H_
+#define _FONTBUNDLE_H_
+
+#include <Arduino.h>
+#include <SD.h>
+
+//Maximum number of sounds in one font bundle
+#define FONT_BUNDLE_MAX_SOUNDS 64
+
+//Maximum length of a sound name stored in a bundle (including terminator)
+#define FONT_BUNDLE_NAME_SIZE 24
+
+//Header at the start of a font bundle file (see extras/pack_font_bundle.py)
+struct tFontBundleHeader
+{
+	char mMagic[4];        //"NFNT"
+	uint32_t mVersion;     //Format version, currently 1
+	uint32_t mNumSounds;   //Number of tFontBundleEntry records that follow
+};
+
+//Index entry for one sound in a font bundle
+struct tFontBundleEntry
+{
+	char mName[FONT_BUNDLE_NAME_SIZE]; //Null terminated sound name
+	uint32_t mOffset;         //Byte offset of the sound's wav header from the start of the bundle
+	uint32_t mSize;           //Size of the sound in bytes (44 byte wav header plus data)
+	uint32_t mSampleRate;     //Sample rate in Hz
+	uint16_t mNumChannels;    //Number of channels
+	uint16_t mBitsPerSample;  //Bits per sample
+	uint32_t mLoopStart;      //First sample of the loop
+	uint32_t mLoopEnd;        //Sample just past the end of the loop
+};
+
+/**
+ * This class represents a sound font bundle: a single file on the SD card
+ * that holds every sound in a font, preceded by an index. The bundle is opened
+ * once and the index is read into memory, so switching fonts costs one file
+ * open instead of one per sound. Sounds are played with BundleWavFile objects,
+ * which all share this object's file handle.
+ */
+class FontBundle
+{
+public:
+	/**
+	 * Constructor. Opens the bundle and reads its index.
+	 * Args:
+	 *  apFilePath - Name of the bundle file to open
+	 */
+	FontBundle(const char* apFilePath);
+
+	/**
+	 * Destructor.
+	 */
+	~FontBundle();
+
+	/**
+	 * Close the bundle file. All BundleWavFile objects created from
+	 * this bundle become unusable.
+	 */
+	void Close();
+
+	/**
+	 * Check if the bundle was opened and its index is valid.
+	 * Returns: TRUE if valid, FALSE otherwise
+	 */
+	inline bool IsValid()
+	{
+		return mIsValid;
+	}
+
+	/**
+	 * Fetch the number of sounds in the bundle.
+	 */
+	inline int GetNumSounds()
+	{
+		return mNumSounds;
+	}
+
+	/**
+	 * Fetch the index entry for a sound.
+	 * Args:
+	 *  aIndex - Index of the sound, between 0 and GetNumSounds()-1
+	 */
+	inline const tFontBundleEntry& GetEntry(int aIndex)
+	{
+		return maEntries[aIndex];
+	}
+
+	/**
+	 * Look up a sound by name.
+	 * Args:
+	 *  apName - Name of the sound, as stored in the bundle
+	 * Returns: Index of the sound or -1 if it was not found
+	 */
+	int FindSound(const char* apName);
+
+	/**
+	 * Fetch the file handle shared by all sounds in the bundle.
+	 */
+	inline File& GetFileHandle()
+	{
+		return mFileHandle;
+	}
+
+protected:
+
+	/**
+	 * Read and check the bundle header and index.
+	 */
+	void ReadIndex();
+
+	//File handle shared by all sounds
+	File mFileHandle;
+
+	//Index entries
+	tFontBundleEntry maEntries[FONT_BUNDLE_MAX_SOUNDS];
+
+	//Number of valid index entries
+	int mNumSounds;
+
+	//Valid flag
+	bool mIsValid;
+};
+
+#endif /* _FONTBUNDLE_H_ */
@@ -0,0 +1,80 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * G711.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _G711_H_
+#define _G711_H_
+
+#include <stdint.h>
+
+//Wav file audio format codes
+#define WAVE_FORMAT_PCM   1
+#define WAVE_FORMAT_ALAW  6
+#define WAVE_FORMAT_MULAW 7
+
+/*
+ * G.711 companded audio stores each sample in 8 bits, half the size of 16-bit
+ * PCM, so it takes half the SD card bandwidth and space. Decoding is a handful
+ * of shifts and adds per sample with no state at all. Files can be converted
+ * with extras/encode_g711.py, which writes a canonical 44 byte header:
+ *   encode_g711.py in.wav out.wav
+ * Files from other converters (e.g. sox in.wav -e u-law out.wav) play too,
+ * SDWavFile skips the extended fmt and "fact" chunks they add.
+ */
+
+/**
+ * Decode a G.711 mu-law byte to a 16-bit sample.
+ * Args:
+ *  aByte - Encoded sample
+ * Returns: Decoded 16-bit sample
+ */
+inline int16_t G711DecodeMuLaw(uint8_t aByte)
+{
+	aByte = ~aByte;
+	int16_t lMagnitude = ((((aByte & 0x0F) << 3) + 0x84) << ((aByte & 0x70) >> 4)) - 0x84;
+
+	return (aByte & 0x80) ? -lMagnitude : lMagnitude;
+}
+
+/**
+ * Decode a G.711 A-law byte to a 16-bit sample.
+ * Args:
+ *  aByte - Encoded sample
+ * Returns: Decoded 16-bit sample
+ */
+inline int16_t G711DecodeALaw(uint8_t aByte)
+{
+	aByte ^= 0x55;
+	int16_t lMagnitude = (aByte & 0x0F) << 4;
+	int lSegment = (aByte & 0x70) >> 4;
+
+	if(0 == lSegment)
+	{
+		lMagnitude += 8;
+	}
+	else
+	{
+		lMagnitude = (lMagnitude + 0x108) << (lSegment - 1);
+	}
+
+	return (aByte & 0x80) ? lMagnitude : -lMagnitude;
+}
+
+#endif /* _G711_H_ */
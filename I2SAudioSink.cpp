@@ -0,0 +1,217 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * I2SAudioSink.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "I2SAudioSink.h"
+
+I2SAudioSink::I2SAudioSink(int32_t aPinMCK,
+						   int32_t aPinBCLK,
+						   int32_t aPinLRCK,
+						   int32_t aPinDIN,
+						   int32_t aPinSD)
+{
+	mPinMCK = aPinMCK;
+	mPinBCLK = aPinBCLK;
+	mPinLRCK = aPinLRCK;
+	mPinDIN = aPinDIN;
+	mPinSD = aPinSD;
+
+	memset(maBuffers, 0, sizeof(maBuffers));
+	mFreeMask = 0x03;
+	mPointerIndex = -1;
+	mQueuedIndex = -1;
+	mIsRunning = false;
+}
+
+I2SAudioSink::~I2SAudioSink()
+{
+	//Nothing to do
+}
+
+bool I2SAudioSink::Begin()
+{
+	// register structure hierarchy for I2S
+	// NRF_I2S is of type NRF_I2S_Type defined in nrf52.h
+	// CONFIG is of type I2S_CONFIG_Type defined in nrf52.h, sub-struct of NRF_I2S_Type
+	// Struct -> Element (kinda Struct.Element)
+
+	// Position variables (_Pos) are defined in nrf52_bitfields.h
+
+	// Enable Tx transmission
+	NRF_I2S->CONFIG.TXEN = (I2S_CONFIG_TXEN_TXEN_ENABLE << I2S_CONFIG_TXEN_TXEN_Pos);
+
+	// Enable MCK generator
+	NRF_I2S->CONFIG.MCKEN = (I2S_CONFIG_MCKEN_MCKEN_ENABLE << I2S_CONFIG_MCKEN_MCKEN_Pos);
+
+	SetSampleRate(ee2205); //Default I2S speed
+
+	// 16/24/32-bit  resolution, the MAX98357A supports I2S timing only!
+	// Master mode, 16Bit, left aligned
+	NRF_I2S->CONFIG.MODE = I2S_CONFIG_MODE_MODE_MASTER << I2S_CONFIG_MODE_MODE_Pos;
+
+	// look for /* Register: I2S_CONFIG_SWIDTH */ in nrf52_bitfields.h
+	// 16 bit
+	NRF_I2S->CONFIG.SWIDTH = I2S_CONFIG_SWIDTH_SWIDTH_16BIT << I2S_CONFIG_SWIDTH_SWIDTH_Pos;
+
+	// Left-aligned (not to be mixed up with left-justified)
+	NRF_I2S->CONFIG.ALIGN = I2S_CONFIG_ALIGN_ALIGN_Left << I2S_CONFIG_ALIGN_ALIGN_Pos;
+
+	// Format I2S (i.e. not left justified)
+	NRF_I2S->CONFIG.FORMAT = I2S_CONFIG_FORMAT_FORMAT_I2S << I2S_CONFIG_FORMAT_FORMAT_Pos;
+
+	// Use stereo
+	NRF_I2S->CONFIG.CHANNELS = I2S_CONFIG_CHANNELS_CHANNELS_Stereo << I2S_CONFIG_CHANNELS_CHANNELS_Pos;
+
+	// configure the pins
+	NRF_I2S->PSEL.MCK = (mPinMCK << I2S_PSEL_MCK_PIN_Pos);
+	NRF_I2S->PSEL.SCK = (mPinBCLK << I2S_PSEL_SCK_PIN_Pos);
+	NRF_I2S->PSEL.LRCK = (mPinLRCK << I2S_PSEL_LRCK_PIN_Pos);
+	NRF_I2S->PSEL.SDOUT = (mPinDIN << I2S_PSEL_SDOUT_PIN_Pos);
+
+	// Enable the I2S module using the ENABLE register
+	NRF_I2S->ENABLE = 1;
+
+	pinMode (mPinSD, OUTPUT);
+	digitalWrite (mPinSD, HIGH);
+
+	return true;
+}
+
+void I2SAudioSink::SetSampleRate(ESampleRate aSampleRate)
+{
+	// set the sample rate to a value supported by the audio amp
+	// LRCLK  ONLY  supports  8kHz,  16kHz,  32kHz,  44.1kHz,  48kHz, 88.2kHz, and 96kHz frequencies.
+	// LRCLK clocks at  11.025kHz,  12kHz,  22.05kHz  and  24kHz  are  NOT supported.
+	switch (aSampleRate)
+	{
+	case ee2205: //LRCLK at 44.1kHz (for playback speed of 22.05kHz)
+		NRF_I2S->CONFIG.MCKFREQ =  I2S_CONFIG_MCKFREQ_MCKFREQ_32MDIV11 << I2S_CONFIG_MCKFREQ_MCKFREQ_Pos;
+		NRF_I2S->CONFIG.RATIO = I2S_CONFIG_RATIO_RATIO_128X << I2S_CONFIG_RATIO_RATIO_Pos;
+		break;
+	case ee4410: //LRCLK at 88.1kHz (for playback speed of 44.1kHz)
+		NRF_I2S->CONFIG.MCKFREQ =  I2S_CONFIG_MCKFREQ_MCKFREQ_32MDIV11 << I2S_CONFIG_MCKFREQ_MCKFREQ_Pos;
+		NRF_I2S->CONFIG.RATIO = I2S_CONFIG_RATIO_RATIO_64X << I2S_CONFIG_RATIO_RATIO_Pos;
+		break;
+	case ee1600: //1.032MHz / 64 = 16.13kHz
+		NRF_I2S->CONFIG.MCKFREQ =  I2S_CONFIG_MCKFREQ_MCKFREQ_32MDIV31 << I2S_CONFIG_MCKFREQ_MCKFREQ_Pos;
+		NRF_I2S->CONFIG.RATIO = I2S_CONFIG_RATIO_RATIO_64X << I2S_CONFIG_RATIO_RATIO_Pos;
+		break;
+	case ee3200: //1.032MHz / 32 = 32.26kHz
+		NRF_I2S->CONFIG.MCKFREQ =  I2S_CONFIG_MCKFREQ_MCKFREQ_32MDIV31 << I2S_CONFIG_MCKFREQ_MCKFREQ_Pos;
+		NRF_I2S->CONFIG.RATIO = I2S_CONFIG_RATIO_RATIO_32X << I2S_CONFIG_RATIO_RATIO_Pos;
+		break;
+	case ee4800: //1.524MHz / 32 = 47.62kHz
+		NRF_I2S->CONFIG.MCKFREQ =  I2S_CONFIG_MCKFREQ_MCKFREQ_32MDIV21 << I2S_CONFIG_MCKFREQ_MCKFREQ_Pos;
+		NRF_I2S->CONFIG.RATIO = I2S_CONFIG_RATIO_RATIO_32X << I2S_CONFIG_RATIO_RATIO_Pos;
+		break;
+	default:
+		SetSampleRate(ee2205);
+		break;
+	}
+}
+
+void I2SAudioSink::Start()
+{
+	//Play the first buffer filled, the second one follows it
+	if(mPointerIndex < 0)
+	{
+		mPointerIndex = 0;
+	}
+
+	NRF_I2S->RXTXD.MAXCNT = I2S_BUF_SIZE;
+	NRF_I2S->TXD.PTR = (uint32_t)maBuffers[mPointerIndex];
+	NRF_I2S->EVENTS_TXPTRUPD = 0;
+	mIsRunning = true;
+
+	// restart the MCK generator (a TASKS_STOP will disable the MCK generator)
+	// Start transmitting I2S data
+	NRF_I2S->TASKS_START = 1;
+}
+
+void I2SAudioSink::Stop()
+{
+	// Stop transmitting I2S data, a TASKS_STOP will disable the MCK generator
+	NRF_I2S->TASKS_STOP = 1;
+
+	mIsRunning = false;
+	mFreeMask = 0x03;
+	mPointerIndex = -1;
+	mQueuedIndex = -1;
+}
+
+int32_t* I2SAudioSink::GetFreeBuffer()
+{
+	if(mIsRunning && NRF_I2S->EVENTS_TXPTRUPD != 0) //The hardware picked up TXD.PTR
+	{
+		NRF_I2S->EVENTS_TXPTRUPD = 0;
+
+		//The buffer in TXD.PTR is playing now, so the other one is done
+		int lOtherIndex = 1 - mPointerIndex;
+		if(lOtherIndex == mQueuedIndex)
+		{
+			//Filled before playback started, it goes next
+			NRF_I2S->TXD.PTR = (uint32_t)maBuffers[lOtherIndex];
+			mPointerIndex = lOtherIndex;
+			mQueuedIndex = -1;
+		}
+		else
+		{
+			mFreeMask |= 1 << lOtherIndex;
+		}
+	}
+
+	if(mFreeMask & 0x01)
+	{
+		return maBuffers[0];
+	}
+	else if(mFreeMask & 0x02)
+	{
+		return maBuffers[1];
+	}
+
+	return nullptr;
+}
+
+void I2SAudioSink::SubmitBuffer(int32_t* apBuffer)
+{
+	int lIndex = GetBufferIndex(apBuffer);
+	mFreeMask &= ~(1 << lIndex);
+
+	if(mIsRunning)
+	{
+		//Picked up when the buffer playing now ends
+		NRF_I2S->TXD.PTR = (uint32_t)apBuffer;
+		mPointerIndex = lIndex;
+	}
+	else if(mPointerIndex < 0)
+	{
+		mPointerIndex = lIndex;
+	}
+	else
+	{
+		mQueuedIndex = lIndex;
+	}
+}
+
+void I2SAudioSink::Silence()
+{
+	memset(maBuffers, 0, sizeof(maBuffers));
+}
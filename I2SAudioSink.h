@@ -0,0 +1,134 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * I2SAudioSink.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _I2SAUDIOSINK_H_
+#define _I2SAUDIOSINK_H_
+
+#include <Arduino.h>
+#include "IAudioSink.h"
+
+//Default Pins
+#define PIN_I2S_MCK_DEFAULT 13
+#define PIN_I2S_BCLK_DEFAULT (A2)
+#define PIN_I2S_LRCK_DEFAULT (A3)
+#define PIN_I2S_DIN_DEFAULT 18
+#define PIN_I2S_SD_DEFAULT  10
+
+/**
+ * Plays audio through the nRF52 I2S peripheral, for an I2S amp such as the
+ * MAX98357A. This is the player's default output.
+ *
+ * There are two buffers. While the hardware plays one, the other is filled
+ * and its address is loaded into TXD.PTR, which the hardware picks up when it
+ * reaches the end of the buffer it is playing (the TXPTRUPD event).
+ */
+class I2SAudioSink : public IAudioSink
+{
+public:
+	/**
+	 * Constructor.
+	 * Args:
+	 *   aPinMCK - Pin for master clock
+	 *   aPinBCLK - Pin for bit clock
+	 *   aPinLRCK - Pin for Left/Right clock
+	 *   aPinDIN - Pin for data out
+	 *   aPinSD - Pin for SD
+	 */
+	I2SAudioSink(int32_t aPinMCK = PIN_I2S_MCK_DEFAULT,
+				 int32_t aPinBCLK = PIN_I2S_BCLK_DEFAULT,
+				 int32_t aPinLRCK = PIN_I2S_LRCK_DEFAULT,
+				 int32_t aPinDIN = PIN_I2S_DIN_DEFAULT,
+				 int32_t aPinSD = PIN_I2S_SD_DEFAULT);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~I2SAudioSink();
+
+	/**
+	 * Sets up I2S playback parameters with the hardware.
+	 */
+	virtual bool Begin();
+
+	/**
+	 * Sets the I2S clock speed.
+	 */
+	virtual void SetSampleRate(ESampleRate aSampleRate);
+
+	/**
+	 * Start transmitting I2S data.
+	 */
+	virtual void Start();
+
+	/**
+	 * Stop transmitting I2S data. This also stops the master clock.
+	 */
+	virtual void Stop();
+
+	/**
+	 * Fetch the buffer the hardware has finished with, if there is one.
+	 */
+	virtual int32_t* GetFreeBuffer();
+
+	/**
+	 * Queue a filled buffer to play after the one playing now.
+	 */
+	virtual void SubmitBuffer(int32_t* apBuffer);
+
+	/**
+	 * Clear both buffers.
+	 */
+	virtual void Silence();
+
+protected:
+
+	/**
+	 * Fetch the index of one of the buffers from its address.
+	 */
+	inline int GetBufferIndex(int32_t* apBuffer)
+	{
+		return apBuffer == maBuffers[0] ? 0 : 1;
+	}
+
+	//Pins
+	int32_t mPinMCK;
+	int32_t mPinBCLK;
+	int32_t mPinLRCK;
+	int32_t mPinDIN;
+	int32_t mPinSD;
+
+	//I2S sample buffers
+	int32_t maBuffers[2][I2S_BUF_SIZE];
+
+	//Buffers that can be filled (bit per buffer)
+	uint8_t mFreeMask;
+
+	//Buffer whose address is in TXD.PTR (-1 if none)
+	int mPointerIndex;
+
+	//Buffer filled before Start() that still has to go into TXD.PTR (-1 if none)
+	int mQueuedIndex;
+
+	//TRUE while transmitting
+	bool mIsRunning;
+};
+
+#endif /* _I2SAUDIOSINK_H_ */
@@ -22,6 +22,7 @@
 
 #include "Arduino.h"
 #include "I2SWavPlayer.h"
+#include "PitchShiftSDWavFile.h"
 
 I2SWavPlayer::I2SWavPlayer(int32_t aPinMCK,
 	     	 	 	 	  int32_t aPinBCLK,
@@ -29,139 +30,405 @@ I2SWavPlayer::I2SWavPlayer(int32_t aPinMCK,
 						  int32_t aPinDIN,
 						  int32_t aPinSD)
 {
-	memset(maBufferA, 0, I2S_BUF_SIZE);
-	memset(maBufferB, 0, I2S_BUF_SIZE);
-	mBufferASelected = true;
-
 	mPinMCK = aPinMCK;
 	mPinBCLK = aPinBCLK;
 	mPinLRCK = aPinLRCK;
 	mPinDIN = aPinDIN;
 	mPinSD = aPinSD;
+	mpI2SSink = nullptr;
+	mpSink = nullptr;
 
 	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
 	{
 		mapWavFile[lIdx] = nullptr;
+		maIsOwned[lIdx] = false;
+		maVoicePriority[lIdx] = 0;
+		maBytesPerSecond[lIdx] = 0;
 	}
 
 	mSamplesMixed = 0;
+	mActiveVoiceMask = 0;
+	mPlayingVoiceMask = 0;
+	mVoiceCheckMask = 0;
+	mDroppedVoiceMask = 0;
+	mUnsupportedRateMask = 0;
+	mEndedSeenMask = 0;
+	mPendingEndedMask = 0;
 	mSampleRate = ee2205;
+	mIsRateChanged = false;
 	mVolume = 1.0;
-
+	mpIOScheduler = nullptr;
+	mServiceWhileMixing = true;
+	mNumEvents = 0;
+	mNumDroppedEvents = 0;
+	mpEventCallback = nullptr;
+	mpEventContext = nullptr;
+	mMixOffset = 0;
+	mNumScheduledStarts = 0;
+	mPlaybackClock = 0;
+	mBlockStartClock = 0;
+	mIsAdaptiveQuality = true;
+	mQualityLevel = eeQualityFull;
+	mNumQuietBlocks = 0;
+
+	ResetMixStats();
 }
 
 I2SWavPlayer::~I2SWavPlayer()
 {
 	StopPlayback();
 
+	//Files that belong to the caller are left as they are
 	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
 	{
-		if(nullptr != mapWavFile[lIdx])
+		ReleaseWavFile(lIdx);
+	}
+
+	//Files handed over in commands that were never applied belong to the player too
+	tPlayerCommand lCommand;
+	while(mCommandQueue.Pop(lCommand))
+	{
+		if(eeCmdSetWavFile == lCommand.mType && lCommand.mFlag && nullptr != lCommand.mpFile)
 		{
-			mapWavFile[lIdx]->Close();
+			WavFileHandle::Destroy(lCommand.mpFile);
 		}
 	}
+
+	if(nullptr != mpI2SSink)
+	{
+#ifdef NRF52AUDIO_STATIC_ALLOC
+		mpI2SSink->~I2SAudioSink();
+#else
+		delete mpI2SSink;
+#endif
+	}
 }
 
 bool I2SWavPlayer::Init()
 {
-	Configure_I2S();
-	return true;
+	bool lSuccess = GetSink()->Begin();
+	Configure_I2S_Speed(ee2205); //Default speed
+
+	return lSuccess;
+}
+
+void I2SWavPlayer::SetOutputSink(IAudioSink* apSink)
+{
+	//Going back to I2S creates the I2S output when it is next needed
+	mpSink = nullptr != apSink ? apSink : mpI2SSink;
+	if(nullptr != mpSink)
+	{
+		mpSink->SetSampleRate(mSampleRate);
+	}
+}
+
+IAudioSink* I2SWavPlayer::GetSink()
+{
+	if(nullptr == mpSink)
+	{
+		if(nullptr == mpI2SSink)
+		{
+#ifdef NRF52AUDIO_STATIC_ALLOC
+			mpI2SSink = new(maI2SSinkStorage) I2SAudioSink(mPinMCK, mPinBCLK, mPinLRCK, mPinDIN, mPinSD);
+#else
+			mpI2SSink = new I2SAudioSink(mPinMCK, mPinBCLK, mPinLRCK, mPinDIN, mPinSD);
+#endif
+		}
+
+		mpSink = mpI2SSink;
+		mpSink->SetSampleRate(mSampleRate);
+	}
+
+	return mpSink;
 }
 
-void I2SWavPlayer::SetWavFile(ISDWavFile* apWavFile, int aFileIndex)
+void I2SWavPlayer::SetWavFile(ISDWavFile* apWavFile, int aFileIndex, bool aIsOwned)
 {
 	if(aFileIndex < MAX_WAV_FILES && aFileIndex >= 0)
 	{
-		mapWavFile[aFileIndex] = apWavFile;
+		CancelScheduledStart(aFileIndex);
+
 		if(nullptr != apWavFile)
 		{
-			//Force down-sampling of 44.1KHz to 22.05 KHz
-			if(apWavFile->GetHeader().sampleRate == 44100 && mSampleRate == ee2205)
-			{
-				//Serial.println("Downsampling enabled.");
-				maDownsampleParams[aFileIndex].mIsDownsample = true;
-			}
-			else //Don't do down-sampling
-			{
-				//Serial.println("Downsampling disabled.");
-				maDownsampleParams[aFileIndex].mIsDownsample = false;
-			}
+			apWavFile->SeekStartOfData();
+		}
 
-			//Serial.print("SampleRate: ");
-			//Serial.println(apWavFile->GetHeader().sampleRate);
+		InstallWavFile(apWavFile, aFileIndex, aIsOwned);
+	}
+}
 
-			apWavFile->SeekStartOfData();
+bool I2SWavPlayer::SetWavFile(WavFileHandle&& arWavFile, int aFileIndex)
+{
+	if(aFileIndex >= MAX_WAV_FILES || aFileIndex < 0)
+	{
+		return false;
+	}
+
+	SetWavFile(arWavFile.Release(), aFileIndex, true);
+	return true;
+}
+
+void I2SWavPlayer::InstallWavFile(ISDWavFile* apWavFile, int aFileIndex, bool aIsOwned)
+{
+	if(apWavFile != mapWavFile[aFileIndex])
+	{
+		ReleaseWavFile(aFileIndex);
+	}
+	else
+	{
+		//Setting a file again can hand it over, but never takes it back
+		aIsOwned = aIsOwned || maIsOwned[aFileIndex];
+	}
+
+	mapWavFile[aFileIndex] = apWavFile;
+	maIsOwned[aFileIndex] = aIsOwned && nullptr != apWavFile;
 
+	//A new file gets its own end report
+	mEndedSeenMask &= ~(1 << aFileIndex);
+	mPendingEndedMask &= ~(1 << aFileIndex);
+	mUnsupportedRateMask &= ~(1 << aFileIndex);
 
+	//Find out if the new file can play before the next chunk is mixed
+	mPlayingVoiceMask &= ~(1 << aFileIndex);
+	mVoiceCheckMask |= 1 << aFileIndex;
+	if(nullptr != apWavFile)
+	{
+		//Resample files that don't match the playback rate
+		ConfigureResampler(aFileIndex, true);
+		apWavFile->SetQuality(mQualityLevel);
+
+		apWavFile->SetEventSink(this);
+
+		if(nullptr != mpIOScheduler)
+		{
+			maBytesPerSecond[aFileIndex] = GetBytesPerSecond(apWavFile);
+			apWavFile->SetIOScheduler(mpIOScheduler, maBytesPerSecond[aFileIndex]);
 		}
 	}
 }
 
-void  I2SWavPlayer::ClearAllWavFiles()
+bool I2SWavPlayer::ScheduleStart(ISDWavFile* apWavFile, int aFileIndex, uint64_t aAtSample)
 {
+	if(aFileIndex >= MAX_WAV_FILES || aFileIndex < 0 || nullptr == apWavFile)
+	{
+		return false;
+	}
+
+	CancelScheduledStart(aFileIndex);
+
+	//A file that is still playing (re-triggering a sound) can only be rewound when it starts again
+	bool lIsPlaying = false;
 	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
 	{
-		mapWavFile[lIdx] = nullptr;
+		lIsPlaying |= (apWavFile == mapWavFile[lIdx]);
 	}
 
-	//Flush the I2S buffers so only silence will play
-	memset(maBufferA, 0, sizeof(int32_t)*I2S_BUF_SIZE);
-	memset(maBufferB, 0, sizeof(int32_t)*I2S_BUF_SIZE);
+	if(!lIsPlaying)
+	{
+		//Rewind now, so the first data is already buffered when the file starts
+		apWavFile->SeekStartOfData();
+		if(nullptr != mpIOScheduler)
+		{
+			apWavFile->SetIOScheduler(mpIOScheduler, GetBytesPerSecond(apWavFile));
+		}
+	}
+
+	maScheduledStarts[aFileIndex].mpWavFile = apWavFile;
+	maScheduledStarts[aFileIndex].mAtSample = aAtSample;
+	maScheduledStarts[aFileIndex].mIsRewindNeeded = lIsPlaying;
+	mNumScheduledStarts++;
+
+	return true;
 }
 
-void I2SWavPlayer::StartPlayback()
+void I2SWavPlayer::ReleaseWavFile(int aFileIndex)
 {
+	ISDWavFile* lpWavFile = mapWavFile[aFileIndex];
+	bool lIsOwned = maIsOwned[aFileIndex];
+
+	mapWavFile[aFileIndex] = nullptr;
+	maIsOwned[aFileIndex] = false;
 
-	for(int lIdx = 0; lIdx < I2S_BUF_SIZE; lIdx++)
+	if(nullptr == lpWavFile)
 	{
-		GenerateMixedI2SSample(maBufferA[lIdx]);
+		return;
 	}
-	for(int lIdx = 0; lIdx < I2S_BUF_SIZE; lIdx++)
+
+	//Stop reading ahead for and listening to the file
+	if(nullptr != mpIOScheduler)
 	{
-		GenerateMixedI2SSample(maBufferB[lIdx]);
+		lpWavFile->SetIOScheduler(nullptr, 0);
 	}
+	lpWavFile->SetEventSink(nullptr);
 
-	mBufferASelected = true;
+	if(lIsOwned)
+	{
+		WavFileHandle::Destroy(lpWavFile);
+	}
+}
 
-	NRF_I2S->RXTXD.MAXCNT = I2S_BUF_SIZE;
-	NRF_I2S->TXD.PTR = (uint32_t) maBufferA;
-	NRF_I2S->EVENTS_TXPTRUPD = 0;
+void I2SWavPlayer::CancelScheduledStart(int aFileIndex)
+{
+	ISDWavFile* lpWavFile = maScheduledStarts[aFileIndex].mpWavFile;
+	if(nullptr == lpWavFile)
+	{
+		return;
+	}
+
+	//Stop reading ahead for the file, unless it is also playing
+	if(nullptr != mpIOScheduler)
+	{
+		bool lIsPlaying = false;
+		for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+		{
+			lIsPlaying |= (lpWavFile == mapWavFile[lIdx]);
+		}
+
+		if(!lIsPlaying)
+		{
+			lpWavFile->SetIOScheduler(nullptr, 0);
+		}
+	}
 
-	// restart the MCK generator (a TASKS_STOP will disable the MCK generator)
-	// Start transmitting I2S data
-	NRF_I2S->TASKS_START = 1;
+	maScheduledStarts[aFileIndex].mpWavFile = nullptr;
+	mNumScheduledStarts--;
 }
 
-void I2SWavPlayer::StopPlayback()
+int I2SWavPlayer::StartScheduledFiles(int aMaxSamples)
 {
-	// Stop transmitting I2S data, a TASKS_STOP will disable the MCK generator
-	NRF_I2S->TASKS_STOP = 1;
+	int lNumSamples = aMaxSamples;
+
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES && mNumScheduledStarts > 0; lIdx++)
+	{
+		tScheduledStart& lrStart = maScheduledStarts[lIdx];
+		if(nullptr == lrStart.mpWavFile)
+		{
+			continue;
+		}
+
+		if(lrStart.mAtSample <= mPlaybackClock)
+		{
+			ISDWavFile* lpWavFile = lrStart.mpWavFile;
+			lrStart.mpWavFile = nullptr;
+			mNumScheduledStarts--;
+
+			if(lrStart.mIsRewindNeeded)
+			{
+				lpWavFile->SeekStartOfData();
+			}
+
+			InstallWavFile(lpWavFile, lIdx);
+		}
+		else if(lrStart.mAtSample - mPlaybackClock < (uint64_t)lNumSamples)
+		{
+			//Stop mixing right before this file has to start
+			lNumSamples = lrStart.mAtSample - mPlaybackClock;
+		}
+	}
+
+	return lNumSamples;
 }
 
-bool I2SWavPlayer::ContinuePlayback()
+void I2SWavPlayer::SetIOScheduler(IOScheduler* apScheduler, bool aServiceWhileMixing)
 {
-	bool lPlaybackIsDone = false;
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+	{
+		if(nullptr != mapWavFile[lIdx])
+		{
+			maBytesPerSecond[lIdx] = GetBytesPerSecond(mapWavFile[lIdx]);
+			mapWavFile[lIdx]->SetIOScheduler(apScheduler, maBytesPerSecond[lIdx]);
+		}
+	}
+
+	mpIOScheduler = apScheduler;
+	mServiceWhileMixing = aServiceWhileMixing;
+}
 
-	if (NRF_I2S->EVENTS_TXPTRUPD != 0) //It's time to update a buffer
+uint32_t I2SWavPlayer::GetBytesPerSecond(ISDWavFile* apWavFile)
+{
+	return (uint32_t)(apWavFile->GetHeader().byteRate * apWavFile->GetPlaybackSpeed() + 0.5f);
+}
+
+void I2SWavPlayer::UpdateSchedulerRates()
+{
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
 	{
-		if (mBufferASelected == true)
+		if(nullptr == mapWavFile[lIdx])
 		{
-			NRF_I2S->EVENTS_TXPTRUPD = 0; //Start consuming buffer B
-			NRF_I2S->TXD.PTR = (uint32_t)maBufferA;
-			memcpy(maBufferA, maMixedI2SSamples, sizeof(int32_t)*I2S_BUF_SIZE);
+			continue;
 		}
-		else
+
+		//Registering again only updates the rate the reader is kept ahead at
+		uint32_t lBytesPerSecond = GetBytesPerSecond(mapWavFile[lIdx]);
+		if(lBytesPerSecond != maBytesPerSecond[lIdx])
 		{
-			NRF_I2S->EVENTS_TXPTRUPD = 0; //Start consuming buffer A
-			NRF_I2S->TXD.PTR = (uint32_t)maBufferB;
-			memcpy(maBufferB, maMixedI2SSamples, sizeof(int32_t)*I2S_BUF_SIZE);
+			maBytesPerSecond[lIdx] = lBytesPerSecond;
+			mapWavFile[lIdx]->SetIOScheduler(mpIOScheduler, lBytesPerSecond);
 		}
+	}
+}
 
-		PopulateMixingBuffer(); //Pre-mix next set of samples
+void  I2SWavPlayer::ClearAllWavFiles()
+{
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+	{
+		ReleaseWavFile(lIdx);
 
-		//Toggle buffer selector
-		mBufferASelected = !mBufferASelected;
+		CancelScheduledStart(lIdx);
+	}
+
+	//Flush the output buffers so only silence will play
+	if(nullptr != mpSink)
+	{
+		mpSink->Silence();
+	}
+
+	mActiveVoiceMask = 0;
+	mPlayingVoiceMask = 0;
+	mVoiceCheckMask = 0;
+	mUnsupportedRateMask = 0;
+	mEndedSeenMask = 0;
+	mPendingEndedMask = 0;
+
+	//Events from the removed files are no longer meaningful
+	mNumEvents = 0;
+
+	//Drop whatever the limiter was holding back
+	mLimiter.Reset();
+}
+
+void I2SWavPlayer::StartPlayback()
+{
+	//Fill every output buffer before output starts
+	int32_t* lpBuffer = GetSink()->GetFreeBuffer();
+	while(nullptr != lpBuffer)
+	{
+		MixSamples(lpBuffer, I2S_BUF_SIZE);
+		mpSink->SubmitBuffer(lpBuffer);
+		lpBuffer = mpSink->GetFreeBuffer();
+	}
+
+	mpSink->Start();
+}
+
+void I2SWavPlayer::StopPlayback()
+{
+	if(nullptr != mpSink)
+	{
+		mpSink->Stop();
+	}
+}
+
+bool I2SWavPlayer::ContinuePlayback()
+{
+	bool lPlaybackIsDone = false;
+
+	int32_t* lpBuffer = GetSink()->GetFreeBuffer();
+	if (nullptr != lpBuffer) //It's time to update a buffer
+	{
+		UpdateQuality(MixBlock(lpBuffer, I2S_BUF_SIZE));
+
+		mpSink->SubmitBuffer(lpBuffer);
 	}
 
 	if(0 == mSamplesMixed)
@@ -172,6 +439,47 @@ bool I2SWavPlayer::ContinuePlayback()
 	return lPlaybackIsDone;
 }
 
+int I2SWavPlayer::Render(int32_t* apBuffer, uint32_t aNumFrames)
+{
+	while(aNumFrames > 0)
+	{
+		int lNumFrames = aNumFrames > I2S_BUF_SIZE ? I2S_BUF_SIZE : aNumFrames;
+
+		MixBlock(apBuffer, lNumFrames);
+
+		apBuffer += lNumFrames;
+		aNumFrames -= lNumFrames;
+	}
+
+	return mSamplesMixed;
+}
+
+unsigned long I2SWavPlayer::MixBlock(int32_t* apBuffer, int aNumSamples)
+{
+	unsigned long lMixStartTime = micros();
+	unsigned long lReadStartTime = BufferedFileReader::GetReadMicros();
+
+	MixSamples(apBuffer, aNumSamples);
+
+	//Keep track of how long mixing took, and how much of that was the SD card
+	unsigned long lMixTime = micros() - lMixStartTime;
+	unsigned long lReadTime = BufferedFileReader::GetReadMicros() - lReadStartTime;
+	mMixStats.mLastMixMicros = lMixTime;
+	mMixStats.mLastReadMicros = lReadTime;
+	mMixStats.mTotalMixMicros += lMixTime;
+	mMixStats.mBlocksMixed++;
+	if(lMixTime > mMixStats.mMaxMixMicros)
+	{
+		mMixStats.mMaxMixMicros = lMixTime;
+	}
+	if(eeQualityFull != mQualityLevel)
+	{
+		mMixStats.mReducedQualityBlocks++;
+	}
+
+	return lMixTime > lReadTime ? lMixTime - lReadTime : 0;
+}
+
 bool I2SWavPlayer::IsEnded()
 {
 	bool lIsEnded = true;
@@ -201,188 +509,631 @@ void I2SWavPlayer::SetVolume(float aVolume)
 	{
 		mVolume = aVolume;
 	}
+
+	mLimiter.SetGain(mVolume);
 }
 
+bool I2SWavPlayer::QueueSetWavFile(ISDWavFile* apWavFile, int aFileIndex, bool aIsOwned)
+{
+	return QueueCommand(eeCmdSetWavFile, apWavFile, 0.0, aFileIndex, aIsOwned);
+}
 
-void I2SWavPlayer::ClipSample(int32_t& arSample)
+bool I2SWavPlayer::QueueSetWavFile(WavFileHandle&& arWavFile, int aFileIndex)
 {
-	if(arSample > INT16_MAX)
+	if(aFileIndex >= MAX_WAV_FILES || aFileIndex < 0
+	   || !QueueSetWavFile(arWavFile.Get(), aFileIndex, true))
 	{
-		arSample = INT16_MAX;
+		return false;
 	}
-	else if(arSample < INT16_MIN)
+
+	arWavFile.Release();
+	return true;
+}
+
+bool I2SWavPlayer::QueueScheduleStart(ISDWavFile* apWavFile, int aFileIndex, uint64_t aAtSample)
+{
+	return QueueCommand(eeCmdScheduleStart, apWavFile, 0.0, aFileIndex, false, aAtSample);
+}
+
+bool I2SWavPlayer::QueueClearAllWavFiles()
+{
+	return QueueCommand(eeCmdClearAllWavFiles, nullptr);
+}
+
+bool I2SWavPlayer::QueueSetVolume(float aVolume)
+{
+	return QueueCommand(eeCmdSetMasterVolume, nullptr, aVolume);
+}
+
+bool I2SWavPlayer::QueueSetSampleRate(ESampleRate aSampleRate)
+{
+	return QueueCommand(eeCmdSetSampleRate, nullptr, 0.0, aSampleRate);
+}
+
+bool I2SWavPlayer::QueueSetFileVolume(ISDWavFile* apWavFile, float aVolume)
+{
+	return QueueCommand(eeCmdSetFileVolume, apWavFile, aVolume);
+}
+
+bool I2SWavPlayer::QueueSetFileRate(PitchShiftSDWavFile* apWavFile, float aRate)
+{
+	return QueueCommand(eeCmdSetFileRate, apWavFile, aRate);
+}
+
+bool I2SWavPlayer::QueueSetLooping(ISDWavFile* apWavFile, bool aLoopingEnable)
+{
+	return QueueCommand(eeCmdSetLooping, apWavFile, 0.0, 0, aLoopingEnable);
+}
+
+bool I2SWavPlayer::QueuePause(ISDWavFile* apWavFile)
+{
+	return QueueCommand(eeCmdPause, apWavFile);
+}
+
+bool I2SWavPlayer::QueueUnPause(ISDWavFile* apWavFile)
+{
+	return QueueCommand(eeCmdUnPause, apWavFile);
+}
+
+bool I2SWavPlayer::QueueCommand(uint8_t aType, ISDWavFile* apWavFile, float aValue, int aFileIndex, bool aFlag, uint64_t aTime)
+{
+	tPlayerCommand lCommand;
+	lCommand.mType = aType;
+	lCommand.mFileIndex = aFileIndex;
+	lCommand.mFlag = aFlag;
+	lCommand.mValue = aValue;
+	lCommand.mpFile = apWavFile;
+	lCommand.mTime = aTime;
+
+	return mCommandQueue.Push(lCommand);
+}
+
+void I2SWavPlayer::ApplyQueuedCommands()
+{
+	tPlayerCommand lCommand;
+
+	//Never apply more than a queue's worth, so a producer that keeps
+	//queueing can't hold up mixing
+	for(int lCount = 0; lCount < PLAYER_COMMAND_QUEUE_SIZE && mCommandQueue.Pop(lCommand); lCount++)
 	{
-		arSample = INT16_MIN;
+		switch(lCommand.mType)
+		{
+		case eeCmdSetWavFile:
+			SetWavFile(lCommand.mpFile, lCommand.mFileIndex, lCommand.mFlag);
+			break;
+		case eeCmdScheduleStart:
+			ScheduleStart(lCommand.mpFile, lCommand.mFileIndex, lCommand.mTime);
+			break;
+		case eeCmdClearAllWavFiles:
+			ClearAllWavFiles();
+			break;
+		case eeCmdSetMasterVolume:
+			SetVolume(lCommand.mValue);
+			break;
+		case eeCmdSetSampleRate:
+			Configure_I2S_Speed((ESampleRate)lCommand.mFileIndex);
+			break;
+		case eeCmdSetFileVolume:
+			lCommand.mpFile->SetVolume(lCommand.mValue);
+			break;
+		case eeCmdSetFileRate:
+			((PitchShiftSDWavFile*)lCommand.mpFile)->SetRate(lCommand.mValue);
+			break;
+		case eeCmdSetLooping:
+			lCommand.mpFile->SetLooping(lCommand.mFlag);
+			CheckVoiceState(lCommand.mpFile);
+			break;
+		case eeCmdPause:
+			lCommand.mpFile->Pause();
+			CheckVoiceState(lCommand.mpFile);
+			break;
+		case eeCmdUnPause:
+			lCommand.mpFile->UnPause();
+			CheckVoiceState(lCommand.mpFile);
+			break;
+		default:
+			break;
+		}
 	}
 }
 
-void I2SWavPlayer::GenerateMixedI2SSample(int32_t& arSampleOut)
+void I2SWavPlayer::SetEventCallback(tPlayerEventCallback apCallback, void* apContext)
 {
+	mpEventCallback = apCallback;
+	mpEventContext = apContext;
+}
 
-	int lSamplesCounter = 0;
-
-	//Fetch 16-bit samples from even-numbered files to create left channel
-	int32_t lMixedSampleLeft32 = 0;
-	for(int lWavFileIdx = 0; lWavFileIdx < MAX_WAV_FILES; lWavFileIdx += 2)
+void I2SWavPlayer::OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition)
+{
+	int lFileIndex = -1;
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
 	{
-		ISDWavFile* lpCurFilePtr = mapWavFile[lWavFileIdx];
-		if(lpCurFilePtr != nullptr
-				&& !lpCurFilePtr->IsPaused()
-				&& !lpCurFilePtr->IsEnded())
+		if(apSource == mapWavFile[lIdx])
 		{
-			int16_t lCurSample = 0;
+			lFileIndex = lIdx;
+			break;
+		}
+	}
 
-			//Handle down-sampling
-			if(maDownsampleParams[lWavFileIdx].mIsDownsample && lpCurFilePtr->Available() >= sizeof(int32_t))
-			{
-				//Double-fetch to skip a sample if we have at least
-				//32 bytes (2 16-bit samples)left to read
-				lpCurFilePtr->Skip16BitSamples(1);
-				lpCurFilePtr->Fetch16BitSamples(&lCurSample, 1);
-			}
-			else
-			{
-				//Fetch sample from current file
-				lpCurFilePtr->Fetch16BitSamples(&lCurSample, 1);
-			}
+	if(lFileIndex < 0)
+	{
+		return; //Not one of ours
+	}
 
-			//Mix new sample with already collected samples
-			lMixedSampleLeft32 += (int32_t)lCurSample;
+	//The voice may have to start or stop, look at it before the next chunk
+	if(eeWavFileEnded == aEvent || eeWavFileStateChanged == aEvent)
+	{
+		mVoiceCheckMask |= 1 << lFileIndex;
+	}
+
+	//State changes are only for the player
+	if(nullptr == mpEventCallback || eeWavFileStateChanged == aEvent)
+	{
+		return;
+	}
+
+	if(mNumEvents >= PLAYER_EVENT_QUEUE_SIZE)
+	{
+		mNumDroppedEvents++;
+		return;
+	}
+
+	tPlayerEvent& lrEvent = maEvents[mNumEvents++];
+	lrEvent.mType = aEvent;
+	lrEvent.mFileIndex = lFileIndex;
+	lrEvent.mSamplePosition = aSamplePosition;
+	lrEvent.mBlockOffset = mMixOffset;
+	lrEvent.mClockTime = mBlockStartClock + mMixOffset;
+}
+
+void I2SWavPlayer::DeliverEvents()
+{
+	int lNumEvents = mNumEvents;
+
+	//Clear first so the callback can safely change files
+	mNumEvents = 0;
 
-			//Keep track of how many valid samples we read
-			lSamplesCounter++;
+	for(int lIdx = 0; lIdx < lNumEvents && nullptr != mpEventCallback; lIdx++)
+	{
+		mpEventCallback(maEvents[lIdx], mpEventContext);
+	}
+}
+
+void I2SWavPlayer::ResetMixStats()
+{
+	mMixStats.mLastMixMicros = 0;
+	mMixStats.mMaxMixMicros = 0;
+	mMixStats.mTotalMixMicros = 0;
+	mMixStats.mBlocksMixed = 0;
+	mMixStats.mLastReadMicros = 0;
+	mMixStats.mLastLoadPercent = 0;
+	mMixStats.mReducedQualityBlocks = 0;
+
+	for(int lIdx = 0; lIdx <= eeQualityLow; lIdx++)
+	{
+		mMixStats.maQualityDrops[lIdx] = 0;
+		mMixStats.maQualityRestores[lIdx] = 0;
+	}
+}
+
+void I2SWavPlayer::SetAdaptiveQuality(bool aEnable)
+{
+	mIsAdaptiveQuality = aEnable;
+	mNumQuietBlocks = 0;
 
+	if(!aEnable && eeQualityFull != mQualityLevel)
+	{
+		mMixStats.maQualityRestores[eeQualityFull]++;
+		SetQualityLevel(eeQualityFull);
+	}
+}
+
+void I2SWavPlayer::SetVoicePriority(int aFileIndex, int8_t aPriority)
+{
+	if(aFileIndex < MAX_WAV_FILES && aFileIndex >= 0)
+	{
+		maVoicePriority[aFileIndex] = aPriority;
+	}
+}
+
+void I2SWavPlayer::UpdateQuality(unsigned long aMixMicros)
+{
+	unsigned long lBlockMicros = (uint64_t)I2S_BUF_SIZE * 1000000 / GetOutputSampleRate();
+	unsigned long lLoadPercent = aMixMicros * 100 / lBlockMicros;
+	mMixStats.mLastLoadPercent = lLoadPercent;
+
+	if(!mIsAdaptiveQuality)
+	{
+		return;
+	}
+
+	if(lLoadPercent > QUALITY_DEGRADE_LOAD)
+	{
+		//Close to missing the deadline, step down right away
+		mNumQuietBlocks = 0;
+		if(eeQualityLow != mQualityLevel)
+		{
+			EQualityLevel lLevel = (EQualityLevel)(mQualityLevel + 1);
+			mMixStats.maQualityDrops[lLevel]++;
+			SetQualityLevel(lLevel);
+		}
+	}
+	else if(lLoadPercent < QUALITY_RESTORE_LOAD && eeQualityFull != mQualityLevel)
+	{
+		//Only step back up once there has been time to spare for a while
+		if(++mNumQuietBlocks >= QUALITY_RESTORE_BLOCKS)
+		{
+			mNumQuietBlocks = 0;
+			EQualityLevel lLevel = (EQualityLevel)(mQualityLevel - 1);
+			mMixStats.maQualityRestores[lLevel]++;
+			SetQualityLevel(lLevel);
+		}
+	}
+	else
+	{
+		mNumQuietBlocks = 0;
+	}
+}
+
+void I2SWavPlayer::SetQualityLevel(EQualityLevel aLevel)
+{
+	mQualityLevel = aLevel;
+
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+	{
+		if(nullptr != mapWavFile[lIdx])
+		{
+			mapWavFile[lIdx]->SetQuality(aLevel);
 		}
 	}
+}
+
+uint32_t I2SWavPlayer::GetOutputSampleRate()
+{
+	return SampleRateToHz(mSampleRate);
+}
 
-	//Fetch 16-bit samples from odd-numbered files to create right channel
-	int32_t lMixedSampleRight32 = 0;
-	for(int lWavFileIdx = 1; lWavFileIdx < MAX_WAV_FILES; lWavFileIdx += 2)
+void I2SWavPlayer::UpdateActiveVoices()
+{
+	//Only voices that reported a change or ran out of data are asked again
+	uint32_t lCheckMask = mVoiceCheckMask.exchange(0);
+	while(0 != lCheckMask)
 	{
-		ISDWavFile* lpCurFilePtr = mapWavFile[lWavFileIdx];
-		if(lpCurFilePtr != nullptr
-				&& !lpCurFilePtr->IsPaused()
-				&& !lpCurFilePtr->IsEnded())
+		int lIdx = __builtin_ctz(lCheckMask);
+		lCheckMask &= lCheckMask - 1;
+		uint32_t lVoiceBit = 1 << lIdx;
+
+		ISDWavFile* lpCurFilePtr = mapWavFile[lIdx];
+		mPlayingVoiceMask &= ~lVoiceBit;
+		if(nullptr == lpCurFilePtr)
+		{
+			continue;
+		}
+
+		if(lpCurFilePtr->IsEnded())
+		{
+			//Report each end once, until the voice is restarted or replaced
+			if(0 == (mEndedSeenMask & lVoiceBit))
+			{
+				mEndedSeenMask |= lVoiceBit;
+				mPendingEndedMask |= lVoiceBit;
+			}
+		}
+		else
 		{
-			//Fetch sample from current file
-			int16_t lCurSample = 0;
-			//Handle down-sampling
-			if(maDownsampleParams[lWavFileIdx].mIsDownsample)
+			mEndedSeenMask &= ~lVoiceBit;
+			if(!lpCurFilePtr->IsPaused())
 			{
-				//Double-fetch to skip a sample
-				if(lpCurFilePtr->Available() >= sizeof(int32_t))
-				{
-					lpCurFilePtr->Fetch16BitSamples(&lCurSample, 1);
-					lpCurFilePtr->Fetch16BitSamples(&lCurSample, 1);
-				}
+				mPlayingVoiceMask |= lVoiceBit;
 			}
-			else
+		}
+	}
+
+	//Files the player can't resample would play at the wrong pitch
+	uint32_t lActiveMask = mPlayingVoiceMask & ~mUnsupportedRateMask;
+
+	//Short on time, leave the least important voice out of the mix
+	mDroppedVoiceMask = 0;
+	if(eeQualityLow == mQualityLevel && 0 != (lActiveMask & (lActiveMask - 1)))
+	{
+		int lDropIdx = -1;
+		for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+		{
+			if(0 != (lActiveMask & (1 << lIdx))
+				&& (lDropIdx < 0 || maVoicePriority[lIdx] <= maVoicePriority[lDropIdx]))
 			{
-				lpCurFilePtr->Fetch16BitSamples(&lCurSample, 1);
+				lDropIdx = lIdx;
 			}
+		}
 
-			//Mix new sample with already collected samples
-			lMixedSampleRight32 += (int32_t)lCurSample;
+		mDroppedVoiceMask = 1 << lDropIdx;
+		lActiveMask &= ~mDroppedVoiceMask;
+	}
 
-			//Keep track of how many valid samples we read
-			lSamplesCounter++;
+	mActiveVoiceMask = lActiveMask;
+}
+
+void I2SWavPlayer::CheckVoiceState(ISDWavFile* apWavFile)
+{
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+	{
+		if(apWavFile == mapWavFile[lIdx])
+		{
+			mVoiceCheckMask |= 1 << lIdx;
 		}
 	}
-	//Clipping
-	ClipSample(lMixedSampleLeft32);
-	ClipSample(lMixedSampleRight32);
+}
 
-	//Volume control
-	if(mVolume < 1.0)
+void I2SWavPlayer::ConfigureResampler(int aFileIdx, bool aIsRestart)
+{
+	tResampleParameters& lrParams = maResampleParams[aFileIdx];
+	uint32_t lFileRate = mapWavFile[aFileIdx]->GetHeader().sampleRate;
+	uint32_t lOutputRate = GetOutputSampleRate();
+
+	uint32_t lStep = 0x10000;
+	if(lFileRate > 0 && lFileRate != lOutputRate)
+	{
+		lStep = (uint32_t)(((uint64_t)lFileRate << 16) / lOutputRate);
+	}
+	if(lStep > (RESAMPLE_MAX_RATIO << 16))
+	{
+		//Too fast to resample, leave the voice out until the output rate allows it
+		lStep = RESAMPLE_MAX_RATIO << 16;
+		mUnsupportedRateMask |= 1 << aFileIdx;
+	}
+	else
 	{
-		lMixedSampleLeft32 *= mVolume;
-		lMixedSampleRight32 *= mVolume;
+		mUnsupportedRateMask &= ~(1 << aFileIdx);
 	}
+	lrParams.mStep = lStep;
 
-	//Keep track of how many files were able to get samples from
-	mSamplesMixed = lSamplesCounter;
+	if(aIsRestart)
+	{
+		//When down-sampling, each output sample is the last of the file samples
+		//it stands for (a 44.1KHz file at 22.05KHz keeps every second sample)
+		lrParams.mPhase = lStep > 0x10000 ? lStep : 0x10000;
+		lrParams.maCarry[0] = 0;
+		lrParams.mNumCarry = 1;
+	}
+	else if(0x10000 == lStep)
+	{
+		//Drop the fraction so the voice can go back to plain rendering
+		lrParams.mPhase = 0x10000;
+	}
+}
 
-	//16-bit left and right channel samples
-	int16_t lMixedSample16Left = (int16_t)lMixedSampleLeft32;
-	int16_t lMixedSample16Right = (int16_t)lMixedSampleRight32;
+int I2SWavPlayer::RenderVoice(int aFileIdx, int aNumSamples)
+{
+	ISDWavFile* lpCurFilePtr = mapWavFile[aFileIdx];
+	tResampleParameters& lrParams = maResampleParams[aFileIdx];
+
+	//Same rate, the file renders straight into the block
+	if(0x10000 == lrParams.mStep && 0x10000 == lrParams.mPhase && 1 == lrParams.mNumCarry)
+	{
+		int lNumRendered = lpCurFilePtr->Render(maVoiceBlock, aNumSamples);
+		if(lNumRendered > 0)
+		{
+			lrParams.maCarry[0] = maVoiceBlock[lNumRendered - 1];
+		}
+
+		return lNumRendered;
+	}
+
+	//The samples carried over from the previous block come first, the new file
+	//samples follow them. Render enough for the last output sample to interpolate from.
+	uint32_t lStep = lrParams.mStep;
+	uint32_t lPhase = lrParams.mPhase;
+	int lNumCarry = lrParams.mNumCarry;
+	int lLastIdx = ((lPhase + (aNumSamples - 1) * lStep) >> 16) + 1;
+
+	maResampleBlock[0] = lrParams.maCarry[0];
+	maResampleBlock[1] = lrParams.maCarry[1];
+	int lNumRendered = 0;
+	if(lLastIdx >= lNumCarry)
+	{
+		lNumRendered = lpCurFilePtr->Render(&maResampleBlock[lNumCarry], lLastIdx - lNumCarry + 1);
+	}
+	int lNumAvailable = lNumCarry + lNumRendered;
+
+	//If the file runs out partway into an output sample, the last sample is kept
+	uint32_t lEndPhase = ((uint32_t)(lNumAvailable - 1) << 16) + lStep;
+	int lNumSamples = 0;
+
+	if(eeQualityFull == mQualityLevel)
+	{
+		while(lNumSamples < aNumSamples && lPhase < lEndPhase)
+		{
+			int lSrcIdx = lPhase >> 16;
+			int32_t lSample0 = maResampleBlock[lSrcIdx < lNumAvailable ? lSrcIdx : lNumAvailable - 1];
+			int32_t lSample1 = maResampleBlock[lSrcIdx + 1 < lNumAvailable ? lSrcIdx + 1 : lNumAvailable - 1];
+			int32_t lFrac = (lPhase & 0xFFFF) >> 1;
+
+			maVoiceBlock[lNumSamples++] = lSample0 + (((lSample1 - lSample0) * lFrac) >> 15);
+			lPhase += lStep;
+		}
+	}
+	else
+	{
+		//Short on time, take the nearest sample instead of interpolating
+		while(lNumSamples < aNumSamples && lPhase < lEndPhase)
+		{
+			int lSrcIdx = (lPhase + 0x8000) >> 16;
+			maVoiceBlock[lNumSamples++] = maResampleBlock[lSrcIdx < lNumAvailable ? lSrcIdx : lNumAvailable - 1];
+			lPhase += lStep;
+		}
+	}
 
-	//Pointer so we can address 32-bit I2S word 16-bits at a time
-	int16_t* lSampleOut16Ptr = (int16_t*)&arSampleOut;
+	//Carry the file samples at and after the next output position over to the next block
+	int lBaseIdx = lPhase >> 16;
+	if(lBaseIdx > lNumAvailable - 1)
+	{
+		lBaseIdx = lNumAvailable - 1;
+	}
+	lrParams.mNumCarry = lNumAvailable - lBaseIdx;
+	lrParams.maCarry[0] = maResampleBlock[lBaseIdx];
+	lrParams.maCarry[1] = lrParams.mNumCarry > 1 ? maResampleBlock[lBaseIdx + 1] : 0;
+	lrParams.mPhase = lPhase - ((uint32_t)lBaseIdx << 16);
 
-	//Copy left and right channel data into output to create 32-bit I2S word
-	memcpy(lSampleOut16Ptr, &lMixedSample16Left, sizeof(int16_t));
-	memcpy(lSampleOut16Ptr+1, &lMixedSample16Right, sizeof(int16_t));
+	return lNumSamples;
 }
 
-int I2SWavPlayer::PopulateMixingBuffer()
+void I2SWavPlayer::SkipVoice(int aFileIdx, int aNumSamples)
 {
-	for(int lIdx = 0; lIdx < I2S_BUF_SIZE; lIdx++)
+	ISDWavFile* lpCurFilePtr = mapWavFile[aFileIdx];
+	tResampleParameters& lrParams = maResampleParams[aFileIdx];
+
+	//Same rate, just skip the file ahead
+	if(0x10000 == lrParams.mStep && 0x10000 == lrParams.mPhase && 1 == lrParams.mNumCarry)
 	{
-		GenerateMixedI2SSample(maMixedI2SSamples[lIdx]);
+		lpCurFilePtr->Skip16BitSamples(aNumSamples);
+		return;
 	}
 
-	return 0;
+	//Move the position on, then skip the file to the new first carried sample
+	uint32_t lPhase = lrParams.mPhase + aNumSamples * lrParams.mStep;
+	int lBaseIdx = lPhase >> 16;
+
+	if(lBaseIdx < lrParams.mNumCarry)
+	{
+		lrParams.maCarry[0] = lrParams.maCarry[lBaseIdx];
+		lrParams.mNumCarry -= lBaseIdx;
+	}
+	else
+	{
+		lpCurFilePtr->Skip16BitSamples(lBaseIdx - lrParams.mNumCarry);
+		if(0 == lpCurFilePtr->Render(lrParams.maCarry, 1))
+		{
+			lrParams.maCarry[0] = 0;
+		}
+		lrParams.mNumCarry = 1;
+	}
+	lrParams.mPhase = lPhase - ((uint32_t)lBaseIdx << 16);
 }
 
-void I2SWavPlayer::Configure_I2S()
+void I2SWavPlayer::MixVoices(int aNumSamples)
 {
-	// register structure hierarchy for I2S
-	// NRF_I2S is of type NRF_I2S_Type defined in nrf52.h
-	// CONFIG is of type I2S_CONFIG_Type defined in nrf52.h, sub-struct of NRF_I2S_Type
-	// Struct -> Element (kinda Struct.Element)
+	int lVoicesCounter = 0;
+
+	memset(maMixLeft, 0, sizeof(int32_t) * aNumSamples);
+	memset(maMixRight, 0, sizeof(int32_t) * aNumSamples);
+
+	uint32_t lVoices = mActiveVoiceMask;
+	while(0 != lVoices)
+	{
+		int lWavFileIdx = __builtin_ctz(lVoices);
+		lVoices &= lVoices - 1;
+
+		//Even-numbered files make up the left channel, odd-numbered files the right channel
+		int32_t* lpMix = (lWavFileIdx & 1) ? maMixRight : maMixLeft;
+
+		int lNumRendered = RenderVoice(lWavFileIdx, aNumSamples);
+		for(int lIdx = 0; lIdx < lNumRendered; lIdx++)
+		{
+			lpMix[lIdx] += maVoiceBlock[lIdx];
+		}
+
+		if(lNumRendered < aNumSamples)
+		{
+			//Out of data, stop mixing this voice. The next update will
+			//find out if it has ended.
+			mActiveVoiceMask &= ~(1 << lWavFileIdx);
+			mPlayingVoiceMask &= ~(1 << lWavFileIdx);
+			mVoiceCheckMask |= 1 << lWavFileIdx;
+		}
+		else
+		{
+			//Keep track of how many files made it to the end of the chunk
+			lVoicesCounter++;
+		}
+	}
+
+	//Voices left out of the mix still move on, so they are in time when they come back
+	uint32_t lDropped = mDroppedVoiceMask;
+	while(0 != lDropped)
+	{
+		int lWavFileIdx = __builtin_ctz(lDropped);
+		lDropped &= lDropped - 1;
+
+		SkipVoice(lWavFileIdx, aNumSamples);
+		lVoicesCounter++;
+	}
 
-	// Position variables (_Pos) are defined in nrf52_bitfields.h
+	mSamplesMixed = lVoicesCounter;
+}
+
+int I2SWavPlayer::MixSamples(int32_t* apBuffer, int aNumSamples)
+{
+	//Time it takes to play one slice, used to find readers that are about to run dry
+	uint32_t lSliceMicros = (uint64_t)IO_SCHEDULER_SLICE_SAMPLES * 1000000 / GetOutputSampleRate();
 
-	// Enable Tx transmission
-	NRF_I2S->CONFIG.TXEN = (I2S_CONFIG_TXEN_TXEN_ENABLE << I2S_CONFIG_TXEN_TXEN_Pos);
+	//Control calls made since the last block take effect together, before mixing starts
+	ApplyQueuedCommands();
 
-	// Enable MCK generator
-	NRF_I2S->CONFIG.MCKEN = (I2S_CONFIG_MCKEN_MCKEN_ENABLE << I2S_CONFIG_MCKEN_MCKEN_Pos);
+	//Rate changes made directly on the files count too, not only queued ones
+	if(nullptr != mpIOScheduler)
+	{
+		UpdateSchedulerRates();
+	}
 
-//	// set the sample rate to a value supported by the audio amp
-//	// LRCLK  ONLY  supports  8kHz,  16kHz,  32kHz,  44.1kHz,  48kHz, 88.2kHz, and 96kHz frequencies.
-//	// LRCLK clocks at  11.025kHz,  12kHz,  22.05kHz  and  24kHz  are  NOT supported.
-//
-//	// look for /* Register: I2S_CONFIG_MCKFREQ */ in nrf52_bitfields.h
-//	// MCKFREQ = 4 MHz
-//	//+++NRF_I2S->CONFIG.MCKFREQ =  I2S_CONFIG_MCKFREQ_MCKFREQ_32MDIV11 << I2S_CONFIG_MCKFREQ_MCKFREQ_Pos;
-//	//NRF_I2S->CONFIG.MCKFREQ =  I2S_CONFIG_MCKFREQ_MCKFREQ_32MDIV23 << I2S_CONFIG_MCKFREQ_MCKFREQ_Pos;
-//	NRF_I2S->CONFIG.MCKFREQ =  I2S_CONFIG_MCKFREQ_MCKFREQ_32MDIV10 << I2S_CONFIG_MCKFREQ_MCKFREQ_Pos;
-//
-//	// look for /* Register: I2S_CONFIG_RATIO */ in nrf52_bitfields.h
-//	// set 16kHz as default value -> Ration = 256 (4MHz/256=16kHz)
-//	//+++NRF_I2S->CONFIG.RATIO = I2S_CONFIG_RATIO_RATIO_128X << I2S_CONFIG_RATIO_RATIO_Pos;
-//	NRF_I2S->CONFIG.RATIO = I2S_CONFIG_RATIO_RATIO_32X << I2S_CONFIG_RATIO_RATIO_Pos;
+	//Voices keep playing where they are after a change of output rate,
+	//only the resampling changes. The output switches with them, so no
+	//block mixed for one rate is played at the other.
+	if(mIsRateChanged)
+	{
+		mIsRateChanged = false;
+		if(nullptr != mpSink)
+		{
+			mpSink->SetSampleRate(mSampleRate);
+		}
+		for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+		{
+			if(nullptr != mapWavFile[lIdx])
+			{
+				ConfigureResampler(lIdx, false);
+			}
+		}
+	}
 
-	Configure_I2S_Speed(ee2205); //Default I2S speed
+	mBlockStartClock = mPlaybackClock;
+	int lNextServiceStart = 0;
+	int lChunkSize = 0;
 
-	// 16/24/32-bit  resolution, the MAX98357A supports I2S timing only!
-	// Master mode, 16Bit, left aligned
-	NRF_I2S->CONFIG.MODE = I2S_CONFIG_MODE_MODE_MASTER << I2S_CONFIG_MODE_MODE_Pos;
+	for(int lChunkStart = 0; lChunkStart < aNumSamples; lChunkStart += lChunkSize)
+	{
+		if(nullptr != mpIOScheduler && mServiceWhileMixing && lChunkStart >= lNextServiceStart)
+		{
+			//Fill everybody up before mixing starts, after that only
+			//top up readers that would run dry during the next slice
+			mpIOScheduler->Service(0 == lChunkStart ? IO_SCHEDULER_ALL : lSliceMicros);
+			lNextServiceStart += IO_SCHEDULER_SLICE_SAMPLES;
+		}
 
-	// look for /* Register: I2S_CONFIG_SWIDTH */ in nrf52_bitfields.h
-	// 16 bit
-	NRF_I2S->CONFIG.SWIDTH = I2S_CONFIG_SWIDTH_SWIDTH_16BIT << I2S_CONFIG_SWIDTH_SWIDTH_Pos;
+		lChunkSize = aNumSamples - lChunkStart;
+		if(lChunkSize > MIX_CHUNK_SIZE)
+		{
+			lChunkSize = MIX_CHUNK_SIZE;
+		}
 
-	// Left-aligned (not to be mixed up with left-justified)
-	NRF_I2S->CONFIG.ALIGN = I2S_CONFIG_ALIGN_ALIGN_Left << I2S_CONFIG_ALIGN_ALIGN_Pos;
+		//Scheduled files start exactly on a chunk boundary, so cut the
+		//chunk short if one has to start in the middle of it
+		if(mNumScheduledStarts > 0)
+		{
+			lChunkSize = StartScheduledFiles(lChunkSize);
+		}
 
-	// Format I2S (i.e. not left justified)
-	NRF_I2S->CONFIG.FORMAT = I2S_CONFIG_FORMAT_FORMAT_I2S << I2S_CONFIG_FORMAT_FORMAT_Pos;
+		//Voices only change state between chunks (or when they run out of data),
+		//so the mixing loop doesn't have to ask every voice on every sample
+		UpdateActiveVoices();
 
-	// Use mono
-	NRF_I2S->CONFIG.CHANNELS = I2S_CONFIG_CHANNELS_CHANNELS_Stereo << I2S_CONFIG_CHANNELS_CHANNELS_Pos;
-	//NRF_I2S->CONFIG.CHANNELS = I2S_CONFIG_CHANNELS_CHANNELS_Left << I2S_CONFIG_CHANNELS_CHANNELS_Pos;
+		//Sum the voices, then let the master bus apply volume and limiting
+		mMixOffset = lChunkStart;
+		MixVoices(lChunkSize);
 
-	// configure the pins
-	NRF_I2S->PSEL.MCK = (mPinMCK << I2S_PSEL_MCK_PIN_Pos);
-	NRF_I2S->PSEL.SCK = (mPinBCLK << I2S_PSEL_SCK_PIN_Pos);
-	NRF_I2S->PSEL.LRCK = (mPinLRCK << I2S_PSEL_LRCK_PIN_Pos);
-	NRF_I2S->PSEL.SDOUT = (mPinDIN << I2S_PSEL_SDOUT_PIN_Pos);
+		mLimiter.Process(maMixLeft, maMixRight, &apBuffer[lChunkStart], lChunkSize);
+		mPlaybackClock += lChunkSize;
+	}
 
-	// Enable the I2S module using the ENABLE register
-	NRF_I2S->ENABLE = 1;
+	DeliverEvents();
 
-	pinMode (mPinSD, OUTPUT);
-	digitalWrite (mPinSD, HIGH);
+	return mSamplesMixed;
 }
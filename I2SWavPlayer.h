@@ -24,36 +24,114 @@
 #define I2SWAVPLAYER_H_
 
 #include "Arduino.h"
+#include <atomic>
+#include "AudioAlloc.h"
 #include "ISDWavFile.h"
+#include "WavFileHandle.h"
+#include "IOScheduler.h"
+#include "PlayerCommandQueue.h"
+#include "MasterLimiter.h"
+#include "I2SAudioSink.h"
 
-//I2S buffer size
-#define I2S_BUF_SIZE 2048
+class PitchShiftSDWavFile;
 
 //Maximum concurrent wav files
 #define MAX_WAV_FILES 5
 
-//Default Pins
-#define PIN_I2S_MCK_DEFAULT 13
-#define PIN_I2S_BCLK_DEFAULT (A2)
-#define PIN_I2S_LRCK_DEFAULT (A3)
-#define PIN_I2S_DIN_DEFAULT 18
-#define PIN_I2S_SD_DEFAULT  10
-
-enum ESampleRate
+//Voices mixed into each channel (even numbered files left, odd numbered files right)
+#define LEFT_VOICE_MASK  0x55555555
+#define RIGHT_VOICE_MASK 0xAAAAAAAA
+
+//How many samples are summed before being handed to the master limiter
+#define MIX_CHUNK_SIZE 32
+
+//How many samples are mixed between checks for urgent I/O
+//when an I/O scheduler is in use (must be a multiple of MIX_CHUNK_SIZE)
+#define IO_SCHEDULER_SLICE_SAMPLES 256
+
+//Largest ratio of file sample rate to output sample rate the player can
+//resample. Files with a higher ratio are not played (see GetUnsupportedRateVoices()).
+#define RESAMPLE_MAX_RATIO 4
+
+//Adaptive quality: a block that takes more than QUALITY_DEGRADE_LOAD percent
+//of its playing time to mix steps quality down one level. Quality steps back
+//up one level after QUALITY_RESTORE_BLOCKS blocks in a row under
+//QUALITY_RESTORE_LOAD percent.
+#ifndef QUALITY_DEGRADE_LOAD
+#define QUALITY_DEGRADE_LOAD 85
+#endif
+#ifndef QUALITY_RESTORE_LOAD
+#define QUALITY_RESTORE_LOAD 50
+#endif
+#ifndef QUALITY_RESTORE_BLOCKS
+#define QUALITY_RESTORE_BLOCKS 16
+#endif
+
+//How many file events can be collected during one block
+#ifndef PLAYER_EVENT_QUEUE_SIZE
+#define PLAYER_EVENT_QUEUE_SIZE 16
+#endif
+
+//A file event, as delivered to the player's event callback
+struct tPlayerEvent
 {
-	ee2205,
-	ee4410
+	//What happened
+	EWavFileEvent mType;
+	//Player channel of the file
+	int mFileIndex;
+	//Samples read from the file's data when the event happened
+	unsigned long mSamplePosition;
+	//Index of the output sample in the block being mixed when the event happened.
+	//Voices are rendered MIX_CHUNK_SIZE samples at a time, so this is the start
+	//of the chunk the event happened in.
+	int mBlockOffset;
+	//Playback clock time of the output sample being mixed when the event happened
+	uint64_t mClockTime;
 };
 
+//Called by the player for each file event. apContext is the pointer given to SetEventCallback().
+typedef void (*tPlayerEventCallback)(const tPlayerEvent& arEvent, void* apContext);
+
 /**
  * This class facilities basic wav file playback via I2S. It does on-the-fly
  * mixing of mutilple channels to create a single I2S stream from potentially
  * multiple files. Performance such as how many files can be played at once will
  * depend on I2S speed, number of simultaneous files, and raw CPU processing power.
+ *
+ * Mixed blocks go to an output sink (see IAudioSink). By default that is the
+ * I2S peripheral on the pins given to the constructor, SetOutputSink() sends
+ * them somewhere else, such as PWM pins or a file.
  */
-class I2SWavPlayer
+class I2SWavPlayer : protected IWavFileEventSink
 {
 public:
+	/**
+	 * Mixing performance statistics. Collected every time a
+	 * block of I2S_BUF_SIZE samples is mixed.
+	 */
+	struct tMixStats
+	{
+		//Time taken to mix the most recent block (microseconds)
+		unsigned long mLastMixMicros;
+		//Longest time taken to mix a single block (microseconds)
+		unsigned long mMaxMixMicros;
+		//Sum of all block mix times (microseconds)
+		unsigned long mTotalMixMicros;
+		//Number of blocks mixed
+		unsigned long mBlocksMixed;
+		//SD card read time during the most recent block (microseconds), part of mLastMixMicros
+		unsigned long mLastReadMicros;
+		//Mix time of the most recent block without the SD card reads, in percent
+		//of its playing time. Adaptive quality goes by this.
+		unsigned long mLastLoadPercent;
+		//Times quality was stepped down to each level (index by EQualityLevel)
+		unsigned long maQualityDrops[eeQualityLow + 1];
+		//Times quality was stepped back up to each level (index by EQualityLevel)
+		unsigned long maQualityRestores[eeQualityLow + 1];
+		//Blocks mixed below eeQualityFull
+		unsigned long mReducedQualityBlocks;
+	};
+
 	/**
 	 * Constructor.
 	 *
@@ -71,7 +149,8 @@ public:
 				 int32_t aPinSD = PIN_I2S_SD_DEFAULT);
 
 	/**
-	 * Destructor.
+	 * Destructor. Destroys the files the player owns (see SetWavFile()),
+	 * other files are left alone.
 	 */
 	~I2SWavPlayer();
 
@@ -81,18 +160,95 @@ public:
 	 */
 	bool Init();
 
+	/**
+	 * Send the mixed audio somewhere other than the I2S pins. Call this
+	 * before Init(), or while playback is stopped and then call Init() again.
+	 * The sink is not owned by the player. A player that never uses the I2S
+	 * pins never creates the I2S output or its buffers.
+	 * Args:
+	 *   apSink - Output to use, or nullptr to go back to I2S
+	 */
+	void SetOutputSink(IAudioSink* apSink);
+
+	/**
+	 * Fetch the output the player is using. This is nullptr until Init()
+	 * when the default I2S output is used.
+	 */
+	inline IAudioSink* GetOutputSink()
+	{
+		return mpSink;
+	}
+
 	/**
 	 * Sets wav file to play.
+	 * By default the file still belongs to the caller, who must not destroy it
+	 * until it is replaced or cleared. A file handed over with aIsOwned belongs
+	 * to the player, which destroys it when it is replaced or cleared, or when
+	 * the player is destroyed. Owned files must come from new, or when
+	 * NRF52AUDIO_STATIC_ALLOC is defined, be placement-constructed in storage
+	 * that outlives the player (only the destructor is called).
 	 * Args:
 	 *   apWavFile - Pointer to SDWavFile object to play
 	 *   aFileIndex - (optional) In the case of polyphonic playback,
 	 *                used to enumerate the file being provided
+	 *   aIsOwned - (optional) TRUE to hand the file over to the player
+	 */
+	void SetWavFile(ISDWavFile* apWavFile, int aFileIndex = 0, bool aIsOwned = false);
+
+	/**
+	 * Sets wav file to play and hands it over to the player (see above).
+	 * Args:
+	 *   arWavFile - Handle of the file to play, left empty if the file was taken
+	 *   aFileIndex - (optional) Which file is being provided
+	 * Returns: TRUE if the file was taken, FALSE if aFileIndex is out of range
 	 */
-	void SetWavFile(ISDWavFile* apWavFile, int aFileIndex = 0);
+	bool SetWavFile(WavFileHandle&& arWavFile, int aFileIndex = 0);
+
+	/**
+	 * Starts a wav file at an exact time on the playback clock (see
+	 * GetPlaybackClock()). Unless it is still playing, the file is rewound
+	 * right away so the SD card read doesn't happen while mixing. The mixer
+	 * puts it in the channel at exactly the requested output sample, even in
+	 * the middle of a block.
+	 * Times that have already passed start the file with the next mixed sample.
+	 * Only one start can be waiting per channel, scheduling another or calling
+	 * SetWavFile() or ClearAllWavFiles() cancels it.
+	 * Args:
+	 *   apWavFile - File to start
+	 *   aFileIndex - Channel to play the file on
+	 *   aAtSample - Playback clock time to start at
+	 * Returns: TRUE if scheduled, FALSE if the channel is not valid
+	 */
+	bool ScheduleStart(ISDWavFile* apWavFile, int aFileIndex, uint64_t aAtSample);
+
+	/**
+	 * Fetch the playback clock: the number of output samples mixed since the
+	 * player was created. This never goes backwards and keeps counting while
+	 * nothing is playing, as long as blocks are being mixed.
+	 * NOTE: Mixed samples are heard a couple of blocks later (the I2S buffers
+	 * play out first), so schedule starts at least 2 * I2S_BUF_SIZE ahead of
+	 * the clock for them to be heard at a predictable time.
+	 */
+	inline uint64_t GetPlaybackClock()
+	{
+		return mPlaybackClock;
+	}
+
+	/**
+	 * Sets an I/O scheduler to read file data ahead of time. The scheduler is
+	 * serviced once before each block is mixed so that SD card reads happen
+	 * in one burst instead of in the middle of mixing. Files set with
+	 * SetWavFile() are registered with the scheduler automatically.
+	 * Args:
+	 *   apScheduler - Scheduler to use, or nullptr to read files on demand
+	 *   aServiceWhileMixing - (optional) FALSE if something else (such as the
+	 *                         AudioRuntime I/O task) services the scheduler
+	 */
+	void SetIOScheduler(IOScheduler* apScheduler, bool aServiceWhileMixing = true);
 
 	/**
 	 * Removes wave files from all channels. (sets them to null)
-	 * and clears the I2S data buffers.
+	 * and clears the I2S data buffers. Files the player owns are destroyed.
 	 */
 	void ClearAllWavFiles();
 
@@ -110,10 +266,41 @@ public:
 	 * Continues fetching data from the WAV files and sending I2S data
 	 * via the I/O pins. Call this repeatedly in a loop or with a timer
 	 * interrupt to keep playback going. Failure to call this frequently
-	 * enough will cause gaps in the playback.
+	 * enough will cause gaps in the playback. A block is mixed whenever
+	 * the output sink has a free buffer.
 	 */
 	bool ContinuePlayback();
 
+	/**
+	 * Mixes samples from all files directly into a caller provided buffer
+	 * without touching the I2S hardware. Useful for rendering offline
+	 * and for regression testing the mixer.
+	 * Args:
+	 *   apBuffer - Buffer to fill with 32-bit I2S words (16-bit left and right samples)
+	 *   aNumSamples - How many 32-bit I2S words to mix
+	 * Returns: Number of files that contributed to the last mixed word
+	 */
+	int MixSamples(int32_t* apBuffer, int aNumSamples);
+
+	/**
+	 * Renders the next frames of the mix into a caller provided buffer as
+	 * fast as the CPU allows, without an output sink or the I2S clock pacing
+	 * it. Frames are mixed in blocks of I2S_BUF_SIZE through the same path
+	 * ContinuePlayback() feeds the sink from, so an offline render matches
+	 * what the hardware plays and is counted in the mixing statistics.
+	 * Adaptive quality is not updated while rendering.
+	 *
+	 * Control calls made between two calls take effect on the first frame of
+	 * the second one, so a timeline (volume, rate, scheduled starts) can be
+	 * automated by rendering it in pieces.
+	 * Args:
+	 *   apBuffer - Buffer to fill with 32-bit I2S words (16-bit left and right
+	 *              samples, the same layout as interleaved 16-bit stereo PCM)
+	 *   aNumFrames - How many 32-bit I2S words to render
+	 * Returns: Number of files still playing at the end of the render
+	 */
+	int Render(int32_t* apBuffer, uint32_t aNumFrames);
+
 	/**
 	 * Indicates if all files have finished playing.
 	 * Returns: TRUE if all files have ended playback, FALSE otherwise
@@ -121,108 +308,529 @@ public:
 	bool IsEnded();
 
 	/**
-	 * Sets the I2S clock speed.
+	 * Sets the output sample rate (the I2S clock speed when playing through
+	 * I2S). This can be changed during playback. The output is switched to
+	 * the new rate when the next block is mixed, together with the
+	 * resampling of the files that are already loaded, which keep playing
+	 * where they are.
 	 * Args:
-	 *  aSampleRate - ee2205 = 22.05 KHz
+	 *  aSampleRate - ee1600 = 16 KHz
+	 *                ee2205 = 22.05 KHz
+	 *                ee3200 = 32 KHz
 	 *                ee4410 = 44.1 KHz
+	 *                ee4800 = 48 KHz
 	 */
 	inline void Configure_I2S_Speed(ESampleRate aSampleRate)
 	{
 		mSampleRate = aSampleRate;
-
-		// set the sample rate to a value supported by the audio amp
-		// LRCLK  ONLY  supports  8kHz,  16kHz,  32kHz,  44.1kHz,  48kHz, 88.2kHz, and 96kHz frequencies.
-		// LRCLK clocks at  11.025kHz,  12kHz,  22.05kHz  and  24kHz  are  NOT supported.
-		switch (aSampleRate)
-		{
-		case ee2205: //LRCLK at 44.1kHz (for playback speed of 22.05kHz)
-			NRF_I2S->CONFIG.MCKFREQ =  I2S_CONFIG_MCKFREQ_MCKFREQ_32MDIV11 << I2S_CONFIG_MCKFREQ_MCKFREQ_Pos;
-			NRF_I2S->CONFIG.RATIO = I2S_CONFIG_RATIO_RATIO_128X << I2S_CONFIG_RATIO_RATIO_Pos;
-			break;
-		case ee4410: //LRCLK at 88.1kHz (for playback speed of 44.1kHz)
-			NRF_I2S->CONFIG.MCKFREQ =  I2S_CONFIG_MCKFREQ_MCKFREQ_32MDIV11 << I2S_CONFIG_MCKFREQ_MCKFREQ_Pos;
-			NRF_I2S->CONFIG.RATIO = I2S_CONFIG_RATIO_RATIO_64X << I2S_CONFIG_RATIO_RATIO_Pos;
-			break;
-		default:
-			Configure_I2S_Speed(ee2205);
-			break;
-		}
+		mIsRateChanged = true;
 	}
 
 	/**
-	 * Set master volume.
+	 * Set master volume. Volume is applied before the master limiter.
 	 * Args:
 	 *  aVolume - Any value between 0.0 (mute) and 1.0 (full volume)
 	 */
 	void SetVolume(float aVolume);
 
+	/**
+	 * Fetch the master bus limiter, to change its settings or read its gain reduction.
+	 */
+	inline MasterLimiter& GetLimiter()
+	{
+		return mLimiter;
+	}
+
+	/*
+	 * Queued control calls. These are safe to make from an interrupt handler or
+	 * from another task while playback is running. They never block and never
+	 * allocate. Commands are applied in order at the start of the next mixed
+	 * block. Only one context may queue commands. All Queue functions return
+	 * TRUE if the command was queued, FALSE if the command queue was full.
+	 */
+
+	/**
+	 * Queued version of SetWavFile().
+	 */
+	bool QueueSetWavFile(ISDWavFile* apWavFile, int aFileIndex = 0, bool aIsOwned = false);
+
+	/**
+	 * Queued version of SetWavFile() for a handle. The handle is only left
+	 * empty if the command was queued.
+	 */
+	bool QueueSetWavFile(WavFileHandle&& arWavFile, int aFileIndex = 0);
+
+	/**
+	 * Queued version of ScheduleStart().
+	 */
+	bool QueueScheduleStart(ISDWavFile* apWavFile, int aFileIndex, uint64_t aAtSample);
+
+	/**
+	 * Queued version of ClearAllWavFiles().
+	 */
+	bool QueueClearAllWavFiles();
+
+	/**
+	 * Queued version of SetVolume().
+	 */
+	bool QueueSetVolume(float aVolume);
+
+	/**
+	 * Queued version of Configure_I2S_Speed().
+	 */
+	bool QueueSetSampleRate(ESampleRate aSampleRate);
+
+	/**
+	 * Queue a call to apWavFile->SetVolume().
+	 */
+	bool QueueSetFileVolume(ISDWavFile* apWavFile, float aVolume);
+
+	/**
+	 * Queue a call to apWavFile->SetRate().
+	 */
+	bool QueueSetFileRate(PitchShiftSDWavFile* apWavFile, float aRate);
+
+	/**
+	 * Queue a call to apWavFile->SetLooping().
+	 */
+	bool QueueSetLooping(ISDWavFile* apWavFile, bool aLoopingEnable);
+
+	/**
+	 * Queue a call to apWavFile->Pause().
+	 */
+	bool QueuePause(ISDWavFile* apWavFile);
+
+	/**
+	 * Queue a call to apWavFile->UnPause().
+	 */
+	bool QueueUnPause(ISDWavFile* apWavFile);
+
+	/**
+	 * Group the commands queued from now until EndCommandBatch() so they
+	 * are all applied before the same block.
+	 */
+	inline void BeginCommandBatch()
+	{
+		mCommandQueue.BeginBatch();
+	}
+
+	/**
+	 * End a group of commands started with BeginCommandBatch().
+	 */
+	inline void EndCommandBatch()
+	{
+		mCommandQueue.EndBatch();
+	}
+
+	/**
+	 * Fetch how many queued commands were rejected because the queue was full.
+	 */
+	inline uint32_t GetNumDroppedCommands()
+	{
+		return mCommandQueue.GetNumDropped();
+	}
+
+	/**
+	 * Fetch which voices were mixed in the most recent chunk.
+	 * Returns: Bit mask, bit N set if file N is playing
+	 */
+	inline uint32_t GetActiveVoices()
+	{
+		return mActiveVoiceMask;
+	}
+
+	/**
+	 * Fetch and clear the voices that have ended since the last call. Each
+	 * voice is reported once per end, so there is no need to poll IsEnded()
+	 * on the files.
+	 * Returns: Bit mask, bit N set if file N has ended
+	 */
+	inline uint32_t TakeEndedVoices()
+	{
+		uint32_t lEndedMask = mPendingEndedMask;
+		mPendingEndedMask &= ~lEndedMask;
+		return lEndedMask;
+	}
+
+	/**
+	 * Fetch the voices that are not played because their sample rate is more
+	 * than RESAMPLE_MAX_RATIO times the output rate. They start playing if
+	 * the output rate is raised far enough.
+	 * Returns: Bit mask, bit N set if file N is not played
+	 */
+	inline uint32_t GetUnsupportedRateVoices()
+	{
+		return mUnsupportedRateMask;
+	}
+
+	/**
+	 * Set a function to be called for file events (end of file, loop wrap,
+	 * chain transition). Events are collected while a block is mixed and
+	 * delivered together right after the block is done, from whatever context
+	 * does the mixing (ContinuePlayback(), Render(), MixSamples() or the
+	 * AudioRuntime audio task). Keep the callback short, queue work for later
+	 * if needed.
+	 * Args:
+	 *   apCallback - Function to call, or nullptr to stop delivering events
+	 *   apContext - (optional) Pointer passed back to the callback
+	 */
+	void SetEventCallback(tPlayerEventCallback apCallback, void* apContext = nullptr);
+
+	/**
+	 * Fetch how many events were lost because more than
+	 * PLAYER_EVENT_QUEUE_SIZE happened during one block.
+	 */
+	inline uint32_t GetNumDroppedEvents()
+	{
+		return mNumDroppedEvents;
+	}
+
+	/**
+	 * Fetch mixing performance statistics.
+	 */
+	inline const tMixStats& GetMixStats()
+	{
+		return mMixStats;
+	}
+
+	/**
+	 * Reset all mixing performance statistics to zero.
+	 */
+	void ResetMixStats();
+
+	/**
+	 * Enable/Disable adaptive quality. When enabled, the player measures how
+	 * long each block takes to mix and steps quality down when it comes close
+	 * to the time the block takes to play:
+	 *   eeQualityReduced - Resampling picks the nearest sample instead of
+	 *                      interpolating, files skip optional processing
+	 *   eeQualityLow     - As reduced, and the voice with the lowest priority
+	 *                      (see SetVoicePriority()) is kept in time but not mixed
+	 * Quality comes back one level at a time once there is time to spare again.
+	 * Enabled by default. Disabling it goes straight back to full quality.
+	 * Args:
+	 *   aEnable - TRUE = Adapt quality, FALSE = Always full quality
+	 */
+	void SetAdaptiveQuality(bool aEnable);
+
+	/**
+	 * Fetch the quality level the player is mixing at.
+	 */
+	inline EQualityLevel GetQualityLevel()
+	{
+		return mQualityLevel;
+	}
+
+	/**
+	 * Set how important a voice is. At eeQualityLow the lowest priority voice
+	 * is dropped from the mix (the highest numbered one if several share the
+	 * lowest priority). All voices start at priority 0.
+	 * Args:
+	 *   aFileIndex - Channel of the voice
+	 *   aPriority - Higher numbers are more important
+	 */
+	void SetVoicePriority(int aFileIndex, int8_t aPriority);
+
 protected:
 
 	/**
-	 * Sets up I2S playback parameters with the hardware.
+	 * Work out which voices should be mixed and note the ones that have ended.
+	 * Only voices that changed state since the last chunk are asked whether
+	 * they are paused or ended.
+	 */
+	void UpdateActiveVoices();
+
+	/**
+	 * Look at every channel holding a file again before the next chunk is mixed.
+	 */
+	void CheckVoiceState(ISDWavFile* apWavFile);
+
+	/**
+	 * Work out how a voice has to be resampled to play at the output sample rate.
+	 * Args:
+	 *   aFileIdx - Index of the voice
+	 *   aIsRestart - TRUE if the file starts from the beginning, FALSE to keep
+	 *                the voice's position (used when the output rate changes)
 	 */
-	void Configure_I2S();
+	void ConfigureResampler(int aFileIdx, bool aIsRestart);
 
 	/**
-	 * Creates a mixed 32-bit I2S word from all opened files.
+	 * Advance a voice by a block without rendering it, keeping it in time with
+	 * the other voices.
 	 * Args:
-	 *   arSampleOut - Reference to variable to hold output
+	 *   aFileIdx - Index of the voice
+	 *   aNumSamples - How many output samples to skip
+	 */
+	void SkipVoice(int aFileIdx, int aNumSamples);
+
+	/**
+	 * Mix one block and add it to the mixing statistics. This is the common
+	 * path for ContinuePlayback() and Render().
+	 * Args:
+	 *   apBuffer - Buffer to fill with 32-bit I2S words
+	 *   aNumSamples - How many 32-bit I2S words to mix
+	 * Returns: Time taken to mix the block, not counting SD card reads
+	 *          (microseconds)
+	 */
+	unsigned long MixBlock(int32_t* apBuffer, int aNumSamples);
+
+	/**
+	 * Step quality up or down depending on how long the last block took to mix.
+	 * Time spent waiting on the SD card is left out, mixing less doesn't make
+	 * the card any faster.
+	 * Args:
+	 *   aMixMicros - Time taken to mix the last block, not counting SD card reads (microseconds)
+	 */
+	void UpdateQuality(unsigned long aMixMicros);
+
+	/**
+	 * Switch to a quality level and tell all loaded files about it.
+	 * Args:
+	 *   aLevel - New quality level
+	 */
+	void SetQualityLevel(EQualityLevel aLevel);
+
+	/**
+	 * Render the next block of a voice into maVoiceBlock, resampling if needed.
+	 * Args:
+	 *   aFileIdx - Index of the voice
+	 *   aNumSamples - How many samples to render (up to MIX_CHUNK_SIZE)
+	 * Returns: Number of samples rendered
+	 */
+	int RenderVoice(int aFileIdx, int aNumSamples);
+
+	/**
+	 * Sums a chunk of samples from every active file into maMixLeft and
+	 * maMixRight. Even numbered files are summed into the left channel and odd
+	 * numbered files into the right channel. A voice that is out of data is
+	 * removed from the active voices.
+	 * Args:
+	 *   aNumSamples - How many samples to mix (up to MIX_CHUNK_SIZE)
+	 */
+	void MixVoices(int aNumSamples);
+
+	/**
+	 * Apply all commands waiting in the command queue.
+	 */
+	void ApplyQueuedCommands();
+
+	/**
+	 * Add a command to the command queue.
+	 * Returns: TRUE if queued, FALSE if the queue was full
+	 */
+	bool QueueCommand(uint8_t aType, ISDWavFile* apWavFile, float aValue = 0.0, int aFileIndex = 0, bool aFlag = false, uint64_t aTime = 0);
+
+	/**
+	 * Put a file in a channel, without rewinding it. The file the channel
+	 * held before is released (see ReleaseWavFile()).
+	 */
+	void InstallWavFile(ISDWavFile* apWavFile, int aFileIndex, bool aIsOwned = false);
+
+	/**
+	 * Empty a channel. The file in it stops reporting events and reading ahead
+	 * for the player, and is destroyed if the player owns it.
 	 */
-	void GenerateMixedI2SSample(int32_t& arSampleOut);
+	void ReleaseWavFile(int aFileIndex);
 
 	/**
-	 * Fills the mixing buffer with data from all open files.
+	 * Find how fast a file consumes data at its current playback speed.
+	 * Returns: Bytes of file data read per second of playback
 	 */
-	int PopulateMixingBuffer();
+	uint32_t GetBytesPerSecond(ISDWavFile* apWavFile);
 
 	/**
-	 * Clips a sample to a 16-bit value. Used to compensate for overshoot
-	 * during the mixing process.
+	 * Tell the I/O scheduler about files whose playback speed has changed
+	 * since they were registered, so they are still read far enough ahead.
+	 */
+	void UpdateSchedulerRates();
+
+	/**
+	 * Drop the start waiting for a channel, if any.
+	 */
+	void CancelScheduledStart(int aFileIndex);
+
+	/**
+	 * Start the files that are scheduled to start at the current playback clock time.
 	 * Args:
-	 *   arSample - Sample to clip
+	 *   aMaxSamples - Most samples the caller wants to mix next
+	 * Returns: Number of samples (up to aMaxSamples) that can be mixed before
+	 *          the next scheduled start
 	 */
-	void ClipSample(int32_t& arSample);
+	int StartScheduledFiles(int aMaxSamples);
 
-	//Pins
+	/**
+	 * Collects events reported by the files being played.
+	 */
+	virtual void OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition);
+
+	/**
+	 * Hand the events collected during the last block to the event callback.
+	 */
+	void DeliverEvents();
+
+	/**
+	 * Fetch the output sample rate in Hz for the configured I2S speed.
+	 */
+	uint32_t GetOutputSampleRate();
+
+	/**
+	 * Fetch the output in use, creating the default I2S output if no other
+	 * output has been set.
+	 */
+	IAudioSink* GetSink();
+
+	//Pins for the default I2S output
 	int32_t mPinMCK;
 	int32_t mPinBCLK;
 	int32_t mPinLRCK;
 	int32_t mPinDIN;
 	int32_t mPinSD;
 
-	//I2S sample buffers
-	int32_t maBufferA[I2S_BUF_SIZE] = {};
-	int32_t maBufferB[I2S_BUF_SIZE] = {};
-	int32_t maMixedI2SSamples[I2S_BUF_SIZE] = {};
+	//Default output, only created when no other output is set (nullptr until then)
+	I2SAudioSink* mpI2SSink;
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	//Storage the default output is built in
+	alignas(I2SAudioSink) uint8_t maI2SSinkStorage[sizeof(I2SAudioSink)];
+#endif
+
+	//Output in use (nullptr until Init() if the default output is used)
+	IAudioSink* mpSink;
+
+	//Voice sums waiting for the master limiter
+	int32_t maMixLeft[MIX_CHUNK_SIZE];
+	int32_t maMixRight[MIX_CHUNK_SIZE];
 
-	//Keep track of if buffer A or B is selected
-	bool mBufferASelected;
+	//Samples rendered by one voice
+	int16_t maVoiceBlock[MIX_CHUNK_SIZE];
+
+	//File samples read by a voice that is being resampled. A voice can start a
+	//chunk up to two steps past its first carried sample (after running short
+	//in the last one), so there is room for two more steps than a chunk needs.
+	int16_t maResampleBlock[(MIX_CHUNK_SIZE + 2) * RESAMPLE_MAX_RATIO];
 
 	//Pointers to WAV file object to play
 	ISDWavFile* mapWavFile[MAX_WAV_FILES];
 
-	struct tDownSampleParameters
+	//TRUE for files the player destroys when it is done with them
+	bool maIsOwned[MAX_WAV_FILES];
+
+	struct tResampleParameters
+	{
+		//File samples per output sample (Q16, 0x10000 = no resampling)
+		uint32_t mStep = 0x10000;
+		//Position of the next output sample (Q16), counted in file samples
+		//from maCarry[0]
+		uint32_t mPhase = 0x10000;
+		//File samples read during the previous block that the next block
+		//still interpolates from
+		int16_t maCarry[2] = {};
+		int mNumCarry = 1;
+	};
+
+	struct tScheduledStart
 	{
-		//Keep track of if we should down-sample each wave file to
-		//meet the configured playback rate
-		bool mIsDownsample = false;
+		//File waiting to start
+		ISDWavFile* mpWavFile = nullptr;
+		//Playback clock time to start at
+		uint64_t mAtSample = 0;
+		//TRUE if the file was playing when scheduled and still has to be rewound
+		bool mIsRewindNeeded = false;
 	};
 
-	//Keep track of if we should down-sample for each wav file
+	//Starts waiting for each channel (mpWavFile is nullptr if none)
+	tScheduledStart maScheduledStarts[MAX_WAV_FILES];
+
+	//Number of channels with a start waiting
+	int mNumScheduledStarts;
+
+	//Output samples mixed since the player was created
+	uint64_t mPlaybackClock;
+
+	//Playback clock time of the first sample in the block being mixed
+	uint64_t mBlockStartClock;
+
+	//Keep track of how to resample each wav file
 	//This allows for playback of files at the proper rate even when
 	//the bit rate of the file is not the same as the native I2S playback speed
 	//of the CPU
-	tDownSampleParameters maDownsampleParams[MAX_WAV_FILES];
+	tResampleParameters maResampleParams[MAX_WAV_FILES];
 
 	//Keep track of number of samples mixed during last mixing calculation
 	int mSamplesMixed;
 
+	//Voices to mix (bit N set for file N)
+	uint32_t mActiveVoiceMask;
+
+	//Voices that are loaded, not paused and not ended (before voices are left out of the mix)
+	uint32_t mPlayingVoiceMask;
+
+	//Voices whose files changed state and have to be looked at again before the
+	//next chunk. File events can come from other tasks, so this is atomic.
+	std::atomic<uint32_t> mVoiceCheckMask;
+
+	//Voices playing but left out of the mix to save time (bit N set for file N)
+	uint32_t mDroppedVoiceMask;
+
+	//Voices left out of the mix because their sample rate is too high to resample
+	uint32_t mUnsupportedRateMask;
+
+	//Voices that have ended and were already reported
+	uint32_t mEndedSeenMask;
+
+	//Voices that have ended and were not yet taken by TakeEndedVoices()
+	uint32_t mPendingEndedMask;
+
 	//Configured sample rate
 	ESampleRate mSampleRate;
 
+	//TRUE if the sample rate changed and voices have to be resampled differently
+	volatile bool mIsRateChanged;
+
 	//Master volume control
 	float mVolume;
 
+	//Master bus volume and limiting
+	MasterLimiter mLimiter;
+
+	//Mixing performance statistics
+	tMixStats mMixStats;
+
+	//Adaptive quality state
+	bool mIsAdaptiveQuality;
+	EQualityLevel mQualityLevel;
+	//Blocks in a row mixed with time to spare
+	int mNumQuietBlocks;
+
+	//Importance of each voice when one has to be dropped
+	int8_t maVoicePriority[MAX_WAV_FILES];
+
+	//Scheduler used to read file data ahead of time (nullptr if none)
+	IOScheduler* mpIOScheduler;
+
+	//Rate each channel's file is registered with the scheduler at
+	uint32_t maBytesPerSecond[MAX_WAV_FILES];
+
+	//TRUE if the scheduler is serviced from MixSamples()
+	bool mServiceWhileMixing;
+
+	//Control calls waiting to be applied at the next block boundary
+	PlayerCommandQueue mCommandQueue;
+
+	//Events collected during the current block
+	tPlayerEvent maEvents[PLAYER_EVENT_QUEUE_SIZE];
+	int mNumEvents;
+
+	//Events lost because the event queue was full
+	uint32_t mNumDroppedEvents;
+
+	//Where events are delivered (nullptr if nowhere)
+	tPlayerEventCallback mpEventCallback;
+	void* mpEventContext;
+
+	//Index of the chunk being mixed in the current block
+	int mMixOffset;
+
 };
 
 #endif /* I2SWAVPLAYER_H_ */
@@ -0,0 +1,51 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * IAudioEffect.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _IAUDIOEFFECT_H_
+#define _IAUDIOEFFECT_H_
+
+#include <stdint.h>
+
+//Interface class for per-voice audio effects
+class IAudioEffect
+{
+public:
+	virtual ~IAudioEffect()
+	{
+		//Do nothing
+	}
+
+	/**
+	 * Process a block of samples in place.
+	 * Args:
+	 *  apBuffer - Samples to process
+	 *  aNumSamples - Number of samples in the buffer
+	 */
+	virtual void Process(int16_t* apBuffer, int aNumSamples) = 0;
+
+	/**
+	 * Clear any internal state (history, delay lines, etc.). Called when the
+	 * source jumps, for example when playback restarts.
+	 */
+	virtual void Reset() = 0;
+};
+
+#endif /* _IAUDIOEFFECT_H_ */
@@ -0,0 +1,134 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * IAudioSink.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _IAUDIOSINK_H_
+#define _IAUDIOSINK_H_
+
+#include <stdint.h>
+
+//Frames in each output buffer. One frame is a 32-bit word holding the left
+//sample in the low 16 bits and the right sample in the high 16 bits.
+#define I2S_BUF_SIZE 2048
+
+//Output sample rates
+enum ESampleRate
+{
+	ee2205,
+	ee4410,
+	ee1600,
+	ee3200,
+	ee4800
+};
+
+/**
+ * Convert an output sample rate to Hz.
+ * Args:
+ *  aSampleRate - Rate to convert (anything unknown is treated as ee2205)
+ * Returns: Sample rate in Hz
+ */
+inline uint32_t SampleRateToHz(ESampleRate aSampleRate)
+{
+	uint32_t lSampleRate = 22050;
+
+	switch(aSampleRate)
+	{
+	case ee4410:
+		lSampleRate = 44100;
+		break;
+	case ee1600:
+		lSampleRate = 16000;
+		break;
+	case ee3200:
+		lSampleRate = 32000;
+		break;
+	case ee4800:
+		lSampleRate = 48000;
+		break;
+	default:
+		break;
+	}
+
+	return lSampleRate;
+}
+
+/**
+ * Interface class for the place mixed audio goes. A sink owns a set of
+ * I2S_BUF_SIZE frame buffers. The player asks for a free one, mixes into it
+ * and hands it back, and the sink plays the buffers in the order they were
+ * handed back. Nothing here blocks, so the player never waits on the sink.
+ *
+ * Before Start() the sink hands out each of its buffers once, so the player
+ * can fill them all before output begins. Sinks that don't play in real time
+ * hand out none until they are started, and one every time after that.
+ */
+class IAudioSink
+{
+public:
+	virtual ~IAudioSink()
+	{
+		//Do nothing
+	}
+
+	/**
+	 * Set up the output hardware.
+	 * Returns: TRUE if the sink is ready to use, FALSE otherwise
+	 */
+	virtual bool Begin() = 0;
+
+	/**
+	 * Set the output sample rate. Can be called while running.
+	 * Args:
+	 *  aSampleRate - Rate to play at
+	 */
+	virtual void SetSampleRate(ESampleRate aSampleRate) = 0;
+
+	/**
+	 * Start output with the buffers filled so far.
+	 */
+	virtual void Start() = 0;
+
+	/**
+	 * Stop output. All buffers become free again.
+	 */
+	virtual void Stop() = 0;
+
+	/**
+	 * Fetch the next buffer to fill.
+	 * Returns: I2S_BUF_SIZE frame buffer, or nullptr if every buffer is
+	 *          still waiting to be played
+	 */
+	virtual int32_t* GetFreeBuffer() = 0;
+
+	/**
+	 * Hand a filled buffer back to be played.
+	 * Args:
+	 *  apBuffer - Buffer from GetFreeBuffer()
+	 */
+	virtual void SubmitBuffer(int32_t* apBuffer) = 0;
+
+	/**
+	 * Replace the sound in every buffer, including the ones waiting to be
+	 * played, with silence.
+	 */
+	virtual void Silence() = 0;
+};
+
+#endif /* _IAUDIOSINK_H_ */
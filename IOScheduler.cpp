@@ -0,0 +1,175 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * IOScheduler.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "IOScheduler.h"
+
+IOScheduler::IOScheduler()
+{
+	for(int lIdx = 0; lIdx < IO_SCHEDULER_MAX_READERS; lIdx++)
+	{
+		maReaders[lIdx].mpReader = nullptr;
+		maReaders[lIdx].mBytesPerSecond = 0;
+	}
+
+	ResetStats();
+}
+
+bool IOScheduler::Register(BufferedFileReader* apReader, uint32_t aBytesPerSecond)
+{
+	int lFreeIdx = -1;
+
+	for(int lIdx = 0; lIdx < IO_SCHEDULER_MAX_READERS; lIdx++)
+	{
+		if(apReader == maReaders[lIdx].mpReader)
+		{
+			//Already registered, just update the rate
+			maReaders[lIdx].mBytesPerSecond = aBytesPerSecond;
+			return true;
+		}
+		else if(nullptr == maReaders[lIdx].mpReader && lFreeIdx < 0)
+		{
+			lFreeIdx = lIdx;
+		}
+	}
+
+	if(lFreeIdx < 0)
+	{
+		return false;
+	}
+
+	maReaders[lFreeIdx].mpReader = apReader;
+	maReaders[lFreeIdx].mBytesPerSecond = aBytesPerSecond;
+	apReader->AttachPrefetchStorage(maPrefetchStorage[lFreeIdx], IO_SCHEDULER_PREFETCH_BLOCKS);
+
+	return true;
+}
+
+void IOScheduler::Unregister(BufferedFileReader* apReader)
+{
+	for(int lIdx = 0; lIdx < IO_SCHEDULER_MAX_READERS; lIdx++)
+	{
+		if(apReader == maReaders[lIdx].mpReader)
+		{
+			apReader->AttachPrefetchStorage(nullptr, 0);
+			maReaders[lIdx].mpReader = nullptr;
+			maReaders[lIdx].mBytesPerSecond = 0;
+		}
+	}
+}
+
+int IOScheduler::Service(uint32_t aHorizonMicros)
+{
+	//Collect the readers that are due along with their deadlines
+	int laDueIdx[IO_SCHEDULER_MAX_READERS];
+	uint32_t laDeadline[IO_SCHEDULER_MAX_READERS];
+	int lNumDue = 0;
+
+	for(int lIdx = 0; lIdx < IO_SCHEDULER_MAX_READERS; lIdx++)
+	{
+		if(nullptr != maReaders[lIdx].mpReader && maReaders[lIdx].mpReader->CanPrefetch())
+		{
+			uint32_t lDeadline = GetDeadlineMicros(maReaders[lIdx]);
+			if(IO_SCHEDULER_ALL == aHorizonMicros || lDeadline < aHorizonMicros)
+			{
+				//Insertion sort, most urgent first
+				int lPos = lNumDue;
+				while(lPos > 0 && laDeadline[lPos-1] > lDeadline)
+				{
+					laDueIdx[lPos] = laDueIdx[lPos-1];
+					laDeadline[lPos] = laDeadline[lPos-1];
+					lPos--;
+				}
+				laDueIdx[lPos] = lIdx;
+				laDeadline[lPos] = lDeadline;
+				lNumDue++;
+			}
+		}
+	}
+
+	if(0 == lNumDue)
+	{
+		return 0;
+	}
+
+	mStats.mQueueDepth = lNumDue;
+	if(lNumDue > mStats.mMaxQueueDepth)
+	{
+		mStats.mMaxQueueDepth = lNumDue;
+	}
+	mStats.mNumBursts++;
+
+	//Issue the reads in deadline order
+	int lNumReads = 0;
+	unsigned long lBurstStart = micros();
+	for(int lDueIdx = 0; lDueIdx < lNumDue; lDueIdx++)
+	{
+		BufferedFileReader* lpReader = maReaders[laDueIdx[lDueIdx]].mpReader;
+
+		long lSlack = (long)laDeadline[lDueIdx] - (long)(micros() - lBurstStart);
+		if(lSlack < mStats.mWorstSlackMicros)
+		{
+			mStats.mWorstSlackMicros = lSlack;
+		}
+
+		while(lpReader->CanPrefetch())
+		{
+			lpReader->PrefetchBlock();
+			lNumReads++;
+		}
+	}
+
+	mStats.mNumReads += lNumReads;
+
+	return lNumReads;
+}
+
+const tIOSchedulerStats& IOScheduler::GetStats()
+{
+	mStats.mNumMisses = BufferedFileReader::GetNumPrefetchMisses() - mMissesAtReset;
+	return mStats;
+}
+
+void IOScheduler::ResetStats()
+{
+	mStats.mQueueDepth = 0;
+	mStats.mMaxQueueDepth = 0;
+	mStats.mWorstSlackMicros = 0x7FFFFFFF;
+	mStats.mNumReads = 0;
+	mStats.mNumBursts = 0;
+	mStats.mNumMisses = 0;
+	mMissesAtReset = BufferedFileReader::GetNumPrefetchMisses();
+}
+
+uint32_t IOScheduler::GetDeadlineMicros(const tScheduledReader& arReader)
+{
+	if(0 == arReader.mBytesPerSecond)
+	{
+		return IO_SCHEDULER_ALL - 1;
+	}
+
+	uint64_t lDeadline = (uint64_t)arReader.mpReader->GetBufferedBytes() * 1000000 / arReader.mBytesPerSecond;
+	if(lDeadline >= IO_SCHEDULER_ALL)
+	{
+		lDeadline = IO_SCHEDULER_ALL - 1;
+	}
+
+	return (uint32_t)lDeadline;
+}
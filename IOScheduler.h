@@ -0,0 +1,143 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * IOScheduler.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _IOSCHEDULER_H_
+#define _IOSCHEDULER_H_
+
+#include <Arduino.h>
+#include "BufferedFileReader.h"
+
+//Maximum number of readers that can be registered with one scheduler
+#ifndef IO_SCHEDULER_MAX_READERS
+#define IO_SCHEDULER_MAX_READERS 8
+#endif
+
+//Number of read-ahead blocks given to each registered reader
+#ifndef IO_SCHEDULER_PREFETCH_BLOCKS
+#define IO_SCHEDULER_PREFETCH_BLOCKS 4
+#endif
+
+//Horizon meaning "fill every reader that has room"
+#define IO_SCHEDULER_ALL 0xFFFFFFFF
+
+//I/O scheduler statistics
+struct tIOSchedulerStats
+{
+	//Number of readers that needed data in the last burst
+	int mQueueDepth;
+	//Largest number of readers that needed data in a single burst
+	int mMaxQueueDepth;
+	//Smallest time left before a reader would have run dry when its read
+	//was issued (microseconds). Negative values mean data arrived late.
+	long mWorstSlackMicros;
+	//Number of blocks read ahead
+	unsigned long mNumReads;
+	//Number of bursts that issued at least one read
+	unsigned long mNumBursts;
+	//Number of times a reader ran out of read-ahead data and had to read
+	//from the SD card on demand (counted across all readers)
+	unsigned long mNumMisses;
+};
+
+/**
+ * This class coordinates SD card reads across all voices. Readers register
+ * with the scheduler and are given read-ahead storage. Each call to Service()
+ * works out how long every reader can keep going on the data it already has
+ * (its deadline, based on its playback rate) and reads blocks in deadline
+ * order, all in one burst. Call Service() once per I2S buffer, outside of the
+ * mixing loop, so the mixer itself never has to wait on the SD card.
+ */
+class IOScheduler
+{
+public:
+	/**
+	 * Constructor.
+	 */
+	IOScheduler();
+
+	/**
+	 * Register a reader and give it read-ahead storage.
+	 * Args:
+	 *  apReader - Reader to schedule
+	 *  aBytesPerSecond - How fast the reader's data is consumed during playback
+	 * Returns: TRUE if registered, FALSE if the scheduler is full
+	 */
+	bool Register(BufferedFileReader* apReader, uint32_t aBytesPerSecond);
+
+	/**
+	 * Unregister a reader and take back its read-ahead storage.
+	 * Args:
+	 *  apReader - Reader to stop scheduling
+	 */
+	void Unregister(BufferedFileReader* apReader);
+
+	/**
+	 * Issue reads, most urgent reader first. Every reader whose deadline is
+	 * inside the horizon is filled up.
+	 * Args:
+	 *  aHorizonMicros - Only service readers that would run dry within
+	 *                   this many microseconds. Defaults to all readers.
+	 * Returns: Number of blocks read
+	 */
+	int Service(uint32_t aHorizonMicros = IO_SCHEDULER_ALL);
+
+	/**
+	 * Fetch scheduler statistics.
+	 */
+	const tIOSchedulerStats& GetStats();
+
+	/**
+	 * Reset all scheduler statistics.
+	 */
+	void ResetStats();
+
+protected:
+
+	struct tScheduledReader
+	{
+		//Registered reader (nullptr if the slot is free)
+		BufferedFileReader* mpReader;
+		//How fast the reader's data is consumed
+		uint32_t mBytesPerSecond;
+	};
+
+	/**
+	 * Work out how long a reader can keep going on buffered data.
+	 * Args:
+	 *  arReader - Reader to check
+	 * Returns: Microseconds until the reader runs dry
+	 */
+	uint32_t GetDeadlineMicros(const tScheduledReader& arReader);
+
+	//Registered readers
+	tScheduledReader maReaders[IO_SCHEDULER_MAX_READERS];
+
+	//Read-ahead storage for each reader slot
+	int8_t maPrefetchStorage[IO_SCHEDULER_MAX_READERS][IO_SCHEDULER_PREFETCH_BLOCKS * DATA_BLOCK_SIZE];
+
+	//Statistics
+	tIOSchedulerStats mStats;
+
+	//Miss count when the statistics were last reset
+	unsigned long mMissesAtReset;
+};
+
+#endif /* _IOSCHEDULER_H_ */
@@ -23,6 +23,9 @@
 #define _ISDWAVFILE_H_
 
 #include <SD.h>
+#include "IWavFileEventSink.h"
+
+class IOScheduler;
 
 struct tWavFileHeader
 {
@@ -45,6 +48,38 @@ struct tWavDataHeader
     uint32_t mSize;  //Chunk data bytes
 };
 
+//Capability flags for tAudioFormat::mCapabilities
+enum EAudioCapability
+{
+	eeCapFastSeek      = 0x01, //SeekToSample() jumps directly, it doesn't read through the data
+	eeCapExactLength   = 0x02, //mNumSamples and Available() are exact
+	eeCapMemoryMapped  = 0x04, //Sample data is read straight from memory, never from the SD card
+	eeCapNativeRender  = 0x08  //Render() is implemented directly rather than on top of Fetch16BitSamples()
+};
+
+//How much processing the player can afford, from best to cheapest
+enum EQualityLevel
+{
+	eeQualityFull,    //Everything on
+	eeQualityReduced, //Cheaper resampling, optional processing skipped
+	eeQualityLow      //As reduced, and the lowest priority voice is not mixed
+};
+
+//Describes the audio a file produces
+struct tAudioFormat
+{
+	//Sample rate in Hz
+	uint32_t mSampleRate;
+	//Channels stored in the file
+	uint16_t mNumChannels;
+	//Bits per sample stored in the file (samples are always rendered as 16-bit)
+	uint16_t mBitsPerSample;
+	//Length of the sound in samples (0 if not known)
+	uint32_t mNumSamples;
+	//What the file can do (EAudioCapability flags)
+	uint32_t mCapabilities;
+};
+
 //Interface class for wav files
 class ISDWavFile
 {
@@ -82,8 +117,8 @@ public:
 	/**
 	 * Fetch how many bytes are available to be read before
 	 * the read pointer reaches the end of the file.
-	 * NOTE: This is not accurate until less then 32768 bytes
-	 * are available in the file.
+	 * NOTE: This is only guaranteed to be exact if the file
+	 * reports eeCapExactLength (see GetFormat()).
 	 *
 	 * Returns: Number of bytes left to be read
 	 */
@@ -98,6 +133,60 @@ public:
 	 */
 	virtual int Fetch16BitSamples(int16_t* apBuffer, int aNumSamples) = 0;
 
+	/**
+	 * Fetch a block of sound data. By default this is built on
+	 * Fetch16BitSamples(), files that can produce blocks faster override it.
+	 * Args:
+	 *   apBuffer - Buffer to fill with aNumFrames * aNumChannels interleaved samples
+	 *   aNumFrames - How many frames to render
+	 *   aNumChannels - (optional) Output channels, the sound is copied to each of them
+	 *   apEnded - (optional) Set to TRUE if the file has run out of data
+	 * Returns: Number of frames rendered
+	 */
+	virtual int Render(int16_t* apBuffer, int aNumFrames, int aNumChannels = 1, bool* apEnded = nullptr)
+	{
+		int lNumFrames = Fetch16BitSamples(apBuffer, aNumFrames);
+
+		//Spread the samples out, last one first so nothing is overwritten before it is copied
+		for(int lFrame = lNumFrames - 1; lFrame >= 0 && aNumChannels > 1; lFrame--)
+		{
+			for(int lChannel = aNumChannels - 1; lChannel >= 0; lChannel--)
+			{
+				apBuffer[lFrame * aNumChannels + lChannel] = apBuffer[lFrame];
+			}
+		}
+
+		if(nullptr != apEnded)
+		{
+			*apEnded = IsEnded();
+		}
+
+		return lNumFrames;
+	}
+
+	/**
+	 * Fetch a description of the audio this file produces. By default this
+	 * comes from the wav header and no capabilities are reported.
+	 */
+	virtual tAudioFormat GetFormat()
+	{
+		const tWavFileHeader& lrHeader = GetHeader();
+
+		tAudioFormat lFormat;
+		lFormat.mSampleRate = lrHeader.sampleRate;
+		lFormat.mNumChannels = lrHeader.numChannels;
+		lFormat.mBitsPerSample = lrHeader.bitsPerSample;
+		lFormat.mNumSamples = 0;
+		lFormat.mCapabilities = 0;
+
+		if(lrHeader.blockAlign > 0)
+		{
+			lFormat.mNumSamples = GetDataHeader().mSize / lrHeader.blockAlign;
+		}
+
+		return lFormat;
+	}
+
 	/**
 	 * Set the output volume. This can be used to adjust the
 	 * relative volume of each file when multiple files are played
@@ -162,6 +251,71 @@ public:
 	 */
 	virtual void Skip16BitSamples(int aNumSamples) = 0;
 
+	/**
+	 * Move the read position to any sample in the file. By default this
+	 * rewinds and skips, files that can jump straight to a sample override it.
+	 * Args:
+	 *  aSample - Sample to read next, counted from the start of the data
+	 * Returns: TRUE if successful, FALSE otherwise
+	 */
+	virtual bool SeekToSample(unsigned long aSample)
+	{
+		bool lSuccess = SeekStartOfData();
+		Skip16BitSamples(aSample);
+		return lSuccess;
+	}
+
+	/**
+	 * Register the file's read buffers with an I/O scheduler so that SD card
+	 * reads can be made ahead of time, outside of the mixing loop. Files that
+	 * don't read from an SD card can ignore this.
+	 * Args:
+	 *   apScheduler - Scheduler to register with, or nullptr to unregister
+	 *   aBytesPerSecond - How fast data will be consumed during playback
+	 */
+	virtual void SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond)
+	{
+		//Do nothing by default
+	}
+
+	/**
+	 * Fetch how fast the file moves through its data compared to normal
+	 * playback. The player uses this to tell the I/O scheduler how fast data
+	 * is consumed. Files that change their playback rate override it.
+	 * Returns: Data consumed per sample played, 1.0 = normal speed
+	 */
+	virtual float GetPlaybackSpeed()
+	{
+		return 1.0f;
+	}
+
+	/**
+	 * Set where the file reports playback events (end of file, loop wrap,
+	 * segment change). Files that report events also report
+	 * eeWavFileStateChanged whenever they are paused, unpaused, moved or
+	 * looping is changed. The player only looks at IsPaused() and IsEnded()
+	 * again after one of those, or when the file runs out of data. Files that
+	 * don't report events can ignore this.
+	 * Args:
+	 *   apSink - Receiver of the events, or nullptr to stop reporting
+	 */
+	virtual void SetEventSink(IWavFileEventSink* apSink)
+	{
+		//Do nothing by default
+	}
+
+	/**
+	 * Tell the file how much processing the player can afford right now. Files
+	 * with optional processing can skip it below eeQualityFull to save time.
+	 * Files without any can ignore this.
+	 * Args:
+	 *   aLevel - Quality level the player is mixing at
+	 */
+	virtual void SetQuality(EQualityLevel aLevel)
+	{
+		//Do nothing by default
+	}
+
 };
 
 #endif /* _ISDWAVFILE_H_ */
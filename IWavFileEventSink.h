@@ -0,0 +1,56 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * IWavFileEventSink.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _IWAVFILEEVENTSINK_H_
+#define _IWAVFILEEVENTSINK_H_
+
+class ISDWavFile;
+
+//Things that can happen to a wav file during playback
+enum EWavFileEvent
+{
+	eeWavFileEnded,         //Ran out of data (not looping)
+	eeWavFileLooped,        //Wrapped from the end back to the start
+	eeWavFileSegmentChanged,//Moved on to the next part of a multi-part file (e.g. a chain)
+	eeWavFileStateChanged   //Paused, unpaused, moved or looping changed, so it may start or stop playing
+};
+
+//Interface class for receiving wav file events
+class IWavFileEventSink
+{
+public:
+	virtual ~IWavFileEventSink()
+	{
+		//Do nothing
+	}
+
+	/**
+	 * Called by a wav file when something happens during playback. This is
+	 * called from inside Fetch16BitSamples()/Skip16BitSamples(), so keep it short.
+	 * Args:
+	 *  apSource - File the event happened to
+	 *  aEvent - What happened
+	 *  aSamplePosition - Samples read from the file's data when the event happened
+	 */
+	virtual void OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition) = 0;
+};
+
+#endif /* _IWAVFILEEVENTSINK_H_ */
@@ -0,0 +1,360 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * MappedWavFile.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "MappedWavFile.h"
+
+#define RIFF_HEADER_SIZE 12 //"RIFF", chunk size, "WAVE"
+#define DEPOP_END_SAMPLES 512 //How many samples to use in dynamic de-popping at the end of a file
+#define DEPOP_START_SAMPLES 32 //How many samples to use in dynamic de-popping at the start of a file
+
+MappedWavFile::MappedWavFile(const uint8_t* apWavData, uint32_t aSize)
+{
+	mVolume = 1.0;
+	mIsLooping = false;
+	mIsPaused = false;
+	mLastSample = 0;
+	mSamplesRead = 0;
+	mDepopStart = true;
+	mDepopEnd = true;
+	mpEventSink = nullptr;
+
+	Open(apWavData, aSize);
+}
+
+MappedWavFile::MappedWavFile(const uint8_t* apImage, uint32_t aImageSize, const char* apName)
+{
+	mVolume = 1.0;
+	mIsLooping = false;
+	mIsPaused = false;
+	mLastSample = 0;
+	mSamplesRead = 0;
+	mDepopStart = true;
+	mDepopEnd = true;
+	mpEventSink = nullptr;
+
+	const uint8_t* lpWavData = nullptr;
+	uint32_t lSize = 0;
+	FindInImage(apImage, aImageSize, apName, lpWavData, lSize);
+
+	Open(lpWavData, lSize);
+}
+
+MappedWavFile::~MappedWavFile()
+{
+	//Nothing to do, the mapped data is not owned by this object
+}
+
+bool MappedWavFile::FindInImage(const uint8_t* apImage,
+								uint32_t aImageSize,
+								const char* apName,
+								const uint8_t*& arpWavData,
+								uint32_t& arSize)
+{
+	if(nullptr == apImage || aImageSize < sizeof(tMappedWavImageHeader))
+	{
+		return false;
+	}
+
+	tMappedWavImageHeader lImageHeader;
+	memcpy(&lImageHeader, apImage, sizeof(tMappedWavImageHeader));
+
+	if(0 != memcmp(lImageHeader.mMagic, "NWAV", 4))
+	{
+		return false;
+	}
+
+	//Blank or corrupt flash can claim any number of entries
+	uint32_t lMaxEntries = (aImageSize - sizeof(tMappedWavImageHeader)) / sizeof(tMappedWavImageEntry);
+	if(lImageHeader.mNumEntries > lMaxEntries)
+	{
+		return false;
+	}
+
+	const uint8_t* lpEntryPtr = apImage + sizeof(tMappedWavImageHeader);
+	for(uint32_t lIdx = 0; lIdx < lImageHeader.mNumEntries; lIdx++)
+	{
+		tMappedWavImageEntry lEntry;
+		memcpy(&lEntry, lpEntryPtr, sizeof(tMappedWavImageEntry));
+		lpEntryPtr += sizeof(tMappedWavImageEntry);
+
+		if(0 == strncmp(lEntry.mName, apName, MAPPED_WAV_NAME_SIZE))
+		{
+			//The whole file has to be inside the image
+			if(lEntry.mOffset > aImageSize || lEntry.mSize > aImageSize - lEntry.mOffset)
+			{
+				return false;
+			}
+
+			arpWavData = apImage + lEntry.mOffset;
+			arSize = lEntry.mSize;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void MappedWavFile::Open(const uint8_t* apWavData, uint32_t aSize)
+{
+	memset(&mHeader, 0, sizeof(tWavFileHeader));
+	memset(&mDataHeader, 0, sizeof(tWavDataHeader));
+	mpData = nullptr;
+	mDataSize = 0;
+	mReadPos = 0;
+
+	if(nullptr == apWavData || aSize < sizeof(tWavFileHeader))
+	{
+		return;
+	}
+
+	memcpy(&mHeader, apWavData, sizeof(tWavFileHeader));
+
+	//Walk the chunks after the RIFF header until the data block is found
+	uint32_t lChunkPos = RIFF_HEADER_SIZE;
+	while(lChunkPos + sizeof(tWavDataHeader) <= aSize)
+	{
+		tWavDataHeader lChunkHeader;
+		memcpy(&lChunkHeader, apWavData + lChunkPos, sizeof(tWavDataHeader));
+		lChunkPos += sizeof(tWavDataHeader);
+
+		if(0 == memcmp(lChunkHeader.mID, "data", 4))
+		{
+			mDataHeader = lChunkHeader;
+			mpData = apWavData + lChunkPos;
+
+			//Don't trust the chunk size further than the mapped data goes
+			mDataSize = lChunkHeader.mSize;
+			if(mDataSize > aSize - lChunkPos)
+			{
+				mDataSize = aSize - lChunkPos;
+			}
+			break;
+		}
+
+		//Chunks are padded to an even number of bytes
+		lChunkPos += lChunkHeader.mSize + (lChunkHeader.mSize & 1);
+	}
+}
+
+void MappedWavFile::Close()
+{
+	mReadPos = mDataSize;
+	mIsLooping = false;
+}
+
+File& MappedWavFile::GetFileHandle()
+{
+	return mNullFileHandle;
+}
+
+const tWavFileHeader& MappedWavFile::GetHeader()
+{
+	return mHeader;
+}
+
+const tWavDataHeader& MappedWavFile::GetDataHeader()
+{
+	return mDataHeader;
+}
+
+bool MappedWavFile::SeekStartOfData()
+{
+	mReadPos = 0;
+	mSamplesRead = 0;
+	ReportEvent(eeWavFileStateChanged, 0);
+
+	return (nullptr != mpData);
+}
+
+int MappedWavFile::Available()
+{
+	return mDataSize - mReadPos;
+}
+
+int MappedWavFile::Fetch16BitSamples(int16_t* apBuffer, int aNumSamples)
+{
+	int lSampleIndex = 0;
+	for(lSampleIndex = 0;
+		lSampleIndex < aNumSamples && mReadPos + sizeof(int16_t) <= mDataSize;
+		lSampleIndex++)
+	{
+		//Mapped data is not guaranteed to be aligned, so copy rather than dereference
+		memcpy(&apBuffer[lSampleIndex], mpData + mReadPos, sizeof(int16_t));
+		mReadPos += sizeof(int16_t);
+
+		//Apply volume by reducing the amplitude of each sample
+		if(mVolume < 1.0 && mVolume >= 0.0)
+		{
+			apBuffer[lSampleIndex] = apBuffer[lSampleIndex] * mVolume;
+		}
+
+		//De-pop start of playback by averaging the first few samples
+		if(mDepopStart && mSamplesRead < DEPOP_START_SAMPLES)
+		{
+			apBuffer[lSampleIndex] = (apBuffer[lSampleIndex] + mLastSample) / 2;
+		}
+
+		//De-pop end of playback by ramping down volume
+		uint32_t lRemaining = mDataSize - mReadPos;
+		uint32_t lSamplesLeft = lRemaining / sizeof(int16_t);
+		if(mDepopEnd && lSamplesLeft < DEPOP_END_SAMPLES)
+		{
+			float lDePopMultiplier = (float)lSamplesLeft / DEPOP_END_SAMPLES;
+
+			apBuffer[lSampleIndex] *= lDePopMultiplier;
+		}
+
+		mSamplesRead++;
+		mLastSample = apBuffer[lSampleIndex];
+
+		//If we ran out of data, check if we should loop back to the start
+		if(lRemaining < sizeof(int16_t))
+		{
+			if(true == mIsLooping)
+			{
+				ReportEvent(eeWavFileLooped, mSamplesRead);
+				SeekStartOfData();
+			}
+			else
+			{
+				ReportEvent(eeWavFileEnded, mSamplesRead);
+			}
+		}
+	}
+
+	return lSampleIndex;
+}
+
+void MappedWavFile::SetVolume(float aVolume)
+{
+	if(aVolume <= 0.0)
+	{
+		mVolume = 0.0;
+	}
+	else if(aVolume >= 1.0)
+	{
+		mVolume = 1.0;
+	}
+	else
+	{
+		mVolume = aVolume;
+	}
+}
+
+void MappedWavFile::SetLooping(bool aLoopingEnable)
+{
+	mIsLooping = aLoopingEnable;
+	ReportEvent(eeWavFileStateChanged, mSamplesRead);
+}
+
+void MappedWavFile::Pause()
+{
+	mIsPaused = true;
+	ReportEvent(eeWavFileStateChanged, mSamplesRead);
+}
+
+bool MappedWavFile::IsPaused()
+{
+	return mIsPaused;
+}
+
+void MappedWavFile::UnPause()
+{
+	mIsPaused = false;
+	ReportEvent(eeWavFileStateChanged, mSamplesRead);
+}
+
+bool MappedWavFile::IsEnded()
+{
+	return (mReadPos + sizeof(int16_t) > mDataSize && !mIsLooping);
+}
+
+void MappedWavFile::SetDePop(bool aStart, bool aEnd)
+{
+	mDepopStart = aStart;
+	mDepopEnd = aEnd;
+}
+
+void MappedWavFile::Skip16BitSamples(int aNumSamples)
+{
+	uint32_t lNewPos = mReadPos + aNumSamples * sizeof(int16_t);
+
+	if(lNewPos >= mDataSize)
+	{
+		//Position of the end of the data, relative to the samples read so far
+		unsigned long lEndPosition = mSamplesRead + (mDataSize - mReadPos) / sizeof(int16_t);
+
+		if(mIsLooping && mDataSize > 0)
+		{
+			ReportEvent(eeWavFileLooped, lEndPosition);
+			lNewPos %= mDataSize;
+		}
+		else
+		{
+			//Only report the end once
+			if(mReadPos < mDataSize)
+			{
+				ReportEvent(eeWavFileEnded, lEndPosition);
+			}
+			lNewPos = mDataSize;
+		}
+	}
+
+	mReadPos = lNewPos;
+	mSamplesRead += aNumSamples;
+}
+
+bool MappedWavFile::SeekToSample(unsigned long aSample)
+{
+	uint32_t lNumSamples = mDataSize / sizeof(int16_t);
+	if(aSample > lNumSamples)
+	{
+		aSample = lNumSamples;
+	}
+
+	mReadPos = aSample * sizeof(int16_t);
+	mSamplesRead = aSample;
+	ReportEvent(eeWavFileStateChanged, aSample);
+
+	return (nullptr != mpData);
+}
+
+tAudioFormat MappedWavFile::GetFormat()
+{
+	tAudioFormat lFormat = ISDWavFile::GetFormat();
+	lFormat.mNumSamples = mDataSize / sizeof(int16_t);
+	lFormat.mCapabilities = eeCapFastSeek | eeCapExactLength | eeCapMemoryMapped;
+
+	return lFormat;
+}
+
+void MappedWavFile::SetEventSink(IWavFileEventSink* apSink)
+{
+	mpEventSink = apSink;
+}
+
+void MappedWavFile::ReportEvent(EWavFileEvent aEvent, unsigned long aSamplePosition)
+{
+	if(nullptr != mpEventSink)
+	{
+		mpEventSink->OnWavFileEvent(this, aEvent, aSamplePosition);
+	}
+}
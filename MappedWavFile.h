@@ -0,0 +1,276 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * MappedWavFile.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _MAPPEDWAVFILE_H_
+#define _MAPPEDWAVFILE_H_
+
+#include <Arduino.h>
+#include "ISDWavFile.h"
+
+//Start of the memory-mapped (XIP) QSPI flash region on the nRF52840
+#define MAPPED_WAV_QSPI_XIP_BASE 0x12000000
+
+//Maximum length of a file name stored in a packed wav image (including terminator)
+#define MAPPED_WAV_NAME_SIZE 24
+
+//Header at the start of a packed wav image (see extras/pack_wav_image.py)
+struct tMappedWavImageHeader
+{
+	char mMagic[4];        //"NWAV"
+	uint32_t mNumEntries;  //Number of tMappedWavImageEntry records that follow
+};
+
+//Index entry for one wav file in a packed wav image
+struct tMappedWavImageEntry
+{
+	char mName[MAPPED_WAV_NAME_SIZE]; //Null terminated file name
+	uint32_t mOffset;                 //Byte offset of the wav file from the start of the image
+	uint32_t mSize;                   //Size of the wav file in bytes
+};
+
+/**
+ * This class plays a wav file directly out of memory-mapped storage, such as
+ * the nRF52840's QSPI flash in XIP mode. Samples are read straight from the
+ * mapped region so there is no buffering or copying and no SD card access.
+ * Any pointer will do, so on a host machine the same class can play a file
+ * that was mapped with mmap().
+ */
+class MappedWavFile : public ISDWavFile
+{
+public:
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apWavData - Pointer to the start of a complete wav file (including header)
+	 *  aSize - Size of the wav file in bytes
+	 */
+	MappedWavFile(const uint8_t* apWavData, uint32_t aSize);
+
+	/**
+	 * Constructor. Looks up a file in a packed wav image.
+	 * Args:
+	 *  apImage - Pointer to the start of a packed wav image
+	 *  aImageSize - Size of the image in bytes (or of the memory it is in)
+	 *  apName - Name of the file to play, as stored in the image
+	 */
+	MappedWavFile(const uint8_t* apImage, uint32_t aImageSize, const char* apName);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~MappedWavFile();
+
+	/**
+	 * Finds a file in a packed wav image. Nothing outside of aImageSize bytes
+	 * is read, and files whose data would run past the end aren't found.
+	 * Args:
+	 *  apImage - Pointer to the start of a packed wav image
+	 *  aImageSize - Size of the image in bytes (or of the memory it is in)
+	 *  apName - Name of the file to find
+	 *  arpWavData - Set to point at the wav file if found
+	 *  arSize - Set to the size of the wav file if found
+	 * Returns: TRUE if the file was found, FALSE otherwise
+	 */
+	static bool FindInImage(const uint8_t* apImage,
+							uint32_t aImageSize,
+							const char* apName,
+							const uint8_t*& arpWavData,
+							uint32_t& arSize);
+
+	/**
+	 * Close the file. There is no handle to release, this just stops playback.
+	 */
+	virtual void Close();
+
+	/**
+	 * There is no SD file behind mapped data, so this returns a handle
+	 * that is never open.
+	 */
+	virtual File& GetFileHandle();
+
+	/**
+	 * Fetch basic file header
+	 */
+	virtual const tWavFileHeader& GetHeader();
+
+	/**
+	 * Fetch header for the data block
+	 */
+	virtual const tWavDataHeader& GetDataHeader();
+
+	/**
+	 * Force the read pointer to the start of the data block
+	 */
+	virtual bool SeekStartOfData();
+
+	/**
+	 * Fetch how many bytes are available to be read before
+	 * the read pointer reaches the end of the data block.
+	 * Unlike SD files this is always accurate.
+	 *
+	 * Returns: Number of bytes left to be read
+	 */
+	virtual int Available();
+
+	/**
+	 * Fetch the sound data as 16-bit samples
+	 * Args:
+	 *   apBuffer - Pointer to buffer to fill with data
+	 *   aNumSamples - How many samples to read
+	 * Returns: Number of samples filled
+	 */
+	virtual int Fetch16BitSamples(int16_t* apBuffer, int aNumSamples);
+
+	/**
+	 * Set the output volume.
+	 * Args:
+	 *   aVolume - Any value between 1.0 (max) and 0.0 (mute)
+	 */
+	virtual void SetVolume(float aVolume);
+
+	/**
+	 * Enable/Disable looping.
+	 * Args:
+	 *   aLoopingEnable - TRUE = Do looping, FALSE = Play once, no looping
+	 */
+	virtual void SetLooping(bool aLoopingEnable);
+
+	/**
+	 * Sets the paused flag. See IsPaused().
+	 */
+	virtual void Pause();
+
+	/**
+	 * Check if this file is paused.
+	 *
+	 * Return: TRUE if paused, FALSE otherwise
+	 */
+	virtual bool IsPaused();
+
+	/**
+	 * Clears the paused flag. See IsPaused().
+	 */
+	virtual void UnPause();
+
+	/**
+	 * Check if file has run out of data.
+	 * NOTE: This will always be false if looping is enabled.
+	 * Returns: TRUE if file has run out of data, FALSE otherwise.
+	 */
+	virtual bool IsEnded();
+
+	/**
+	 * Enable/Disable the De-pop algorithm. See SDWavFile::SetDePop().
+	 * Args:
+	 *   aStart - TRUE= Enable for start of file, FALSE = disabled
+	 *   aEnd - TRUE = Enable for end of file, FALSE = disabled
+	 */
+	virtual void SetDePop(bool aStart, bool aEnd);
+
+	/**
+	 * Skips samples. The read pointer is moved directly, no data is read.
+	 * Args:
+	 *  aNumSamples - Number of 16-bit samples to skip.
+	 */
+	virtual void Skip16BitSamples(int aNumSamples);
+
+	/**
+	 * Move the read pointer to any sample in the data block.
+	 * Args:
+	 *  aSample - Sample to read next, counted from the start of the data
+	 * Returns: TRUE if there is data to read, FALSE otherwise
+	 */
+	virtual bool SeekToSample(unsigned long aSample);
+
+	/**
+	 * Fetch a description of the audio. Mapped files are read straight from
+	 * memory, can seek directly and know their exact length.
+	 */
+	virtual tAudioFormat GetFormat();
+
+	/**
+	 * Set where the file reports end of file and loop wrap events.
+	 * Args:
+	 *   apSink - Receiver of the events, or nullptr to stop reporting
+	 */
+	virtual void SetEventSink(IWavFileEventSink* apSink);
+
+protected:
+
+	/**
+	 * Parses the wav headers and locates the data block.
+	 * Args:
+	 *  apWavData - Pointer to the start of a complete wav file
+	 *  aSize - Size of the wav file in bytes
+	 */
+	void Open(const uint8_t* apWavData, uint32_t aSize);
+
+	/**
+	 * Send an event to the event sink, if there is one.
+	 * Args:
+	 *  aEvent - Event to report
+	 *  aSamplePosition - Samples read when the event happened
+	 */
+	void ReportEvent(EWavFileEvent aEvent, unsigned long aSamplePosition);
+
+	//Wav file header data
+	tWavFileHeader mHeader;
+	//Data block header
+	tWavDataHeader mDataHeader;
+
+	//Handle returned by GetFileHandle(), never opened
+	File mNullFileHandle;
+
+	//Start of the sample data
+	const uint8_t* mpData;
+
+	//Size of the sample data in bytes
+	uint32_t mDataSize;
+
+	//Current read position, in bytes from the start of the sample data
+	uint32_t mReadPos;
+
+	//Volume (0.0 to 1.0)
+	float mVolume;
+
+	//Looping flag
+	bool mIsLooping;
+
+	//Paused flag
+	bool mIsPaused;
+
+	//Last fetched sample
+	int16_t mLastSample;
+
+	//Keep track of how many samples were read
+	unsigned long mSamplesRead;
+
+	//Apply de-pop to start of file
+	bool mDepopStart;
+
+	//Apply de-pop to end of file
+	bool mDepopEnd;
+
+	//Receiver of playback events (nullptr if none)
+	IWavFileEventSink* mpEventSink;
+};
+
+#endif /* _MAPPEDWAVFILE_H_ */
@@ -0,0 +1,208 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * MasterLimiter.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "MasterLimiter.h"
+
+MasterLimiter::MasterLimiter()
+{
+	mGain = LIMITER_UNITY_GAIN;
+	mThreshold = LIMITER_DEFAULT_THRESHOLD;
+	mIsEnabled = true;
+
+	Reset();
+}
+
+void MasterLimiter::SetGain(float aGain)
+{
+	if(aGain <= 0.0)
+	{
+		mGain = 0;
+	}
+	else if(aGain >= 1.0)
+	{
+		mGain = LIMITER_UNITY_GAIN;
+	}
+	else
+	{
+		mGain = aGain * LIMITER_UNITY_GAIN;
+	}
+}
+
+void MasterLimiter::SetEnabled(bool aEnable)
+{
+	mIsEnabled = aEnable;
+}
+
+void MasterLimiter::SetThreshold(int32_t aThreshold)
+{
+	if(aThreshold < 1)
+	{
+		aThreshold = 1;
+	}
+	else if(aThreshold > LIMITER_CEILING)
+	{
+		aThreshold = LIMITER_CEILING;
+	}
+
+	mThreshold = aThreshold;
+}
+
+void MasterLimiter::Reset()
+{
+	mLimitGain = LIMITER_UNITY_GAIN;
+	mDelayHead = 0;
+
+	for(int lIdx = 0; lIdx < LIMITER_LOOKAHEAD * 2; lIdx++)
+	{
+		maDelayLeft[lIdx] = 0;
+		maDelayRight[lIdx] = 0;
+	}
+}
+
+void MasterLimiter::Process(int32_t* apLeft, int32_t* apRight, int32_t* apOut, int aNumSamples)
+{
+	//Look-ahead only covers LIMITER_LOOKAHEAD samples, so work in blocks no bigger than that
+	for(int lStart = 0; lStart < aNumSamples; lStart += LIMITER_LOOKAHEAD)
+	{
+		int lNumSamples = aNumSamples - lStart;
+		if(lNumSamples > LIMITER_LOOKAHEAD)
+		{
+			lNumSamples = LIMITER_LOOKAHEAD;
+		}
+
+		ProcessBlock(&apLeft[lStart], &apRight[lStart], &apOut[lStart], lNumSamples);
+	}
+}
+
+void MasterLimiter::ProcessBlock(int32_t* apLeft, int32_t* apRight, int32_t* apOut, int aNumSamples)
+{
+	const int lMask = LIMITER_LOOKAHEAD * 2 - 1;
+
+	//Master gain first, so limiting works on what will actually be heard
+	for(int lIdx = 0; lIdx < aNumSamples; lIdx++)
+	{
+		int lPos = (mDelayHead + LIMITER_LOOKAHEAD + lIdx) & lMask;
+		maDelayLeft[lPos] = ((int64_t)apLeft[lIdx] * mGain) >> 15;
+		maDelayRight[lPos] = ((int64_t)apRight[lIdx] * mGain) >> 15;
+	}
+
+	//Peak of the samples about to go out and the look-ahead behind them
+	int32_t lPeak = 0;
+	for(int lIdx = 0; lIdx < LIMITER_LOOKAHEAD + aNumSamples; lIdx++)
+	{
+		int lPos = (mDelayHead + lIdx) & lMask;
+		int32_t lAbsLeft = maDelayLeft[lPos] < 0 ? -maDelayLeft[lPos] : maDelayLeft[lPos];
+		int32_t lAbsRight = maDelayRight[lPos] < 0 ? -maDelayRight[lPos] : maDelayRight[lPos];
+		if(lAbsLeft > lPeak)
+		{
+			lPeak = lAbsLeft;
+		}
+		if(lAbsRight > lPeak)
+		{
+			lPeak = lAbsRight;
+		}
+	}
+
+	//Gain at the end of this block. Drop straight to what the peak needs,
+	//but only recover a little at a time so the limiter doesn't pump.
+	int32_t lEndGain = LIMITER_UNITY_GAIN;
+	if(mIsEnabled)
+	{
+		int32_t lTargetGain = CalculateLimitGain(lPeak);
+		if(lTargetGain < mLimitGain)
+		{
+			lEndGain = lTargetGain;
+		}
+		else
+		{
+			lEndGain = mLimitGain + ((lTargetGain - mLimitGain) >> LIMITER_RELEASE_SHIFT);
+		}
+	}
+
+	//Ramp the gain across the block to avoid steps. The gain at both ends is
+	//low enough for every sample going out, so every step in between is too.
+	int32_t lGainStep = (lEndGain - mLimitGain) / aNumSamples;
+	int32_t lGain = mLimitGain;
+
+	//With no gain reduction at either end the samples go out as they are
+	bool lIsBypassed = (LIMITER_UNITY_GAIN == mLimitGain && LIMITER_UNITY_GAIN == lEndGain);
+
+	for(int lIdx = 0; lIdx < aNumSamples; lIdx++)
+	{
+		int lPos = (mDelayHead + lIdx) & lMask;
+		int32_t lLeft = maDelayLeft[lPos];
+		int32_t lRight = maDelayRight[lPos];
+
+		if(!lIsBypassed)
+		{
+			lGain += lGainStep;
+			if(lIdx == aNumSamples - 1)
+			{
+				lGain = lEndGain;
+			}
+
+			lLeft = ((int64_t)lLeft * lGain) >> 15;
+			lRight = ((int64_t)lRight * lGain) >> 15;
+		}
+
+		//Only needed when limiting is disabled
+		if(lLeft > INT16_MAX)
+		{
+			lLeft = INT16_MAX;
+		}
+		else if(lLeft < INT16_MIN)
+		{
+			lLeft = INT16_MIN;
+		}
+		if(lRight > INT16_MAX)
+		{
+			lRight = INT16_MAX;
+		}
+		else if(lRight < INT16_MIN)
+		{
+			lRight = INT16_MIN;
+		}
+
+		//Left channel in the low 16 bits, right channel in the high 16 bits
+		apOut[lIdx] = (int32_t)(((uint32_t)(uint16_t)lRight << 16) | (uint16_t)lLeft);
+	}
+
+	mDelayHead = (mDelayHead + aNumSamples) & lMask;
+	mLimitGain = lEndGain;
+}
+
+int32_t MasterLimiter::CalculateLimitGain(int32_t aPeak)
+{
+	if(aPeak <= mThreshold)
+	{
+		return LIMITER_UNITY_GAIN;
+	}
+
+	//Soft knee: the part of the peak over the threshold is squeezed into the
+	//space between the threshold and the ceiling, approaching the ceiling
+	//but never reaching it
+	int32_t lOver = aPeak - mThreshold;
+	int32_t lRoom = LIMITER_CEILING - mThreshold;
+	int32_t lLimitedPeak = mThreshold + (int32_t)(((int64_t)lOver * lRoom) / (lOver + lRoom));
+
+	return (int32_t)(((int64_t)lLimitedPeak << 15) / aPeak);
+}
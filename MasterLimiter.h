@@ -0,0 +1,147 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * MasterLimiter.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _MASTERLIMITER_H_
+#define _MASTERLIMITER_H_
+
+#include <stdint.h>
+
+//Unity gain in the limiter's Q15 gain format
+#define LIMITER_UNITY_GAIN 32768
+
+//Default level where gain reduction starts (about -2.5 dBFS)
+#define LIMITER_DEFAULT_THRESHOLD 24576
+
+//Level the output can approach but never exceed
+#define LIMITER_CEILING 32767
+
+//How many samples the output is delayed so the limiter can see peaks coming
+//(must be a power of 2)
+#define LIMITER_LOOKAHEAD 32
+
+//Each block, gain recovers 1/(2^LIMITER_RELEASE_SHIFT) of the way back up
+#define LIMITER_RELEASE_SHIFT 4
+
+/**
+ * Master bus gain and limiter. Takes the raw 32-bit sums of all voices, applies
+ * the master volume first and then a soft-knee peak limiter so that loud
+ * mixes are squeezed below full scale instead of being hard clipped.
+ *
+ * The output is delayed by LIMITER_LOOKAHEAD samples. Gain reduction is worked
+ * out once per block from the peak of everything waiting in the delay, so the
+ * gain is already down by the time a peak comes out. Gain moves to its new
+ * value over the course of the block and recovers slowly over the following
+ * blocks. Left and right share one gain so the stereo image doesn't shift.
+ * All processing is fixed point.
+ *
+ * While there is no gain reduction the limiter is bypassed: the output is the
+ * input times the master gain (Q15), delayed by LIMITER_LOOKAHEAD samples. It
+ * is only the unchanged voice sum at full volume.
+ */
+class MasterLimiter
+{
+public:
+	/**
+	 * Constructor.
+	 */
+	MasterLimiter();
+
+	/**
+	 * Set the master gain applied before limiting.
+	 * Args:
+	 *  aGain - Any value between 0.0 (mute) and 1.0 (full volume)
+	 */
+	void SetGain(float aGain);
+
+	/**
+	 * Enable/Disable limiting. When disabled, the output is hard clipped.
+	 * Args:
+	 *  aEnable - TRUE to limit, FALSE to hard clip
+	 */
+	void SetEnabled(bool aEnable);
+
+	/**
+	 * Set the level where gain reduction starts.
+	 * Args:
+	 *  aThreshold - Level between 1 and LIMITER_CEILING
+	 */
+	void SetThreshold(int32_t aThreshold);
+
+	/**
+	 * Apply gain and limiting to a block and pack it into 32-bit I2S words.
+	 * Args:
+	 *  apLeft - Left channel sums, overwritten while processing
+	 *  apRight - Right channel sums, overwritten while processing
+	 *  apOut - Buffer to fill with 32-bit I2S words (16-bit left and right samples)
+	 *  aNumSamples - Number of samples in each buffer
+	 */
+	void Process(int32_t* apLeft, int32_t* apRight, int32_t* apOut, int aNumSamples);
+
+	/**
+	 * Return to unity gain reduction and clear the delay.
+	 */
+	void Reset();
+
+	/**
+	 * Fetch the current gain reduction (Q15, LIMITER_UNITY_GAIN = no reduction).
+	 */
+	inline int32_t GetGainReduction()
+	{
+		return mLimitGain;
+	}
+
+protected:
+
+	/**
+	 * Process up to LIMITER_LOOKAHEAD samples.
+	 * Args: See Process()
+	 */
+	void ProcessBlock(int32_t* apLeft, int32_t* apRight, int32_t* apOut, int aNumSamples);
+
+	/**
+	 * Work out the gain that brings a peak under the ceiling with a soft knee.
+	 * Args:
+	 *  aPeak - Peak level of the block after master gain
+	 * Returns: Gain to apply (Q15)
+	 */
+	int32_t CalculateLimitGain(int32_t aPeak);
+
+	//Master gain (Q15)
+	int32_t mGain;
+
+	//Gain reduction currently applied (Q15)
+	int32_t mLimitGain;
+
+	//Level where gain reduction starts
+	int32_t mThreshold;
+
+	//TRUE if limiting is enabled
+	bool mIsEnabled;
+
+	//Delay line holding samples (after master gain) waiting to be output
+	int32_t maDelayLeft[LIMITER_LOOKAHEAD * 2];
+	int32_t maDelayRight[LIMITER_LOOKAHEAD * 2];
+
+	//Position of the oldest sample in the delay line
+	int mDelayHead;
+};
+
+#endif /* _MASTERLIMITER_H_ */
@@ -0,0 +1,71 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * NullAudioSink.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "NullAudioSink.h"
+
+NullAudioSink::NullAudioSink()
+{
+	mNumFrames = 0;
+	mSampleRate = ee2205;
+	mIsRunning = false;
+}
+
+NullAudioSink::~NullAudioSink()
+{
+	//Nothing to do
+}
+
+bool NullAudioSink::Begin()
+{
+	return true;
+}
+
+void NullAudioSink::SetSampleRate(ESampleRate aSampleRate)
+{
+	mSampleRate = aSampleRate;
+}
+
+void NullAudioSink::Start()
+{
+	mNumFrames = 0;
+	mIsRunning = true;
+}
+
+void NullAudioSink::Stop()
+{
+	mIsRunning = false;
+}
+
+int32_t* NullAudioSink::GetFreeBuffer()
+{
+	return mIsRunning ? maBuffer : nullptr;
+}
+
+void NullAudioSink::SubmitBuffer(int32_t* apBuffer)
+{
+	mNumFrames += I2S_BUF_SIZE;
+}
+
+void NullAudioSink::Silence()
+{
+	//Nothing is kept
+}
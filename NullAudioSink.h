@@ -0,0 +1,111 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * NullAudioSink.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _NULLAUDIOSINK_H_
+#define _NULLAUDIOSINK_H_
+
+#include "IAudioSink.h"
+
+/**
+ * Throws the mixed audio away. Once started it always has a free buffer, so
+ * every ContinuePlayback() call mixes a block. Use it to measure how fast the
+ * mixer runs without being held back by real-time output.
+ */
+class NullAudioSink : public IAudioSink
+{
+public:
+	/**
+	 * Constructor.
+	 */
+	NullAudioSink();
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~NullAudioSink();
+
+	/**
+	 * Nothing to set up.
+	 */
+	virtual bool Begin();
+
+	/**
+	 * Remember the sample rate.
+	 */
+	virtual void SetSampleRate(ESampleRate aSampleRate);
+
+	/**
+	 * Start taking buffers.
+	 */
+	virtual void Start();
+
+	/**
+	 * Stop taking buffers.
+	 */
+	virtual void Stop();
+
+	/**
+	 * Fetch the buffer, always free while started.
+	 */
+	virtual int32_t* GetFreeBuffer();
+
+	/**
+	 * Count the buffer's frames and drop it.
+	 */
+	virtual void SubmitBuffer(int32_t* apBuffer);
+
+	/**
+	 * Nothing to do, nothing is kept.
+	 */
+	virtual void Silence();
+
+	/**
+	 * Fetch how many frames have been handed to the sink since it was started.
+	 */
+	inline uint32_t GetNumFrames()
+	{
+		return mNumFrames;
+	}
+
+	/**
+	 * Fetch how long the frames handed to the sink would take to play (ms).
+	 */
+	inline uint32_t GetPlayedMillis()
+	{
+		return (uint64_t)mNumFrames * 1000 / SampleRateToHz(mSampleRate);
+	}
+
+protected:
+
+	//The only buffer
+	int32_t maBuffer[I2S_BUF_SIZE];
+
+	//Frames handed over since the sink was started
+	uint32_t mNumFrames;
+
+	//Rate the frames are meant to play at
+	ESampleRate mSampleRate;
+
+	//TRUE while started
+	bool mIsRunning;
+};
+
+#endif /* _NULLAUDIOSINK_H_ */
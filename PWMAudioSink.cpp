@@ -0,0 +1,142 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * PWMAudioSink.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "PWMAudioSink.h"
+
+PWMAudioSink::PWMAudioSink(int32_t aPinLeft, int32_t aPinRight, NRF_PWM_Type* apPWM)
+{
+	mpPWM = apPWM;
+	mPinLeft = aPinLeft;
+	mPinRight = aPinRight;
+	mCounterTop = PWM_SINK_CLOCK / SampleRateToHz(ee2205);
+	mFreeMask = 0x03;
+	mIsRunning = false;
+
+	Silence();
+}
+
+PWMAudioSink::~PWMAudioSink()
+{
+	//Nothing to do
+}
+
+bool PWMAudioSink::Begin()
+{
+	mpPWM->PSEL.OUT[0] = mPinLeft << PWM_PSEL_OUT_PIN_Pos;
+	mpPWM->PSEL.OUT[1] = PWM_PSEL_OUT_CONNECT_Disconnected << PWM_PSEL_OUT_CONNECT_Pos;
+	mpPWM->PSEL.OUT[2] = mPinRight >= 0 ? mPinRight << PWM_PSEL_OUT_PIN_Pos
+										: PWM_PSEL_OUT_CONNECT_Disconnected << PWM_PSEL_OUT_CONNECT_Pos;
+	mpPWM->PSEL.OUT[3] = PWM_PSEL_OUT_CONNECT_Disconnected << PWM_PSEL_OUT_CONNECT_Pos;
+
+	mpPWM->ENABLE = PWM_ENABLE_ENABLE_Enabled << PWM_ENABLE_ENABLE_Pos;
+	mpPWM->MODE = PWM_MODE_UPDOWN_Up << PWM_MODE_UPDOWN_Pos;
+	mpPWM->PRESCALER = PWM_PRESCALER_PRESCALER_DIV_1 << PWM_PRESCALER_PRESCALER_Pos;
+	SetSampleRate(ee2205); //Default speed
+
+	//One value per group per PWM period: left for OUT[0-1], right for OUT[2-3]
+	mpPWM->DECODER = (PWM_DECODER_LOAD_Grouped << PWM_DECODER_LOAD_Pos)
+				   | (PWM_DECODER_MODE_RefreshCount << PWM_DECODER_MODE_Pos);
+
+	for(int lIdx = 0; lIdx < 2; lIdx++)
+	{
+		mpPWM->SEQ[lIdx].PTR = (uint32_t)maBuffers[lIdx];
+		mpPWM->SEQ[lIdx].CNT = I2S_BUF_SIZE * 2;
+		mpPWM->SEQ[lIdx].REFRESH = 0;
+		mpPWM->SEQ[lIdx].ENDDELAY = 0;
+	}
+
+	//Play sequence 0 then 1 as many times as the hardware allows, then start over
+	mpPWM->LOOP = PWM_LOOP_CNT_Msk;
+	mpPWM->SHORTS = PWM_SHORTS_LOOPSDONE_SEQSTART0_Msk;
+
+	return true;
+}
+
+void PWMAudioSink::SetSampleRate(ESampleRate aSampleRate)
+{
+	mCounterTop = PWM_SINK_CLOCK / SampleRateToHz(aSampleRate);
+	mpPWM->COUNTERTOP = mCounterTop << PWM_COUNTERTOP_COUNTERTOP_Pos;
+}
+
+void PWMAudioSink::Start()
+{
+	mpPWM->EVENTS_SEQEND[0] = 0;
+	mpPWM->EVENTS_SEQEND[1] = 0;
+	mIsRunning = true;
+
+	mpPWM->TASKS_SEQSTART[0] = 1;
+}
+
+void PWMAudioSink::Stop()
+{
+	mpPWM->TASKS_STOP = 1;
+
+	mIsRunning = false;
+	mFreeMask = 0x03;
+}
+
+int32_t* PWMAudioSink::GetFreeBuffer()
+{
+	if(mIsRunning)
+	{
+		for(int lIdx = 0; lIdx < 2; lIdx++)
+		{
+			if(mpPWM->EVENTS_SEQEND[lIdx] != 0)
+			{
+				mpPWM->EVENTS_SEQEND[lIdx] = 0;
+				mFreeMask |= 1 << lIdx;
+			}
+		}
+	}
+
+	if(mFreeMask & 0x01)
+	{
+		return maBuffers[0];
+	}
+	else if(mFreeMask & 0x02)
+	{
+		return maBuffers[1];
+	}
+
+	return nullptr;
+}
+
+void PWMAudioSink::SubmitBuffer(int32_t* apBuffer)
+{
+	//Signed samples to duty cycles between 0 and the counter top
+	uint16_t* lpDuty = (uint16_t*)apBuffer;
+	for(int lIdx = 0; lIdx < I2S_BUF_SIZE * 2; lIdx++)
+	{
+		lpDuty[lIdx] = ((uint32_t)((int16_t)lpDuty[lIdx] + 32768) * mCounterTop) >> 16;
+	}
+
+	mFreeMask &= ~(1 << (apBuffer == maBuffers[0] ? 0 : 1));
+}
+
+void PWMAudioSink::Silence()
+{
+	uint16_t* lpDuty = (uint16_t*)maBuffers;
+	for(int lIdx = 0; lIdx < I2S_BUF_SIZE * 4; lIdx++)
+	{
+		lpDuty[lIdx] = mCounterTop / 2;
+	}
+}
@@ -0,0 +1,117 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * PWMAudioSink.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _PWMAUDIOSINK_H_
+#define _PWMAUDIOSINK_H_
+
+#include <Arduino.h>
+#include "IAudioSink.h"
+
+//Clock the PWM counter runs from (Hz)
+#define PWM_SINK_CLOCK 16000000
+
+/**
+ * Plays audio as PWM through one of the nRF52 PWM peripherals, for boards
+ * without an I2S amp. Put an RC low-pass filter (or a class D amp that takes
+ * PWM) on the pins. The PWM period is one sample, so resolution depends on
+ * the sample rate: about 9.5 bits at 22.05 KHz and 8.4 bits at 48 KHz.
+ *
+ * The two buffers are the peripheral's two EasyDMA sequences, which it plays
+ * one after the other, forever. A buffer is free again once its sequence has
+ * ended (the SEQEND event). Samples are converted to PWM duty cycles in place
+ * when a buffer is handed back: the left channel drives OUT[0] and the right
+ * channel OUT[2] (the decoder's two groups).
+ */
+class PWMAudioSink : public IAudioSink
+{
+public:
+	/**
+	 * Constructor.
+	 * Args:
+	 *   aPinLeft - Pin for the left channel
+	 *   aPinRight - (optional) Pin for the right channel, -1 for none
+	 *   apPWM - (optional) PWM peripheral to use
+	 */
+	PWMAudioSink(int32_t aPinLeft, int32_t aPinRight = -1, NRF_PWM_Type* apPWM = NRF_PWM0);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~PWMAudioSink();
+
+	/**
+	 * Set up the PWM peripheral and pins.
+	 */
+	virtual bool Begin();
+
+	/**
+	 * Set the PWM period to one sample at the new rate.
+	 */
+	virtual void SetSampleRate(ESampleRate aSampleRate);
+
+	/**
+	 * Start playing the sequences.
+	 */
+	virtual void Start();
+
+	/**
+	 * Stop the PWM output.
+	 */
+	virtual void Stop();
+
+	/**
+	 * Fetch a buffer whose sequence has ended, if there is one.
+	 */
+	virtual int32_t* GetFreeBuffer();
+
+	/**
+	 * Convert a filled buffer to duty cycles. It plays when its sequence comes around.
+	 */
+	virtual void SubmitBuffer(int32_t* apBuffer);
+
+	/**
+	 * Fill both buffers with the middle duty cycle.
+	 */
+	virtual void Silence();
+
+protected:
+
+	//PWM peripheral being used
+	NRF_PWM_Type* mpPWM;
+
+	//Pins
+	int32_t mPinLeft;
+	int32_t mPinRight;
+
+	//PWM counter top, one sample period in PWM clocks
+	uint16_t mCounterTop;
+
+	//Sequence buffers. Each frame is two 16-bit duty cycles, left then right.
+	int32_t maBuffers[2][I2S_BUF_SIZE];
+
+	//Buffers that can be filled (bit per buffer)
+	uint8_t mFreeMask;
+
+	//TRUE while playing
+	bool mIsRunning;
+};
+
+#endif /* _PWMAUDIOSINK_H_ */
@@ -25,6 +25,7 @@ PitchShiftSDWavFile::PitchShiftSDWavFile(const char* aFilePath)
 : SDWavFile(aFilePath) //Call superclass constructor
 {
 	mCurSample = 0;
+	mSampleIndex = 0;
 
 	mSkipFactor = 0.0;
 	mRepeatFactor = 0.0;
@@ -34,11 +35,7 @@ PitchShiftSDWavFile::PitchShiftSDWavFile(const char* aFilePath)
 
 PitchShiftSDWavFile::~PitchShiftSDWavFile()
 {
-	if(nullptr != mpFileReader)
-	{
-		delete mpFileReader;
-		mFileHandle.close();
-	}
+	//Nothing to do, the superclass destructor cleans up the file reader
 }
 
 int PitchShiftSDWavFile::Fetch16BitSamples(int16_t* apBuffer, int aNumSamples)
@@ -56,6 +53,33 @@ int PitchShiftSDWavFile::Fetch16BitSamples(int16_t* apBuffer, int aNumSamples)
 	return lSampleIndex;
 }
 
+tAudioFormat PitchShiftSDWavFile::GetFormat()
+{
+	tAudioFormat lFormat = SDWavFile::GetFormat();
+	lFormat.mCapabilities &= ~eeCapExactLength;
+
+	return lFormat;
+}
+
+float PitchShiftSDWavFile::GetPlaybackSpeed()
+{
+	float lSpeed = 1.0f;
+
+	//Every sample is fetched, and the accumulated skips come in between.
+	//A skip happens once the accumulator passes 1.0, at least every other sample.
+	if(mSkipFactor > 0.0f)
+	{
+		lSpeed += mSkipFactor < 1.0f ? mSkipFactor / (1.0f + mSkipFactor) : mSkipFactor / 2.0f;
+	}
+	//Each fetched sample is played 1 + mRepeatFactor times on average
+	else if(mRepeatFactor > 0.0f)
+	{
+		lSpeed = 1.0f / (1.0f + mRepeatFactor);
+	}
+
+	return lSpeed;
+}
+
 void PitchShiftSDWavFile::CalculateCurSample()
 {
 	//Always fetch the first sample
@@ -87,7 +111,7 @@ void PitchShiftSDWavFile::CalculateCurSample()
 		if(mRepeatAccumulator >= 1.0)
 		{
 			//Repeat last sample (don't update mCurSample) and adjust the accumulator
-			mRepeatAccumulator =- 1.0;
+			mRepeatAccumulator -= 1.0;
 		}
 		else
 		{
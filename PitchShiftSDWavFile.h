@@ -62,6 +62,18 @@ public:
 	 *  aRate - A value from that defines how much the pitch will change.
 	 */
 	virtual void SetRate(float aRate);
+
+	/**
+	 * Fetch a description of the audio. The number of samples played
+	 * depends on the rate, so the length is not exact.
+	 */
+	virtual tAudioFormat GetFormat();
+
+	/**
+	 * Fetch how fast the file moves through its data at the current rate.
+	 * Returns: Data consumed per sample played, 1.0 = normal speed
+	 */
+	virtual float GetPlaybackSpeed();
 protected:
 
 	/**
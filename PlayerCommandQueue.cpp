@@ -0,0 +1,77 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * PlayerCommandQueue.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "PlayerCommandQueue.h"
+
+PlayerCommandQueue::PlayerCommandQueue()
+: mHead(0), mTail(0)
+{
+	mWriteIndex = 0;
+	mInBatch = false;
+	mNumDropped = 0;
+}
+
+bool PlayerCommandQueue::Push(const tPlayerCommand& arCommand)
+{
+	//Counters are free running, unsigned math handles wrap-around
+	if(mWriteIndex - mTail.load(std::memory_order_acquire) >= PLAYER_COMMAND_QUEUE_SIZE)
+	{
+		mNumDropped++;
+		return false;
+	}
+
+	maCommands[mWriteIndex & (PLAYER_COMMAND_QUEUE_SIZE - 1)] = arCommand;
+	mWriteIndex++;
+
+	if(!mInBatch)
+	{
+		mHead.store(mWriteIndex, std::memory_order_release);
+	}
+
+	return true;
+}
+
+bool PlayerCommandQueue::Pop(tPlayerCommand& arCommand)
+{
+	uint32_t lTail = mTail.load(std::memory_order_relaxed);
+
+	if(lTail == mHead.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	arCommand = maCommands[lTail & (PLAYER_COMMAND_QUEUE_SIZE - 1)];
+	mTail.store(lTail + 1, std::memory_order_release);
+
+	return true;
+}
+
+void PlayerCommandQueue::BeginBatch()
+{
+	mInBatch = true;
+}
+
+void PlayerCommandQueue::EndBatch()
+{
+	mInBatch = false;
+	mHead.store(mWriteIndex, std::memory_order_release);
+}
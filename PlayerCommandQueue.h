@@ -0,0 +1,141 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * PlayerCommandQueue.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _PLAYERCOMMANDQUEUE_H_
+#define _PLAYERCOMMANDQUEUE_H_
+
+#include <stdint.h>
+#include <atomic>
+
+class ISDWavFile;
+
+//Number of commands the queue can hold (must be a power of 2)
+#ifndef PLAYER_COMMAND_QUEUE_SIZE
+#define PLAYER_COMMAND_QUEUE_SIZE 32
+#endif
+
+static_assert((PLAYER_COMMAND_QUEUE_SIZE & (PLAYER_COMMAND_QUEUE_SIZE - 1)) == 0,
+		"PLAYER_COMMAND_QUEUE_SIZE must be a power of 2");
+
+enum EPlayerCommand
+{
+	eeCmdSetWavFile,
+	eeCmdClearAllWavFiles,
+	eeCmdSetMasterVolume,
+	eeCmdSetFileVolume,
+	eeCmdSetFileRate,
+	eeCmdSetLooping,
+	eeCmdPause,
+	eeCmdUnPause,
+	eeCmdScheduleStart,
+	eeCmdSetSampleRate
+};
+
+//A control call waiting to be applied by the player
+struct tPlayerCommand
+{
+	//What to do (EPlayerCommand)
+	uint8_t mType;
+	//Player channel for eeCmdSetWavFile, ESampleRate for eeCmdSetSampleRate
+	int8_t mFileIndex;
+	//Flag for eeCmdSetLooping, ownership for eeCmdSetWavFile
+	bool mFlag;
+	//Volume or rate
+	float mValue;
+	//File the command applies to
+	ISDWavFile* mpFile;
+	//Playback clock time for eeCmdScheduleStart
+	uint64_t mTime;
+};
+
+/**
+ * Lock-free single-producer/single-consumer ring of player commands.
+ * Push() and Pop() never block and never allocate, so Push() is safe to call
+ * from an interrupt handler or another task while the player pops commands
+ * in its own context. Only one context may push and only one may pop.
+ * Multiple producers must serialize their calls to Push() themselves.
+ */
+class PlayerCommandQueue
+{
+public:
+	/**
+	 * Constructor.
+	 */
+	PlayerCommandQueue();
+
+	/**
+	 * Add a command to the queue. Producer side only.
+	 * Args:
+	 *  arCommand - Command to add
+	 * Returns: TRUE if the command was queued, FALSE if the queue is full
+	 */
+	bool Push(const tPlayerCommand& arCommand);
+
+	/**
+	 * Remove the oldest command from the queue. Consumer side only.
+	 * Args:
+	 *  arCommand - Location to store the command
+	 * Returns: TRUE if a command was removed, FALSE if the queue is empty
+	 */
+	bool Pop(tPlayerCommand& arCommand);
+
+	/**
+	 * Hold back commands pushed from now on until EndBatch() is called, so the
+	 * consumer sees all of them at once. Producer side only.
+	 */
+	void BeginBatch();
+
+	/**
+	 * Make all commands pushed since BeginBatch() visible to the consumer.
+	 * Producer side only.
+	 */
+	void EndBatch();
+
+	/**
+	 * Fetch how many commands have been rejected because the queue was full.
+	 */
+	inline uint32_t GetNumDropped()
+	{
+		return mNumDropped;
+	}
+
+protected:
+
+	//Command storage
+	tPlayerCommand maCommands[PLAYER_COMMAND_QUEUE_SIZE];
+
+	//Number of commands ever published to the consumer (written by producer)
+	std::atomic<uint32_t> mHead;
+
+	//Number of commands ever popped (written by consumer)
+	std::atomic<uint32_t> mTail;
+
+	//Number of commands ever pushed, including unpublished ones (producer only)
+	uint32_t mWriteIndex;
+
+	//TRUE while a batch is open (producer only)
+	bool mInBatch;
+
+	//Commands rejected because the queue was full (producer only)
+	uint32_t mNumDropped;
+};
+
+#endif /* _PLAYERCOMMANDQUEUE_H_ */
@@ -0,0 +1,192 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * ReadLatencyHistogram.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include <string.h>
+#include "ReadLatencyHistogram.h"
+
+ReadLatencyHistogram::ReadLatencyHistogram()
+{
+	Reset();
+}
+
+void ReadLatencyHistogram::Reset()
+{
+	memset(maBuckets, 0, sizeof(maBuckets));
+	memset(maCounts, 0, sizeof(maCounts));
+	memset(maMax, 0, sizeof(maMax));
+	memset(maTotalMicros, 0, sizeof(maTotalMicros));
+}
+
+void ReadLatencyHistogram::Record(uint32_t aNumBytes, uint32_t aMicros)
+{
+	int lSizeClass = GetSizeClass(aNumBytes);
+
+	maBuckets[lSizeClass][GetBucket(aMicros)]++;
+	maCounts[lSizeClass]++;
+	maTotalMicros[lSizeClass] += aMicros;
+	if(aMicros > maMax[lSizeClass])
+	{
+		maMax[lSizeClass] = aMicros;
+	}
+}
+
+int ReadLatencyHistogram::GetSizeClass(uint32_t aNumBytes)
+{
+	int lSizeClass = 0;
+	uint32_t lLimit = LATENCY_SMALLEST_READ;
+
+	while(aNumBytes > lLimit && lSizeClass < LATENCY_SIZE_CLASSES - 1)
+	{
+		lLimit <<= 1;
+		lSizeClass++;
+	}
+
+	return lSizeClass;
+}
+
+uint32_t ReadLatencyHistogram::GetSizeClassLimit(int aSizeClass)
+{
+	if(aSizeClass >= LATENCY_SIZE_CLASSES - 1)
+	{
+		return 0;
+	}
+
+	return (uint32_t)LATENCY_SMALLEST_READ << aSizeClass;
+}
+
+int ReadLatencyHistogram::GetBucket(uint32_t aMicros)
+{
+	if(aMicros < 8)
+	{
+		return aMicros;
+	}
+
+	//Four buckets for each power of two from 8us up
+	int lPower = 31 - __builtin_clz(aMicros);
+	int lStep = (aMicros >> (lPower - 2)) & 0x03;
+	int lBucket = 8 + (lPower - 3) * 4 + lStep;
+
+	return lBucket < LATENCY_NUM_BUCKETS ? lBucket : LATENCY_NUM_BUCKETS - 1;
+}
+
+uint32_t ReadLatencyHistogram::GetBucketLimit(int aBucket)
+{
+	if(aBucket < 8)
+	{
+		return aBucket;
+	}
+
+	int lPower = (aBucket - 8) / 4 + 3;
+	int lStep = (aBucket - 8) % 4;
+
+	return ((uint32_t)(5 + lStep) << (lPower - 2)) - 1;
+}
+
+uint32_t ReadLatencyHistogram::GetCount(int aSizeClass)
+{
+	if(aSizeClass >= 0)
+	{
+		return maCounts[aSizeClass];
+	}
+
+	uint32_t lCount = 0;
+	for(int lIdx = 0; lIdx < LATENCY_SIZE_CLASSES; lIdx++)
+	{
+		lCount += maCounts[lIdx];
+	}
+
+	return lCount;
+}
+
+uint32_t ReadLatencyHistogram::GetMax(int aSizeClass)
+{
+	if(aSizeClass >= 0)
+	{
+		return maMax[aSizeClass];
+	}
+
+	uint32_t lMax = 0;
+	for(int lIdx = 0; lIdx < LATENCY_SIZE_CLASSES; lIdx++)
+	{
+		if(maMax[lIdx] > lMax)
+		{
+			lMax = maMax[lIdx];
+		}
+	}
+
+	return lMax;
+}
+
+uint32_t ReadLatencyHistogram::GetMean(int aSizeClass)
+{
+	uint64_t lTotal = 0;
+	for(int lIdx = 0; lIdx < LATENCY_SIZE_CLASSES; lIdx++)
+	{
+		if(aSizeClass < 0 || aSizeClass == lIdx)
+		{
+			lTotal += maTotalMicros[lIdx];
+		}
+	}
+
+	uint32_t lCount = GetCount(aSizeClass);
+
+	return lCount > 0 ? lTotal / lCount : 0;
+}
+
+uint32_t ReadLatencyHistogram::GetPercentile(float aPercentile, int aSizeClass)
+{
+	uint32_t lCount = GetCount(aSizeClass);
+	if(0 == lCount)
+	{
+		return 0;
+	}
+
+	//Number of reads that have to be at or under the result
+	float lExact = lCount * aPercentile / 100.0;
+	uint32_t lTarget = (uint32_t)lExact;
+	if(lTarget < lExact || lTarget < 1)
+	{
+		lTarget++;
+	}
+
+	uint32_t lSeen = 0;
+	for(int lBucket = 0; lBucket < LATENCY_NUM_BUCKETS; lBucket++)
+	{
+		for(int lIdx = 0; lIdx < LATENCY_SIZE_CLASSES; lIdx++)
+		{
+			if(aSizeClass < 0 || aSizeClass == lIdx)
+			{
+				lSeen += maBuckets[lIdx][lBucket];
+			}
+		}
+
+		if(lSeen >= lTarget)
+		{
+			//The top of the bucket can't be more than what was actually seen
+			uint32_t lLimit = GetBucketLimit(lBucket);
+			uint32_t lMax = GetMax(aSizeClass);
+			return lLimit < lMax ? lLimit : lMax;
+		}
+	}
+
+	return GetMax(aSizeClass);
+}
@@ -0,0 +1,153 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * ReadLatencyHistogram.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _READLATENCYHISTOGRAM_H_
+#define _READLATENCYHISTOGRAM_H_
+
+#include <stdint.h>
+
+//Number of read size classes. Class 0 holds reads up to LATENCY_SMALLEST_READ
+//bytes, each class after that holds reads up to twice the size of the one
+//before, and the last class holds everything larger.
+#define LATENCY_SIZE_CLASSES 4
+
+//Largest read (in bytes) counted in the first size class. One SD card sector.
+#define LATENCY_SMALLEST_READ 512
+
+//Number of latency buckets per size class. Buckets are exact below 8us, then
+//four buckets per power of two, which covers up to about 2 seconds with
+//less than 25% error. Anything slower lands in the last bucket.
+#define LATENCY_NUM_BUCKETS 80
+
+/**
+ * Histogram of how long SD card reads take, kept separately for each read
+ * size. BufferedFileReader records every read into the histogram set with
+ * BufferedFileReader::SetLatencyHistogram(), which is how cards are
+ * qualified (see the nrf52_SDQualify example and extras/sd_latency_report.py).
+ *
+ * The exact maximum is kept, percentiles are reported as the top of the
+ * bucket they fall in, so they are never optimistic.
+ */
+class ReadLatencyHistogram
+{
+public:
+
+	/**
+	 * Constructor. Starts out empty.
+	 */
+	ReadLatencyHistogram();
+
+	/**
+	 * Clear all recorded reads.
+	 */
+	void Reset();
+
+	/**
+	 * Record one read.
+	 * Args:
+	 *   aNumBytes - Size of the read
+	 *   aMicros - How long the read took (microseconds)
+	 */
+	void Record(uint32_t aNumBytes, uint32_t aMicros);
+
+	/**
+	 * Fetch the size class a read falls in.
+	 * Args:
+	 *   aNumBytes - Size of the read
+	 * Returns: Size class, 0 to LATENCY_SIZE_CLASSES-1
+	 */
+	static int GetSizeClass(uint32_t aNumBytes);
+
+	/**
+	 * Fetch the largest read counted in a size class.
+	 * Args:
+	 *   aSizeClass - Size class
+	 * Returns: Size in bytes, 0 for the last class (no limit)
+	 */
+	static uint32_t GetSizeClassLimit(int aSizeClass);
+
+	/**
+	 * Fetch the bucket a latency falls in.
+	 * Args:
+	 *   aMicros - Latency (microseconds)
+	 * Returns: Bucket, 0 to LATENCY_NUM_BUCKETS-1
+	 */
+	static int GetBucket(uint32_t aMicros);
+
+	/**
+	 * Fetch the longest latency counted in a bucket.
+	 * Args:
+	 *   aBucket - Bucket
+	 * Returns: Latency (microseconds)
+	 */
+	static uint32_t GetBucketLimit(int aBucket);
+
+	/**
+	 * Fetch how many reads were recorded in a size class, or in all
+	 * of them when aSizeClass is -1.
+	 */
+	uint32_t GetCount(int aSizeClass = -1);
+
+	/**
+	 * Fetch how many reads of a size class landed in a bucket.
+	 */
+	inline uint32_t GetBucketCount(int aSizeClass, int aBucket)
+	{
+		return maBuckets[aSizeClass][aBucket];
+	}
+
+	/**
+	 * Fetch the longest read recorded in a size class, or in all
+	 * of them when aSizeClass is -1 (microseconds).
+	 */
+	uint32_t GetMax(int aSizeClass = -1);
+
+	/**
+	 * Fetch the average read time of a size class, or of all of them
+	 * when aSizeClass is -1 (microseconds).
+	 */
+	uint32_t GetMean(int aSizeClass = -1);
+
+	/**
+	 * Fetch the latency that a given share of reads stayed under.
+	 * Args:
+	 *   aPercentile - Share of reads, 0.0 to 100.0 (e.g. 99.0 for p99)
+	 *   aSizeClass - Size class, or -1 for all reads
+	 * Returns: Latency (microseconds), 0 if nothing was recorded
+	 */
+	uint32_t GetPercentile(float aPercentile, int aSizeClass = -1);
+
+protected:
+
+	//Number of reads in each bucket of each size class
+	uint32_t maBuckets[LATENCY_SIZE_CLASSES][LATENCY_NUM_BUCKETS];
+
+	//Number of reads in each size class
+	uint32_t maCounts[LATENCY_SIZE_CLASSES];
+
+	//Longest read in each size class (microseconds)
+	uint32_t maMax[LATENCY_SIZE_CLASSES];
+
+	//Total read time of each size class (microseconds)
+	uint64_t maTotalMicros[LATENCY_SIZE_CLASSES];
+};
+
+#endif /* _READLATENCYHISTOGRAM_H_ */
@@ -24,11 +24,13 @@
 #include <SD.h>
 #include <Arduino.h>
 
-#define DATA_START_OFFSET 44 //Byte offset where the data always starts
+#define RIFF_HEADER_SIZE 12 //"RIFF", chunk size, "WAVE"
+#define DATA_START_OFFSET 44 //Byte offset where the data starts in a canonical wav file
 #define DEPOP_END_SAMPLES 512 //How many samples to use in dynamic de-popping at the end of a file
 #define DEPOP_START_SAMPLES 32 //How many samples to use in dynamic de-popping at the start of a file
 
 int SDWavFile::sFilesOpen = 0;
+File SDWavFile::sNullFileHandle;
 
 SDWavFile::SDWavFile(const char* apFilePath)
 {
@@ -37,16 +39,29 @@ SDWavFile::SDWavFile(const char* apFilePath)
 	mVolume = 1.0;
 	mIsLooping = false;
 	mIsPaused = false;
+	mIsStopped = false;
 	mLastSample = 0;
 	mSamplesRead = 0;
 	mDepopStart = true;
 	mDepopEnd = true;
+	mpIOScheduler = nullptr;
+	mpEventSink = nullptr;
+	mLoopStart = 0;
+	mLoopEnd = 0;
+	mDataStart = DATA_START_OFFSET;
+
+	mpFileHandle = SharedFileTable::Acquire(apFilePath);
+	if(nullptr == mpFileHandle)
+	{
+		mpFileHandle = &sNullFileHandle;
+	}
+	else
+	{
+		sFilesOpen++;
+	}
 
-	mFileHandle = SD.open(apFilePath, FILE_READ);
-	sFilesOpen++;
-
-	mpFileReader = new BufferedFileReader(&mFileHandle);
-	mpFileReader->Reset();
+	mpFileReader = nullptr;
+	CreateFileReader();
 
 	ReadHeader();
 	ReadDataHeader();
@@ -57,12 +72,20 @@ SDWavFile::SDWavFile()
 {
 	//Store the file path
 	mpFilePath = "";
+	memset(&mHeader, 0, sizeof(tWavFileHeader));
+	memset(&mDataHeader, 0, sizeof(tWavDataHeader));
 	mVolume = 1.0;
 	mIsLooping = false;
 	mIsPaused = false;
+	mpFileHandle = &sNullFileHandle;
 	mpFileReader = nullptr;
+	mpIOScheduler = nullptr;
+	mpEventSink = nullptr;
+	mLoopStart = 0;
+	mLoopEnd = 0;
 	mIsStopped = false;
 	mBytesPerSample = 2;
+	mDataStart = DATA_START_OFFSET;
 	mLastSample = 0;
 	mSamplesRead = 0;
 	mDepopStart = true;
@@ -71,16 +94,13 @@ SDWavFile::SDWavFile()
 
 SDWavFile::~SDWavFile()
 {
-	if(nullptr != mpFileReader)
-	{
-		delete mpFileReader;
-		mFileHandle.close();
-	}
+	//Does nothing if the file was already closed
+	SDWavFile::Close();
 }
 
 File& SDWavFile::GetFileHandle()
 {
-	return mFileHandle;
+	return *mpFileHandle;
 }
 
 const tWavFileHeader& SDWavFile::GetHeader()
@@ -95,17 +115,37 @@ const tWavDataHeader& SDWavFile::GetDataHeader()
 
 void SDWavFile::Close()
 {
-	mFileHandle.close();
-	sFilesOpen--;
+	SetIOScheduler(nullptr, 0);
+
+	if(&sNullFileHandle != mpFileHandle)
+	{
+		SharedFileTable::Release(mpFileHandle);
+		mpFileHandle = &sNullFileHandle;
+		sFilesOpen--;
+	}
+
+	//The read buffer is given back now rather than when the file is destroyed.
+	//Once closed the file reads as ended.
+	DestroyFileReader();
 }
 
 bool SDWavFile::SeekStartOfData()
 {
-	if(mFileHandle.size() >= DATA_START_OFFSET+1)
+	ReportEvent(eeWavFileStateChanged);
+
+	if(&sNullFileHandle != mpFileHandle && nullptr != mpFileReader
+	   && mpFileReader->GetRegionSize() >= mDataStart+1)
 	{
 		//lSuccess = mFileHandle.seek(DATA_START_OFFSET);
-		mpFileReader->Reset();
-		mpFileReader->BufferSeek(DATA_START_OFFSET);
+		if(mDataStart < DATA_BLOCK_SIZE)
+		{
+			mpFileReader->Reset();
+			mpFileReader->BufferSeek(mDataStart);
+		}
+		else
+		{
+			mpFileReader->SeekTo(mDataStart);
+		}
 		mSamplesRead = 0;
 	}
 
@@ -114,30 +154,41 @@ bool SDWavFile::SeekStartOfData()
 
 int SDWavFile::Available()
 {
-	if(mpFileReader->BufferAvailable() > mFileHandle.available())
+	if(nullptr == mpFileReader)
 	{
-		return mFileHandle.available();
+		return 0;
 	}
-	else
+
+	uint32_t lPos = mpFileReader->GetPosition();
+	uint32_t lDataEnd = GetDataEnd();
+
+	if(lPos >= lDataEnd)
 	{
-		return mpFileReader->BufferAvailable();
+		return 0;
 	}
+
+	return lDataEnd - lPos;
 }
 
 int SDWavFile::Fetch16BitSamples(int16_t* apBuffer, int aNumSamples)
 {
+	if(nullptr == mpFileReader)
+	{
+		return 0; //Closed
+	}
+
 	//Read until requested size is met or we run out of data
 	int lSampleIndex = 0;
 	for(lSampleIndex = 0;
 		lSampleIndex < aNumSamples &&
-		(mFileHandle.available() >= sizeof(int16_t) || mpFileReader->BufferAvailable() >= sizeof(int16_t));
+		(mpFileReader->FileAvailable() >= mBytesPerSample || mpFileReader->BufferAvailable() >= mBytesPerSample);
 		lSampleIndex++)
 	{
 		//Clear current sample in the output buffer
 		apBuffer[lSampleIndex] = 0;
 
-		//Read 2 bytes (16 bits) sample from the file
-		mpFileReader->FetchBufferedBytes((int8_t*)&apBuffer[lSampleIndex], 2);
+		//Read one sample from the file and convert it to 16 bits
+		FetchRawSample(&apBuffer[lSampleIndex]);
 
 		//Apply volume by reducing the amplitude of each sample
 		if(mVolume < 1.0 && mVolume >= 0.0)
@@ -152,10 +203,11 @@ int SDWavFile::Fetch16BitSamples(int16_t* apBuffer, int aNumSamples)
 		}
 		//De-pop end of playback by ramping down volume so that when we loop we
 		//don't get an annoying pop sound
-		if(mDepopEnd && mFileHandle.available() < sizeof(int16_t)
-			&&mpFileReader->BufferAvailable() < DEPOP_END_SAMPLES)
+		int lSamplesLeft = mpFileReader->BufferAvailable() / mBytesPerSample;
+		if(mDepopEnd && mpFileReader->FileAvailable() < mBytesPerSample
+			&& lSamplesLeft < DEPOP_END_SAMPLES)
 		{
-			float lAvailable = mpFileReader->BufferAvailable();
+			float lAvailable = lSamplesLeft;
 			float lDepopEndSamples = DEPOP_END_SAMPLES;
 			float lDePopMultiplier = 1.0 - ((lDepopEndSamples - lAvailable) / lDepopEndSamples);
 
@@ -166,12 +218,7 @@ int SDWavFile::Fetch16BitSamples(int16_t* apBuffer, int aNumSamples)
 		mLastSample = apBuffer[lSampleIndex];
 
 		//If we ran out of data, check if we should loop back to the start
-		if(mFileHandle.available() < sizeof(int16_t)
-				&& mpFileReader->BufferAvailable() < sizeof(int16_t)
-				&& true == mIsLooping)
-		{
-			SeekStartOfData();
-		}
+		HandleEndOfData();
 
 	}
 
@@ -197,11 +244,13 @@ void SDWavFile::SetVolume(float aVolume)
 void SDWavFile::SetLooping(bool aLoopingEnable)
 {
 	mIsLooping = aLoopingEnable;
+	ReportEvent(eeWavFileStateChanged);
 }
 
 void SDWavFile::Pause()
 {
 	mIsPaused = true;
+	ReportEvent(eeWavFileStateChanged);
 }
 
 bool SDWavFile::IsPaused()
@@ -212,13 +261,14 @@ bool SDWavFile::IsPaused()
 void SDWavFile::UnPause()
 {
 	mIsPaused = false;
+	ReportEvent(eeWavFileStateChanged);
 }
 
 bool SDWavFile::IsEnded()
 {
 	bool lbEnded = false;
 
-	if(mpFileReader->IsEnded() && !mIsLooping)
+	if(nullptr == mpFileReader || (mpFileReader->IsEnded() && !mIsLooping))
 	{
 		lbEnded = true;
 	}
@@ -234,27 +284,197 @@ void SDWavFile::SetDePop(bool aStart, bool aEnd)
 
 void SDWavFile::Skip16BitSamples(int aNumSamples)
 {
-	//Read until requested size is met or we run out of data
-	for(int lSampleIndex = 0;
-		lSampleIndex < aNumSamples &&
-		(mFileHandle.available() >= sizeof(int16_t) || mpFileReader->BufferAvailable() >= sizeof(int16_t));
-		lSampleIndex++)
+	if(nullptr == mpFileReader)
 	{
-		//Read 2 bytes (16 bits) sample from the file
-		int16_t lSkippedSample; //This sample will get thrown on the floor, we are skipping it
-		mpFileReader->FetchBufferedBytes((int8_t*)lSkippedSample, 2);
+		return;
+	}
 
-		mSamplesRead++;
+	uint32_t lPos = mpFileReader->GetPosition();
+	uint32_t lDataEnd = GetDataEnd();
 
-		//If we ran out of data, check if we should loop back to the start
-		if(mFileHandle.available() < sizeof(int16_t)
-				&& mpFileReader->BufferAvailable() < sizeof(int16_t)
-				&& true == mIsLooping)
+	//Nothing to skip if we're out of data
+	if(aNumSamples <= 0 || lPos + mBytesPerSample > lDataEnd)
+	{
+		return;
+	}
+
+	uint32_t lNewPos = lPos + (uint32_t)aNumSamples * mBytesPerSample;
+	unsigned long lNewSamplesRead = mSamplesRead + aNumSamples;
+
+	//Jumping over the loop end wraps back to the loop start
+	if(mIsLooping && mLoopEnd > mLoopStart && mSamplesRead < mLoopEnd && lNewSamplesRead >= mLoopEnd)
+	{
+		mSamplesRead = mLoopEnd;
+		ReportEvent(eeWavFileLooped);
+
+		SeekToSample(mLoopStart + (lNewSamplesRead - mLoopEnd) % (mLoopEnd - mLoopStart));
+		return;
+	}
+
+	if(lNewPos >= lDataEnd)
+	{
+		//Position where the data ran out
+		mSamplesRead += (lDataEnd - lPos) / mBytesPerSample;
+
+		if(mIsLooping)
 		{
+			ReportEvent(eeWavFileLooped);
+
+			uint32_t lDataSize = lDataEnd - mDataStart;
+			SeekToSample(((lNewPos - mDataStart) % lDataSize) / mBytesPerSample);
+		}
+		else
+		{
+			//Move to the very end of the file so the reader reports that it ended
+			mpFileReader->SeekTo(mpFileReader->GetRegionSize());
+			ReportEvent(eeWavFileEnded);
+		}
+
+		return;
+	}
+
+	//Block-wise skip, only the block the new position is in gets read
+	mpFileReader->SeekTo(lNewPos);
+	mSamplesRead = lNewSamplesRead;
+}
+
+tAudioFormat SDWavFile::GetFormat()
+{
+	tAudioFormat lFormat = ISDWavFile::GetFormat();
+	lFormat.mNumSamples = (GetDataEnd() - mDataStart) / mBytesPerSample;
+	lFormat.mCapabilities = eeCapFastSeek | eeCapExactLength;
+
+	return lFormat;
+}
+
+bool SDWavFile::SeekToSample(unsigned long aSample)
+{
+	ReportEvent(eeWavFileStateChanged);
+
+	if(&sNullFileHandle == mpFileHandle || nullptr == mpFileReader
+	   || mpFileReader->GetRegionSize() < mDataStart+1)
+	{
+		return false;
+	}
+
+	uint32_t lDataEnd = GetDataEnd();
+	uint32_t lNumSamples = (lDataEnd - mDataStart) / mBytesPerSample;
+	if(aSample > lNumSamples)
+	{
+		aSample = lNumSamples;
+	}
+
+	mpFileReader->SeekTo(mDataStart + aSample * mBytesPerSample);
+	mSamplesRead = aSample;
+
+	return true;
+}
+
+void SDWavFile::SetLoopPoints(unsigned long aLoopStart, unsigned long aLoopEnd)
+{
+	mLoopStart = aLoopStart;
+	mLoopEnd = aLoopEnd;
+
+	//Invalid loop points mean "loop the whole file"
+	if(mLoopEnd <= mLoopStart)
+	{
+		mLoopStart = 0;
+		mLoopEnd = 0;
+	}
+}
+
+void SDWavFile::SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond)
+{
+	if(nullptr == mpFileReader)
+	{
+		return;
+	}
+
+	if(nullptr != mpIOScheduler && apScheduler != mpIOScheduler)
+	{
+		mpIOScheduler->Unregister(mpFileReader);
+	}
+
+	mpIOScheduler = apScheduler;
+
+	if(nullptr != mpIOScheduler)
+	{
+		mpIOScheduler->Register(mpFileReader, aBytesPerSecond);
+	}
+}
+
+void SDWavFile::SetEventSink(IWavFileEventSink* apSink)
+{
+	mpEventSink = apSink;
+}
+
+void SDWavFile::HandleEndOfData()
+{
+	if(mIsLooping && mSamplesRead == mLoopEnd && mLoopEnd > 0)
+	{
+		ReportEvent(eeWavFileLooped);
+		SeekToSample(mLoopStart);
+	}
+	else if(mpFileReader->FileAvailable() < mBytesPerSample
+			&& mpFileReader->BufferAvailable() < mBytesPerSample)
+	{
+		if(true == mIsLooping)
+		{
+			ReportEvent(eeWavFileLooped);
 			SeekStartOfData();
 		}
+		else
+		{
+			ReportEvent(eeWavFileEnded);
+		}
+	}
+}
 
+uint32_t SDWavFile::GetDataEnd()
+{
+	uint32_t lRegionSize = nullptr != mpFileReader ? mpFileReader->GetRegionSize() : 0;
+	if(lRegionSize < mDataStart)
+	{
+		return mDataStart;
 	}
+
+	//Ignore a partial sample at the end of the file
+	return lRegionSize - (lRegionSize - mDataStart) % mBytesPerSample;
+}
+
+void SDWavFile::ReportEvent(EWavFileEvent aEvent)
+{
+	if(nullptr != mpEventSink)
+	{
+		mpEventSink->OnWavFileEvent(this, aEvent, mSamplesRead);
+	}
+}
+
+void SDWavFile::CreateFileReader(uint32_t aRegionStart, uint32_t aRegionSize)
+{
+	DestroyFileReader();
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	mpFileReader = new(maFileReaderStorage) BufferedFileReader(mpFileHandle, aRegionStart, aRegionSize);
+#else
+	mpFileReader = new BufferedFileReader(mpFileHandle, aRegionStart, aRegionSize);
+#endif
+	mpFileReader->Reset();
+}
+
+void SDWavFile::DestroyFileReader()
+{
+	if(nullptr == mpFileReader)
+	{
+		return;
+	}
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	mpFileReader->~BufferedFileReader();
+#else
+	delete mpFileReader;
+#endif
+	mpFileReader = nullptr;
 }
 
 void SDWavFile::ReadHeader()
@@ -266,14 +486,77 @@ void SDWavFile::ReadHeader()
 	}
 
 	mBytesPerSample = (mHeader.bitsPerSample / 8);
+
+	//Only 8-bit (PCM or G.711) and 16-bit samples are supported, treat anything
+	//else as 16-bit so a bad header can't stall the read loops
+	if(1 != mBytesPerSample && 2 != mBytesPerSample)
+	{
+		mBytesPerSample = 2;
+	}
+}
+
+void SDWavFile::FetchRawSample(int16_t* apSample)
+{
+	if(2 == mBytesPerSample)
+	{
+		mpFileReader->FetchBufferedBytes((int8_t*)apSample, 2);
+		return;
+	}
+
+	uint8_t lByte = 0;
+	mpFileReader->FetchBufferedBytes((int8_t*)&lByte, 1);
+
+	switch(mHeader.audioFormat)
+	{
+	case WAVE_FORMAT_MULAW:
+		*apSample = G711DecodeMuLaw(lByte);
+		break;
+	case WAVE_FORMAT_ALAW:
+		*apSample = G711DecodeALaw(lByte);
+		break;
+	default:
+		//8-bit PCM is unsigned
+		*apSample = ((int16_t)lByte - 128) << 8;
+		break;
+	}
 }
 
 void SDWavFile::ReadDataHeader()
 {
-	if(mpFileReader->BufferAvailable() >= sizeof(tWavDataHeader))
+	uint32_t lRegionSize = mpFileReader->GetRegionSize();
+
+	//Walk the chunks after the RIFF header until the data block is found.
+	//In a canonical file it comes right after the 16 byte format chunk.
+	uint32_t lChunkPos = RIFF_HEADER_SIZE;
+	while(lChunkPos + sizeof(tWavDataHeader) <= lRegionSize)
+	{
+		tWavDataHeader lChunkHeader;
+		mpFileReader->SeekTo(lChunkPos);
+		mpFileReader->FetchBufferedBytes((int8_t*)&lChunkHeader, sizeof(tWavDataHeader));
+		lChunkPos += sizeof(tWavDataHeader);
+
+		if(0 == memcmp(lChunkHeader.mID, "data", 4))
+		{
+			mDataHeader = lChunkHeader;
+			mDataStart = lChunkPos;
+			return;
+		}
+
+		//Chunks are padded to an even size
+		uint32_t lChunkSize = lChunkHeader.mSize + (lChunkHeader.mSize & 1);
+		if(lChunkSize > lRegionSize - lChunkPos)
+		{
+			break;
+		}
+		lChunkPos += lChunkSize;
+	}
+
+	//No data block, read from where a canonical file would have it
+	memset(&mDataHeader, 0, sizeof(tWavDataHeader));
+	mDataStart = DATA_START_OFFSET;
+	if(lRegionSize >= DATA_START_OFFSET)
 	{
-		int8_t* lpReadByte = (int8_t*)&mDataHeader;
-		mpFileReader->FetchBufferedBytes(lpReadByte, sizeof(tWavDataHeader));
+		mpFileReader->SeekTo(DATA_START_OFFSET);
 	}
 }
 
@@ -24,13 +24,21 @@
 
 #include <Arduino.h>
 #include <SD.h>
+#include "AudioAlloc.h"
 #include "BufferedFileReader.h"
 #include "ISDWavFile.h"
+#include "SharedFileTable.h"
+#include "IOScheduler.h"
+#include "G711.h"
 
 /**
  * This class represents a single .wav file on an SD card. It is
  * responsible for opening the file, reading the data, and making
  * the samples available.
+ *
+ * File handles are shared through SharedFileTable, so creating several
+ * SDWavFile objects for the same path (for example to retrigger a sound
+ * on more than one voice) only opens the file once.
  */
 class SDWavFile : public ISDWavFile
 {
@@ -63,7 +71,8 @@ public:
 	const tWavDataHeader& GetDataHeader();
 
 	/**
-	 * Close the file.
+	 * Close the file and free its read buffer. A closed file reads as ended
+	 * and can't be rewound. Closing again does nothing.
 	 */
 	virtual void Close();
 
@@ -74,9 +83,7 @@ public:
 
 	/**
 	 * Fetch how many bytes are available to be read before
-	 * the read pointer reaches the end of the file.
-	 * NOTE: This is not accurate until less then 32768 bytes
-	 * are available in the file.
+	 * the read pointer reaches the end of the sample data.
 	 *
 	 * Returns: Number of bytes left to be read
 	 */
@@ -157,12 +164,53 @@ public:
 	virtual void SetDePop(bool aStart, bool aEnd);
 
 	/**
-	 * Skips samples. All read pointers are advanced.
+	 * Skips samples. The read position is moved directly, only the data
+	 * block the new position is in gets read from the SD card.
 	 * Args:
 	 *  aNumSamples - Number of 16-bit samples to skip.
 	 */
 	virtual void Skip16BitSamples(int aNumSamples);
 
+	/**
+	 * Move the read position to any sample in the file. This costs at most
+	 * one data block read, no matter how far the jump is.
+	 * Args:
+	 *  aSample - Sample to read next, counted from the start of the data
+	 * Returns: TRUE if successful, FALSE if the file isn't open
+	 */
+	virtual bool SeekToSample(unsigned long aSample);
+
+	/**
+	 * Set the part of the file that is repeated when looping is enabled.
+	 * Playback runs from the start of the file, then repeats from aLoopStart
+	 * every time aLoopEnd is reached.
+	 * Args:
+	 *  aLoopStart - First sample of the loop
+	 *  aLoopEnd - Sample just past the end of the loop (0 = loop the whole file)
+	 */
+	void SetLoopPoints(unsigned long aLoopStart, unsigned long aLoopEnd);
+
+	/**
+	 * Fetch a description of the audio in the file. SD files can seek
+	 * directly and know their exact length.
+	 */
+	virtual tAudioFormat GetFormat();
+
+	/**
+	 * Register the file's read buffer with an I/O scheduler.
+	 * Args:
+	 *   apScheduler - Scheduler to register with, or nullptr to unregister
+	 *   aBytesPerSecond - How fast data will be consumed during playback
+	 */
+	virtual void SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond);
+
+	/**
+	 * Set where the file reports end of file and loop wrap events.
+	 * Args:
+	 *   apSink - Receiver of the events, or nullptr to stop reporting
+	 */
+	virtual void SetEventSink(IWavFileEventSink* apSink);
+
 protected:
 
 	/**
@@ -171,16 +219,59 @@ protected:
 	 */
 	SDWavFile();
 
+	/**
+	 * Create the file reader for mpFileHandle. It is built in the file's own
+	 * storage when NRF52AUDIO_STATIC_ALLOC is defined.
+	 * Args:
+	 *  aRegionStart - Offset in the file where the reader's data begins
+	 *  aRegionSize - Number of bytes the reader can read
+	 */
+	void CreateFileReader(uint32_t aRegionStart = 0, uint32_t aRegionSize = BFR_WHOLE_FILE);
+
+	/**
+	 * Destroy the file reader, if there is one.
+	 */
+	void DestroyFileReader();
+
 	/**
 	 * Read and store the wav file header.
 	 */
 	void ReadHeader();
 
 	/**
-	 * Read and store the data block header.
+	 * Find the data block and store its header. Chunks between the format
+	 * chunk and the data block (such as the "fact" chunk G.711 converters
+	 * add) are skipped. Leaves the read position at the start of the data.
 	 */
 	void ReadDataHeader();
 
+	/**
+	 * Read one sample from the file and convert it to 16-bit PCM.
+	 * Handles 16-bit PCM, 8-bit PCM and 8-bit G.711 (mu-law and A-law).
+	 * Args:
+	 *  apSample - Location to store the decoded sample
+	 */
+	void FetchRawSample(int16_t* apSample);
+
+	/**
+	 * Called after each sample is read. Loops back to the start if the data
+	 * ran out and looping is enabled, and reports what happened.
+	 */
+	void HandleEndOfData();
+
+	/**
+	 * Fetch where the sample data ends.
+	 * Returns: Byte offset from the start of the file, just past the last whole sample
+	 */
+	uint32_t GetDataEnd();
+
+	/**
+	 * Send an event to the event sink, if there is one.
+	 * Args:
+	 *  aEvent - Event to report
+	 */
+	void ReportEvent(EWavFileEvent aEvent);
+
 	/**
 	 * Byte swap the 16-bit words in an I2S sample
 	 */
@@ -194,12 +285,18 @@ protected:
 	//Data block header
 	tWavDataHeader mDataHeader;
 
-	//File handle
-	File mFileHandle;
+	//File handle, shared with other readers of the same file
+	File* mpFileHandle;
+
+	//Handle used when no file is open, never opened
+	static File sNullFileHandle;
 
-	//Bytes per sample (should always be 2)
+	//Bytes per sample stored in the file (2 for 16-bit PCM, 1 for 8-bit PCM and G.711)
 	int mBytesPerSample;
 
+	//Byte offset of the first sample (44 for a canonical wav file)
+	uint32_t mDataStart;
+
 	//Volume (0.0 to 1.0)
 	float mVolume;
 
@@ -218,6 +315,17 @@ protected:
 	//Manage buffering the file data
 	BufferedFileReader* mpFileReader;
 
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	//Storage the file reader is built in
+	alignas(BufferedFileReader) uint8_t maFileReaderStorage[sizeof(BufferedFileReader)];
+#endif
+
+	//Scheduler the file reader is registered with (nullptr if none)
+	IOScheduler* mpIOScheduler;
+
+	//Receiver of playback events (nullptr if none)
+	IWavFileEventSink* mpEventSink;
+
 	//Last fetched sample
 	int16_t mLastSample;
 
@@ -230,6 +338,10 @@ protected:
 	//Apply de-pop to end of file
 	bool mDepopEnd;
 
+	//Loop points in samples (mLoopEnd is 0 to loop the whole file)
+	unsigned long mLoopStart;
+	unsigned long mLoopEnd;
+
 };
 
 #endif /* SDWAVFILE_H_ */
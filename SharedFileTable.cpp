@@ -0,0 +1,99 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * SharedFileTable.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "SharedFileTable.h"
+
+SharedFileTable::tSharedFile SharedFileTable::saFiles[MAX_SHARED_FILES];
+
+File* SharedFileTable::Acquire(const char* apFilePath)
+{
+	bool lIsShareable = strlen(apFilePath) < SHARED_FILE_PATH_SIZE;
+	int lFreeIdx = -1;
+
+	for(int lIdx = 0; lIdx < MAX_SHARED_FILES; lIdx++)
+	{
+		if(0 == saFiles[lIdx].mRefCount)
+		{
+			if(lFreeIdx < 0)
+			{
+				lFreeIdx = lIdx;
+			}
+		}
+		else if(lIsShareable && 0 == strcmp(saFiles[lIdx].maPath, apFilePath))
+		{
+			//Already open, share it
+			saFiles[lIdx].mRefCount++;
+			return &saFiles[lIdx].mFileHandle;
+		}
+	}
+
+	if(lFreeIdx < 0)
+	{
+		return nullptr; //Table is full
+	}
+
+	tSharedFile& lrEntry = saFiles[lFreeIdx];
+	lrEntry.mFileHandle = SD.open(apFilePath, FILE_READ);
+	if(!lrEntry.mFileHandle)
+	{
+		return nullptr;
+	}
+
+	//Paths that are too long get an empty name so they never match
+	lrEntry.maPath[0] = '\0';
+	if(lIsShareable)
+	{
+		strcpy(lrEntry.maPath, apFilePath);
+	}
+	lrEntry.mRefCount = 1;
+
+	return &lrEntry.mFileHandle;
+}
+
+void SharedFileTable::Release(File* apFileHandle)
+{
+	for(int lIdx = 0; lIdx < MAX_SHARED_FILES; lIdx++)
+	{
+		if(&saFiles[lIdx].mFileHandle == apFileHandle && saFiles[lIdx].mRefCount > 0)
+		{
+			saFiles[lIdx].mRefCount--;
+			if(0 == saFiles[lIdx].mRefCount)
+			{
+				saFiles[lIdx].mFileHandle.close();
+			}
+			return;
+		}
+	}
+}
+
+int SharedFileTable::GetNumOpen()
+{
+	int lNumOpen = 0;
+	for(int lIdx = 0; lIdx < MAX_SHARED_FILES; lIdx++)
+	{
+		if(saFiles[lIdx].mRefCount > 0)
+		{
+			lNumOpen++;
+		}
+	}
+
+	return lNumOpen;
+}
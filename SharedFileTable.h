@@ -0,0 +1,86 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * SharedFileTable.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _SHAREDFILETABLE_H_
+#define _SHAREDFILETABLE_H_
+
+#include <Arduino.h>
+#include <SD.h>
+
+//Maximum number of distinct files that can be open at once
+#ifndef MAX_SHARED_FILES
+#define MAX_SHARED_FILES 16
+#endif
+
+//Longest path that can be shared (including terminator). Longer paths
+//still get their own handle, they just can't be shared.
+#define SHARED_FILE_PATH_SIZE 64
+
+/**
+ * This class keeps a table of open SD files so that several readers of the
+ * same file share one handle. SD FAT limits the number of open files and
+ * every handle costs RAM, so retriggering a sound on several voices should
+ * not open it again. Each reader keeps its own position and block buffer
+ * (see BufferedFileReader), the handle is only used for the actual reads.
+ */
+class SharedFileTable
+{
+public:
+	/**
+	 * Fetch a handle for a file, opening it only if it isn't open already.
+	 * Every call must be matched with a call to Release().
+	 * Args:
+	 *  apFilePath - Name of file to open
+	 * Returns: Pointer to the shared handle, or nullptr if the file could not
+	 *          be opened or the table is full
+	 */
+	static File* Acquire(const char* apFilePath);
+
+	/**
+	 * Give up a handle fetched with Acquire(). The file is closed when
+	 * the last user releases it.
+	 * Args:
+	 *  apFileHandle - Handle to release
+	 */
+	static void Release(File* apFileHandle);
+
+	/**
+	 * Fetch the number of distinct files currently open.
+	 */
+	static int GetNumOpen();
+
+protected:
+
+	struct tSharedFile
+	{
+		//Path the file was opened with
+		char maPath[SHARED_FILE_PATH_SIZE];
+		//Shared file handle
+		File mFileHandle;
+		//Number of users, 0 means the slot is free
+		int mRefCount;
+	};
+
+	//Table of open files
+	static tSharedFile saFiles[MAX_SHARED_FILES];
+};
+
+#endif /* _SHAREDFILETABLE_H_ */
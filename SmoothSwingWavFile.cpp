@@ -0,0 +1,429 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * SmoothSwingWavFile.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include <Arduino.h>
+#include "SmoothSwingWavFile.h"
+
+SmoothSwingWavFile::SmoothSwingWavFile(const char* aLowFilePath, const char* aHighFilePath)
+{
+	mNumLoops = 0;
+	mSwingPosition = 0.0;
+	mVolume = 1.0;
+	mIsLooping = true;
+	mPosition = 0;
+	mpEventSink = nullptr;
+
+	for(int lIdx = 0; lIdx < SMOOTH_SWING_MAX_LOOPS; lIdx++)
+	{
+		mpLoops[lIdx] = nullptr;
+		maGains[lIdx] = 0;
+		maTargetGains[lIdx] = 0;
+	}
+
+	AddLoop(aLowFilePath);
+	AddLoop(aHighFilePath);
+
+	//Start at the target instead of ramping up from silence
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		maGains[lIdx] = maTargetGains[lIdx];
+	}
+}
+
+SmoothSwingWavFile::~SmoothSwingWavFile()
+{
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+#ifdef NRF52AUDIO_STATIC_ALLOC
+		mpLoops[lIdx]->~SDWavFile();
+#else
+		delete mpLoops[lIdx];
+#endif
+	}
+}
+
+bool SmoothSwingWavFile::AddLoop(const char* aFilePath)
+{
+	if(mNumLoops >= SMOOTH_SWING_MAX_LOOPS)
+	{
+		return false;
+	}
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	SDWavFile* lpLoop = new(maLoopStorage[mNumLoops]) SDWavFile(aFilePath);
+#else
+	SDWavFile* lpLoop = new SDWavFile(aFilePath);
+#endif
+	lpLoop->SetLooping(mIsLooping);
+
+	//Join in step with the loops already in the bank
+	if(mPosition > 0)
+	{
+		SeekLoop(lpLoop, mPosition);
+	}
+	if(mNumLoops > 0 && mpLoops[0]->IsPaused())
+	{
+		lpLoop->Pause();
+	}
+
+	mpLoops[mNumLoops++] = lpLoop;
+	UpdateTargetGains();
+
+	return true;
+}
+
+void SmoothSwingWavFile::SetSwing(float aPosition)
+{
+	if(aPosition < 0.0)
+	{
+		aPosition = 0.0;
+	}
+	else if(aPosition > mNumLoops - 1)
+	{
+		aPosition = mNumLoops - 1;
+	}
+
+	mSwingPosition = aPosition;
+	UpdateTargetGains();
+}
+
+File& SmoothSwingWavFile::GetFileHandle()
+{
+	return mpLoops[0]->GetFileHandle();
+}
+
+const tWavFileHeader& SmoothSwingWavFile::GetHeader()
+{
+	return mpLoops[0]->GetHeader();
+}
+
+const tWavDataHeader& SmoothSwingWavFile::GetDataHeader()
+{
+	return mpLoops[0]->GetDataHeader();
+}
+
+void SmoothSwingWavFile::Close()
+{
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		mpLoops[lIdx]->Close();
+	}
+}
+
+bool SmoothSwingWavFile::SeekStartOfData()
+{
+	bool lSuccess = true;
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		lSuccess &= mpLoops[lIdx]->SeekStartOfData();
+	}
+	mPosition = 0;
+
+	return lSuccess;
+}
+
+bool SmoothSwingWavFile::SeekToSample(unsigned long aSample)
+{
+	bool lSuccess = true;
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		lSuccess &= SeekLoop(mpLoops[lIdx], aSample);
+	}
+	mPosition = aSample;
+
+	return lSuccess;
+}
+
+int SmoothSwingWavFile::Available()
+{
+	int lAvail = 0;
+
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		int lLoopAvail = mpLoops[lIdx]->Available();
+		if(lLoopAvail > lAvail)
+		{
+			lAvail = lLoopAvail;
+		}
+	}
+
+	return lAvail;
+}
+
+int SmoothSwingWavFile::Fetch16BitSamples(int16_t* apBuffer, int aNumSamples)
+{
+	return Render(apBuffer, aNumSamples, 1, nullptr);
+}
+
+int SmoothSwingWavFile::Render(int16_t* apBuffer, int aNumFrames, int aNumChannels, bool* apEnded)
+{
+	if(1 != aNumChannels)
+	{
+		return ISDWavFile::Render(apBuffer, aNumFrames, aNumChannels, apEnded);
+	}
+
+	int lNumMixed = 0;
+
+	while(lNumMixed < aNumFrames)
+	{
+		int lNumToMix = aNumFrames - lNumMixed;
+		if(lNumToMix > SMOOTH_SWING_BLOCK_SIZE)
+		{
+			lNumToMix = SMOOTH_SWING_BLOCK_SIZE;
+		}
+
+		int lNumBlockMixed = MixBlock(&apBuffer[lNumMixed], lNumToMix);
+		lNumMixed += lNumBlockMixed;
+
+		if(lNumBlockMixed < lNumToMix)
+		{
+			break; //All loops are out of data
+		}
+	}
+
+	mPosition += lNumMixed;
+
+	if(nullptr != apEnded)
+	{
+		*apEnded = lNumMixed < aNumFrames;
+	}
+
+	return lNumMixed;
+}
+
+tAudioFormat SmoothSwingWavFile::GetFormat()
+{
+	tAudioFormat lFormat = mpLoops[0]->GetFormat();
+	lFormat.mCapabilities |= eeCapNativeRender;
+
+	return lFormat;
+}
+
+void SmoothSwingWavFile::SetVolume(float aVolume)
+{
+	if(aVolume <= 0.0)
+	{
+		mVolume = 0.0;
+	}
+	else if(aVolume >= 1.0)
+	{
+		mVolume = 1.0;
+	}
+	else
+	{
+		mVolume = aVolume;
+	}
+
+	UpdateTargetGains();
+}
+
+void SmoothSwingWavFile::SetLooping(bool aLoopingEnable)
+{
+	mIsLooping = aLoopingEnable;
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		mpLoops[lIdx]->SetLooping(aLoopingEnable);
+	}
+}
+
+void SmoothSwingWavFile::Pause()
+{
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		mpLoops[lIdx]->Pause();
+	}
+}
+
+bool SmoothSwingWavFile::IsPaused()
+{
+	return mpLoops[0]->IsPaused();
+}
+
+void SmoothSwingWavFile::UnPause()
+{
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		mpLoops[lIdx]->UnPause();
+	}
+}
+
+bool SmoothSwingWavFile::IsEnded()
+{
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		if(!mpLoops[lIdx]->IsEnded())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void SmoothSwingWavFile::SetDePop(bool aStart, bool aEnd)
+{
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		mpLoops[lIdx]->SetDePop(aStart, aEnd);
+	}
+}
+
+void SmoothSwingWavFile::Skip16BitSamples(int aNumSamples)
+{
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		mpLoops[lIdx]->Skip16BitSamples(aNumSamples);
+	}
+	mPosition += aNumSamples;
+}
+
+void SmoothSwingWavFile::SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond)
+{
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		mpLoops[lIdx]->SetIOScheduler(apScheduler, aBytesPerSecond);
+	}
+}
+
+void SmoothSwingWavFile::SetEventSink(IWavFileEventSink* apSink)
+{
+	mpEventSink = apSink;
+	mpLoops[0]->SetEventSink(nullptr != apSink ? this : nullptr);
+}
+
+void SmoothSwingWavFile::OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition)
+{
+	if(nullptr != mpEventSink)
+	{
+		mpEventSink->OnWavFileEvent(this, aEvent, aSamplePosition);
+	}
+}
+
+bool SmoothSwingWavFile::SeekLoop(SDWavFile* apLoop, unsigned long aSample)
+{
+	unsigned long lNumSamples = apLoop->GetFormat().mNumSamples;
+	if(mIsLooping && lNumSamples > 0)
+	{
+		aSample %= lNumSamples;
+	}
+
+	return apLoop->SeekToSample(aSample);
+}
+
+void SmoothSwingWavFile::UpdateTargetGains()
+{
+	int lLowLoop = (int)mSwingPosition;
+	if(lLowLoop >= mNumLoops - 1)
+	{
+		lLowLoop = mNumLoops > 1 ? mNumLoops - 2 : 0;
+	}
+	float lFade = mSwingPosition - lLowLoop;
+
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		float lGain = 0.0;
+
+		//Equal power crossfade between the two loops either side of the position
+		if(lIdx == lLowLoop)
+		{
+			lGain = cosf(lFade * (float)HALF_PI);
+		}
+		else if(lIdx == lLowLoop + 1)
+		{
+			lGain = sinf(lFade * (float)HALF_PI);
+		}
+
+		maTargetGains[lIdx] = (int32_t)(lGain * mVolume * 32767.0f + 0.5f);
+	}
+}
+
+int SmoothSwingWavFile::MixBlock(int16_t* apBuffer, int aNumFrames)
+{
+	int lNumMixed = 0;
+	bool lIsFirst = true;
+
+	for(int lIdx = 0; lIdx < mNumLoops; lIdx++)
+	{
+		int32_t lStartGain = maGains[lIdx];
+		int32_t lEndGain = maTargetGains[lIdx];
+		maGains[lIdx] = lEndGain;
+
+		//Silent for the whole block, just keep it in step
+		if(0 == lStartGain && 0 == lEndGain)
+		{
+			if(!mpLoops[lIdx]->IsEnded())
+			{
+				mpLoops[lIdx]->Skip16BitSamples(aNumFrames);
+			}
+			continue;
+		}
+
+		int lNumRendered = mpLoops[lIdx]->Render(maLoopBlock, aNumFrames);
+		if(lNumRendered > lNumMixed)
+		{
+			//Samples other loops didn't reach are silent
+			for(int lSample = lIsFirst ? 0 : lNumMixed; lSample < lNumRendered; lSample++)
+			{
+				maMixBlock[lSample] = 0;
+			}
+			lNumMixed = lNumRendered;
+		}
+		else if(lIsFirst)
+		{
+			lNumMixed = lNumRendered;
+		}
+		lIsFirst = false;
+
+		//Ramp the gain across the block (Q15 gain with 16 more fraction bits)
+		int32_t lGain = lStartGain * 65536;
+		int32_t lGainStep = (lEndGain - lStartGain) * 65536 / aNumFrames;
+
+		for(int lSample = 0; lSample < lNumRendered; lSample++)
+		{
+			maMixBlock[lSample] += (maLoopBlock[lSample] * (lGain >> 16)) >> 15;
+			lGain += lGainStep;
+		}
+	}
+
+	//A silent loop that is still playing keeps the swing going
+	if(lNumMixed < aNumFrames && !IsEnded())
+	{
+		memset(&maMixBlock[lNumMixed], 0, (aNumFrames - lNumMixed) * sizeof(int32_t));
+		lNumMixed = aNumFrames;
+	}
+
+	for(int lSample = 0; lSample < lNumMixed; lSample++)
+	{
+		int32_t lMixed = maMixBlock[lSample];
+		if(lMixed > INT16_MAX)
+		{
+			lMixed = INT16_MAX;
+		}
+		else if(lMixed < INT16_MIN)
+		{
+			lMixed = INT16_MIN;
+		}
+		apBuffer[lSample] = (int16_t)lMixed;
+	}
+
+	return lNumMixed;
+}
@@ -0,0 +1,273 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * SmoothSwingWavFile.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _SMOOTHSWINGWAVFILE_H_
+#define _SMOOTHSWINGWAVFILE_H_
+
+#include "ISDWavFile.h"
+#include "SDWavFile.h"
+
+//Maximum number of loops in one bank
+#define SMOOTH_SWING_MAX_LOOPS 4
+
+//Samples mixed at a time. Gains ramp from their old to their new value
+//over each block, so this is also the longest ramp.
+#define SMOOTH_SWING_BLOCK_SIZE 32
+
+/**
+ * Plays a bank of looping files (typically a low/high swing pair) in lockstep
+ * and crossfades between them from a single control value, so the whole swing
+ * takes one player channel:
+ *
+ *   SmoothSwingWavFile* lpSwing = new SmoothSwingWavFile("swingl.wav", "swingh.wav");
+ *   lpPlayer->SetWavFile(lpSwing, 1);
+ *   ...
+ *   lpSwing->SetSwing(lDirection); //0.0 = all low, 1.0 = all high
+ *   lpSwing->SetVolume(lSpeed);    //Swing speed sets how loud the swing is
+ *
+ * All loops advance by the same number of samples, so paired loops stay
+ * aligned. Gains are ramped across each block to avoid zipper noise, and loops
+ * that are silent for a whole block are skipped instead of read. The crossfade
+ * is equal power, so at most two loops are read at any time.
+ * The loops are owned by this object.
+ */
+class SmoothSwingWavFile : public ISDWavFile, protected IWavFileEventSink
+{
+public:
+
+	/**
+	 * Constructor. Both files are looped.
+	 * Args:
+	 *  aLowFilePath - Loop heard at swing position 0.0
+	 *  aHighFilePath - Loop heard at swing position 1.0
+	 */
+	SmoothSwingWavFile(const char* aLowFilePath, const char* aHighFilePath);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~SmoothSwingWavFile();
+
+	/**
+	 * Add another loop to the end of the bank. It is heard at swing position
+	 * GetNumLoops() - 1 once added, and starts in step with the other loops.
+	 * Args:
+	 *  aFilePath - Loop to add
+	 * Returns: TRUE if added, FALSE if the bank is full
+	 */
+	bool AddLoop(const char* aFilePath);
+
+	/**
+	 * Fetch the number of loops in the bank.
+	 */
+	inline int GetNumLoops()
+	{
+		return mNumLoops;
+	}
+
+	/**
+	 * Set the swing position. Whole numbers play one loop, values between
+	 * crossfade the two loops either side. Takes effect over the next block.
+	 * Args:
+	 *  aPosition - 0.0 (first loop) to GetNumLoops() - 1 (last loop)
+	 */
+	void SetSwing(float aPosition);
+
+	/**
+	 * Fetch the first loop's file handle.
+	 */
+	virtual File& GetFileHandle();
+
+	/**
+	 * Fetch the first loop's file header.
+	 */
+	virtual const tWavFileHeader& GetHeader();
+
+	/**
+	 * Fetch the first loop's data block header.
+	 */
+	virtual const tWavDataHeader& GetDataHeader();
+
+	/**
+	 * Close all loops.
+	 */
+	virtual void Close();
+
+	/**
+	 * Restart all loops together.
+	 */
+	virtual bool SeekStartOfData();
+
+	/**
+	 * Move all loops to the same sample.
+	 */
+	virtual bool SeekToSample(unsigned long aSample);
+
+	/**
+	 * Fetch the greatest number of bytes left in any loop.
+	 */
+	virtual int Available();
+
+	/**
+	 * Fetch the mixed loops as 16-bit samples
+	 * Args:
+	 *   apBuffer - Pointer to buffer to fill with data
+	 *   aNumSamples - How many samples to read
+	 * Returns: Number of samples filled
+	 */
+	virtual int Fetch16BitSamples(int16_t* apBuffer, int aNumSamples);
+
+	/**
+	 * Render the mixed loops.
+	 */
+	virtual int Render(int16_t* apBuffer, int aNumFrames, int aNumChannels = 1, bool* apEnded = nullptr);
+
+	/**
+	 * Fetch the first loop's format. Rendering is done natively.
+	 */
+	virtual tAudioFormat GetFormat();
+
+	/**
+	 * Set the level of the whole swing. Ramped like the crossfade, so it can be
+	 * driven straight from the swing speed.
+	 * Args:
+	 *   aVolume - Any value between 1.0 (max) and 0.0 (mute)
+	 */
+	virtual void SetVolume(float aVolume);
+
+	/**
+	 * Enable/Disable looping of all loops. Looping is on by default.
+	 */
+	virtual void SetLooping(bool aLoopingEnable);
+
+	/**
+	 * Pause all loops.
+	 */
+	virtual void Pause();
+
+	/**
+	 * Check if the loops are paused.
+	 */
+	virtual bool IsPaused();
+
+	/**
+	 * Unpause all loops.
+	 */
+	virtual void UnPause();
+
+	/**
+	 * Check if all loops have run out of data.
+	 * NOTE: This will always be false if looping is enabled.
+	 */
+	virtual bool IsEnded();
+
+	/**
+	 * Enable/Disable the De-pop algorithm of all loops.
+	 */
+	virtual void SetDePop(bool aStart, bool aEnd);
+
+	/**
+	 * Skip samples in all loops.
+	 * Args:
+	 *  aNumSamples - Number of 16-bit samples to skip.
+	 */
+	virtual void Skip16BitSamples(int aNumSamples);
+
+	/**
+	 * Register all loops' read buffers with an I/O scheduler.
+	 * Args:
+	 *   apScheduler - Scheduler to register with, or nullptr to unregister
+	 *   aBytesPerSecond - How fast one loop's data will be consumed during playback
+	 */
+	virtual void SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond);
+
+	/**
+	 * Set where events are reported. The loops run in lockstep, so only the
+	 * first loop's events are reported.
+	 * Args:
+	 *   apSink - Receiver of the events, or nullptr to stop reporting
+	 */
+	virtual void SetEventSink(IWavFileEventSink* apSink);
+
+protected:
+
+	/**
+	 * Receives events from the first loop and reports them as coming from this file.
+	 */
+	virtual void OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition);
+
+	/**
+	 * Work out each loop's target gain from the swing position and volume.
+	 */
+	void UpdateTargetGains();
+
+	/**
+	 * Mix one block of all loops.
+	 * Args:
+	 *  apBuffer - Where to put the mixed samples
+	 *  aNumFrames - Samples to mix, at most SMOOTH_SWING_BLOCK_SIZE
+	 * Returns: Number of samples mixed (fewer only when all loops ended)
+	 */
+	int MixBlock(int16_t* apBuffer, int aNumFrames);
+
+	/**
+	 * Move one loop to a position. When looping, each loop wraps at its own
+	 * length, so loops of different lengths stay in step with each other.
+	 * Args:
+	 *  apLoop - Loop to move
+	 *  aSample - Samples since the start of the bank
+	 * Returns: TRUE if successful, FALSE otherwise
+	 */
+	bool SeekLoop(SDWavFile* apLoop, unsigned long aSample);
+
+	//Loops in the bank
+	SDWavFile* mpLoops[SMOOTH_SWING_MAX_LOOPS];
+	int mNumLoops;
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	//Storage the loops are built in
+	alignas(SDWavFile) uint8_t maLoopStorage[SMOOTH_SWING_MAX_LOOPS][sizeof(SDWavFile)];
+#endif
+
+	//Gains the loops had at the end of the last block (Q15)
+	int32_t maGains[SMOOTH_SWING_MAX_LOOPS];
+	//Gains the loops ramp to over the next block (Q15)
+	volatile int32_t maTargetGains[SMOOTH_SWING_MAX_LOOPS];
+
+	//Control values
+	float mSwingPosition;
+	float mVolume;
+
+	//TRUE if the loops are looped
+	bool mIsLooping;
+	//Samples the loops have advanced since the start (or the last seek)
+	unsigned long mPosition;
+
+	//Samples from one loop
+	int16_t maLoopBlock[SMOOTH_SWING_BLOCK_SIZE];
+	//Loops mixed so far
+	int32_t maMixBlock[SMOOTH_SWING_BLOCK_SIZE];
+
+	//Receiver of playback events (nullptr if none)
+	IWavFileEventSink* mpEventSink;
+};
+
+#endif /* _SMOOTHSWINGWAVFILE_H_ */
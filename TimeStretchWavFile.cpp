@@ -0,0 +1,397 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * TimeStretchWavFile.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include <Arduino.h>
+#include "TimeStretchWavFile.h"
+
+#define TIME_STRETCH_BUFFER_MASK (TIME_STRETCH_BUFFER_SIZE - 1)
+
+int16_t TimeStretchWavFile::saWindow[TIME_STRETCH_GRAIN_SIZE];
+bool TimeStretchWavFile::sIsWindowReady = false;
+
+TimeStretchWavFile::TimeStretchWavFile(ISDWavFile* apSource)
+{
+	mpSource = apSource;
+	mpEventSink = nullptr;
+	mQuality = eeQualityFull;
+	mPitchStep = 1UL << 16;
+	mAnalysisStep = (uint32_t)TIME_STRETCH_HOP_SIZE << 16;
+
+	if(!sIsWindowReady)
+	{
+		//Periodic Hann window, two of them overlapping by half add up to exactly 1.0
+		for(int lIdx = 0; lIdx < TIME_STRETCH_GRAIN_SIZE; lIdx++)
+		{
+			float lWindow = 0.5f - 0.5f * cosf(2.0f * (float)PI * lIdx / TIME_STRETCH_GRAIN_SIZE);
+			saWindow[lIdx] = (int16_t)(lWindow * 32767.0f + 0.5f);
+		}
+		sIsWindowReady = true;
+	}
+
+	Reset();
+}
+
+TimeStretchWavFile::~TimeStretchWavFile()
+{
+	//Nothing to do, the source belongs to the caller
+}
+
+void TimeStretchWavFile::SetPitch(float aRatio)
+{
+	if(aRatio < TIME_STRETCH_MIN_RATIO)
+	{
+		aRatio = TIME_STRETCH_MIN_RATIO;
+	}
+	else if(aRatio > TIME_STRETCH_MAX_RATIO)
+	{
+		aRatio = TIME_STRETCH_MAX_RATIO;
+	}
+
+	mPitchStep = (uint32_t)(aRatio * 65536.0f + 0.5f);
+}
+
+void TimeStretchWavFile::SetTempo(float aRatio)
+{
+	if(aRatio < TIME_STRETCH_MIN_RATIO)
+	{
+		aRatio = TIME_STRETCH_MIN_RATIO;
+	}
+	else if(aRatio > TIME_STRETCH_MAX_RATIO)
+	{
+		aRatio = TIME_STRETCH_MAX_RATIO;
+	}
+
+	mAnalysisStep = (uint32_t)(aRatio * TIME_STRETCH_HOP_SIZE * 65536.0f + 0.5f);
+}
+
+void TimeStretchWavFile::Close()
+{
+	mpSource->Close();
+	Reset();
+}
+
+File& TimeStretchWavFile::GetFileHandle()
+{
+	return mpSource->GetFileHandle();
+}
+
+const tWavFileHeader& TimeStretchWavFile::GetHeader()
+{
+	return mpSource->GetHeader();
+}
+
+const tWavDataHeader& TimeStretchWavFile::GetDataHeader()
+{
+	return mpSource->GetDataHeader();
+}
+
+bool TimeStretchWavFile::SeekStartOfData()
+{
+	Reset();
+	return mpSource->SeekStartOfData();
+}
+
+bool TimeStretchWavFile::SeekToSample(unsigned long aSample)
+{
+	Reset();
+	return mpSource->SeekToSample(aSample);
+}
+
+int TimeStretchWavFile::Available()
+{
+	return mpSource->Available();
+}
+
+int TimeStretchWavFile::Fetch16BitSamples(int16_t* apBuffer, int aNumSamples)
+{
+	return Render(apBuffer, aNumSamples, 1, nullptr);
+}
+
+int TimeStretchWavFile::Render(int16_t* apBuffer, int aNumFrames, int aNumChannels, bool* apEnded)
+{
+	if(1 != aNumChannels)
+	{
+		return ISDWavFile::Render(apBuffer, aNumFrames, aNumChannels, apEnded);
+	}
+
+	int lFrame = 0;
+
+	for(; lFrame < aNumFrames; lFrame++)
+	{
+		if(0 == mHopPos)
+		{
+			StartGrain();
+		}
+
+		int32_t lSum = 0;
+		bool lIsPlaying = false;
+
+		for(int lIdx = 0; lIdx < 2; lIdx++)
+		{
+			tGrain& lGrain = maGrains[lIdx];
+			if(lGrain.mWindowPos >= TIME_STRETCH_GRAIN_SIZE)
+			{
+				continue;
+			}
+
+			//Make sure both samples to interpolate between are in the buffer
+			if((int32_t)(lGrain.mReadPos + 2 - mBufferEnd) > 0)
+			{
+				FillBuffer(lGrain.mReadPos + 2);
+			}
+
+			int32_t lSample0 = maBuffer[lGrain.mReadPos & TIME_STRETCH_BUFFER_MASK];
+			int32_t lSample1 = maBuffer[(lGrain.mReadPos + 1) & TIME_STRETCH_BUFFER_MASK];
+			int32_t lSample = lSample0 + (((lSample1 - lSample0) * (int32_t)(lGrain.mReadFrac >> 1)) >> 15);
+
+			lSum += (lSample * saWindow[lGrain.mWindowPos]) >> 15;
+
+			lGrain.mReadFrac += mPitchStep;
+			lGrain.mReadPos += lGrain.mReadFrac >> 16;
+			lGrain.mReadFrac &= 0xFFFF;
+			lGrain.mWindowPos++;
+			lIsPlaying = true;
+		}
+
+		if(!lIsPlaying)
+		{
+			break; //Source is out of data and the last grain has finished
+		}
+
+		if(lSum > INT16_MAX)
+		{
+			lSum = INT16_MAX;
+		}
+		else if(lSum < INT16_MIN)
+		{
+			lSum = INT16_MIN;
+		}
+		apBuffer[lFrame] = (int16_t)lSum;
+
+		if(++mHopPos >= TIME_STRETCH_HOP_SIZE)
+		{
+			mHopPos = 0;
+		}
+	}
+
+	if(nullptr != apEnded)
+	{
+		*apEnded = lFrame < aNumFrames;
+	}
+
+	return lFrame;
+}
+
+tAudioFormat TimeStretchWavFile::GetFormat()
+{
+	tAudioFormat lFormat = mpSource->GetFormat();
+	lFormat.mCapabilities &= ~eeCapExactLength;
+	lFormat.mCapabilities |= eeCapNativeRender;
+
+	return lFormat;
+}
+
+void TimeStretchWavFile::SetVolume(float aVolume)
+{
+	mpSource->SetVolume(aVolume);
+}
+
+void TimeStretchWavFile::SetLooping(bool aLoopingEnable)
+{
+	mpSource->SetLooping(aLoopingEnable);
+}
+
+void TimeStretchWavFile::Pause()
+{
+	mpSource->Pause();
+}
+
+bool TimeStretchWavFile::IsPaused()
+{
+	return mpSource->IsPaused();
+}
+
+void TimeStretchWavFile::UnPause()
+{
+	mpSource->UnPause();
+}
+
+bool TimeStretchWavFile::IsEnded()
+{
+	return mIsSourceEnded
+		&& maGrains[0].mWindowPos >= TIME_STRETCH_GRAIN_SIZE
+		&& maGrains[1].mWindowPos >= TIME_STRETCH_GRAIN_SIZE
+		&& (int32_t)(mAnalysisPos - mSourceEnd) >= 0;
+}
+
+void TimeStretchWavFile::SetDePop(bool aStart, bool aEnd)
+{
+	mpSource->SetDePop(aStart, aEnd);
+}
+
+void TimeStretchWavFile::Skip16BitSamples(int aNumSamples)
+{
+	//Grains overlap, so skipping means rendering and throwing the samples away
+	int16_t laScratch[TIME_STRETCH_FILL_SIZE];
+
+	while(aNumSamples > 0)
+	{
+		int lNumToSkip = aNumSamples < TIME_STRETCH_FILL_SIZE ? aNumSamples : TIME_STRETCH_FILL_SIZE;
+		if(0 == Render(laScratch, lNumToSkip))
+		{
+			break;
+		}
+		aNumSamples -= lNumToSkip;
+	}
+}
+
+void TimeStretchWavFile::SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond)
+{
+	mpSource->SetIOScheduler(apScheduler, aBytesPerSecond);
+}
+
+float TimeStretchWavFile::GetPlaybackSpeed()
+{
+	return mpSource->GetPlaybackSpeed() * (float)mAnalysisStep / ((float)TIME_STRETCH_HOP_SIZE * 65536.0f);
+}
+
+void TimeStretchWavFile::SetEventSink(IWavFileEventSink* apSink)
+{
+	mpEventSink = apSink;
+	mpSource->SetEventSink(nullptr != apSink ? this : nullptr);
+}
+
+void TimeStretchWavFile::SetQuality(EQualityLevel aLevel)
+{
+	mQuality = aLevel;
+	mpSource->SetQuality(aLevel);
+}
+
+void TimeStretchWavFile::OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition)
+{
+	if(nullptr != mpEventSink)
+	{
+		mpEventSink->OnWavFileEvent(this, aEvent, aSamplePosition);
+	}
+}
+
+void TimeStretchWavFile::Reset()
+{
+	memset(maBuffer, 0, sizeof(maBuffer));
+	mBufferEnd = 0;
+	mIsSourceEnded = false;
+	mSourceEnd = 0;
+	mAnalysisPos = 0;
+	mAnalysisFrac = 0;
+	mHopPos = 0;
+
+	for(int lIdx = 0; lIdx < 2; lIdx++)
+	{
+		maGrains[lIdx].mReadPos = 0;
+		maGrains[lIdx].mReadFrac = 0;
+		maGrains[lIdx].mWindowPos = TIME_STRETCH_GRAIN_SIZE;
+	}
+}
+
+void TimeStretchWavFile::FillBuffer(uint32_t aEndPos)
+{
+	while((int32_t)(aEndPos - mBufferEnd) > 0)
+	{
+		int16_t* lpFill = &maBuffer[mBufferEnd & TIME_STRETCH_BUFFER_MASK];
+		int lNumRendered = 0;
+
+		if(!mIsSourceEnded)
+		{
+			lNumRendered = mpSource->Render(lpFill, TIME_STRETCH_FILL_SIZE);
+			if(lNumRendered < TIME_STRETCH_FILL_SIZE)
+			{
+				mIsSourceEnded = true;
+				mSourceEnd = mBufferEnd + lNumRendered;
+			}
+		}
+
+		//Grains reading past the end of the source hear silence
+		memset(&lpFill[lNumRendered], 0, (TIME_STRETCH_FILL_SIZE - lNumRendered) * sizeof(int16_t));
+		mBufferEnd += TIME_STRETCH_FILL_SIZE;
+	}
+}
+
+void TimeStretchWavFile::StartGrain()
+{
+	FillBuffer(mAnalysisPos + TIME_STRETCH_SEEK_RANGE + TIME_STRETCH_MATCH_SIZE);
+
+	if(mIsSourceEnded && (int32_t)(mAnalysisPos - mSourceEnd) >= 0)
+	{
+		return; //Nothing left to play, let the last grain fade out
+	}
+
+	//With a hop of half a grain, one of the two grains has just finished
+	bool lIsFirstFree = maGrains[0].mWindowPos >= TIME_STRETCH_GRAIN_SIZE;
+	tGrain& lGrain = lIsFirstFree ? maGrains[0] : maGrains[1];
+	tGrain& lPlaying = lIsFirstFree ? maGrains[1] : maGrains[0];
+
+	lGrain.mReadPos = mAnalysisPos;
+	lGrain.mReadFrac = mAnalysisFrac;
+	lGrain.mWindowPos = 0;
+
+	if(lPlaying.mWindowPos < TIME_STRETCH_GRAIN_SIZE && eeQualityFull == mQuality)
+	{
+		lGrain.mReadPos = FindBestMatch(mAnalysisPos, lPlaying.mReadPos);
+	}
+
+	mAnalysisFrac += mAnalysisStep;
+	mAnalysisPos += mAnalysisFrac >> 16;
+	mAnalysisFrac &= 0xFFFF;
+}
+
+uint32_t TimeStretchWavFile::FindBestMatch(uint32_t aPos, uint32_t aMatchPos)
+{
+	uint32_t lBestPos = aPos;
+
+#if TIME_STRETCH_SEEK_RANGE > 0
+	//Don't search before the start of the source
+	uint32_t lFirstPos = aPos > TIME_STRETCH_SEEK_RANGE ? aPos - TIME_STRETCH_SEEK_RANGE : 0;
+	uint32_t lLastPos = aPos + TIME_STRETCH_SEEK_RANGE;
+	int32_t lBestScore = INT32_MIN;
+
+	//Every other position and sample is enough to find the right phase
+	for(uint32_t lPos = lFirstPos; lPos <= lLastPos; lPos += 2)
+	{
+		int32_t lScore = 0;
+
+		for(int lIdx = 0; lIdx < TIME_STRETCH_MATCH_SIZE; lIdx += 2)
+		{
+			int32_t lSample = maBuffer[(lPos + lIdx) & TIME_STRETCH_BUFFER_MASK];
+			int32_t lMatch = maBuffer[(aMatchPos + lIdx) & TIME_STRETCH_BUFFER_MASK];
+			lScore += (lSample * lMatch) >> 6;
+		}
+
+		if(lScore > lBestScore)
+		{
+			lBestScore = lScore;
+			lBestPos = lPos;
+		}
+	}
+#endif
+
+	return lBestPos;
+}
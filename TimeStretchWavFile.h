@@ -0,0 +1,332 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * TimeStretchWavFile.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _TIMESTRETCHWAVFILE_H_
+#define _TIMESTRETCHWAVFILE_H_
+
+#include "ISDWavFile.h"
+
+//Samples in one grain (must be even). Longer grains smear transients,
+//shorter grains sound rough on low notes. 512 is about 23ms at 22.05KHz.
+#ifndef TIME_STRETCH_GRAIN_SIZE
+#define TIME_STRETCH_GRAIN_SIZE 512
+#endif
+
+//Output samples between grain starts (grains overlap by half)
+#define TIME_STRETCH_HOP_SIZE (TIME_STRETCH_GRAIN_SIZE / 2)
+
+//How far (in source samples, either way) a new grain may be moved to line up
+//with the grain it fades in over (WSOLA). Should cover half the period of the
+//lowest note, 0 turns the search off for plain overlap-add.
+#ifndef TIME_STRETCH_SEEK_RANGE
+#define TIME_STRETCH_SEEK_RANGE 128
+#endif
+
+//Samples compared for each candidate position during the search
+#define TIME_STRETCH_MATCH_SIZE 64
+
+//Source samples kept for the grains to read from (power of 2)
+#define TIME_STRETCH_BUFFER_SIZE (TIME_STRETCH_GRAIN_SIZE * 4)
+
+//Source samples rendered at a time
+#define TIME_STRETCH_FILL_SIZE 64
+
+//Pitch and tempo limits. The buffer is sized so that grains never read
+//data that was already overwritten at these limits.
+#define TIME_STRETCH_MIN_RATIO 0.5
+#define TIME_STRETCH_MAX_RATIO 2.0
+
+static_assert((TIME_STRETCH_BUFFER_SIZE & (TIME_STRETCH_BUFFER_SIZE - 1)) == 0,
+		"TIME_STRETCH_BUFFER_SIZE must be a power of 2");
+static_assert(TIME_STRETCH_BUFFER_SIZE >= TIME_STRETCH_GRAIN_SIZE * TIME_STRETCH_MAX_RATIO
+		+ 2 * TIME_STRETCH_SEEK_RANGE + TIME_STRETCH_MATCH_SIZE + 2 * TIME_STRETCH_FILL_SIZE,
+		"TIME_STRETCH_BUFFER_SIZE is too small for the grain size and seek range");
+static_assert(TIME_STRETCH_BUFFER_SIZE % TIME_STRETCH_FILL_SIZE == 0,
+		"TIME_STRETCH_BUFFER_SIZE must be a multiple of TIME_STRETCH_FILL_SIZE");
+
+/**
+ * Changes the pitch and the tempo (duration) of any ISDWavFile independently,
+ * using granular overlap-add. Short windowed grains are read from the source
+ * at the pitch ratio, while the grain start positions move through the source
+ * at the tempo ratio. Each new grain is nudged to where it best lines up with
+ * the grain it fades in over (WSOLA), which keeps tones from warbling:
+ *
+ *   TimeStretchWavFile* lpSwing = new TimeStretchWavFile(new SDWavFile("swing.wav"));
+ *   lpSwing->SetPitch(1.5); //Higher...
+ *   lpSwing->SetTempo(1.0); //...but just as long
+ *   lpPlayer->SetWavFile(lpSwing, 0);
+ *
+ * All processing is fixed point and memory use is fixed (one sample buffer
+ * of TIME_STRETCH_BUFFER_SIZE per file). The source file is not owned by
+ * this object.
+ */
+class TimeStretchWavFile : public ISDWavFile, protected IWavFileEventSink
+{
+public:
+
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apSource - File to process
+	 */
+	TimeStretchWavFile(ISDWavFile* apSource);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~TimeStretchWavFile();
+
+	/**
+	 * Set the pitch without changing the duration.
+	 * Args:
+	 *  aRatio - Pitch ratio, 1.0 = unchanged, 2.0 = an octave up, 0.5 = an octave down.
+	 *           Clamped to TIME_STRETCH_MIN_RATIO..TIME_STRETCH_MAX_RATIO.
+	 */
+	void SetPitch(float aRatio);
+
+	/**
+	 * Set the tempo without changing the pitch.
+	 * Args:
+	 *  aRatio - Tempo ratio, 1.0 = unchanged, 2.0 = twice as fast (half as long),
+	 *           0.5 = half as fast (twice as long).
+	 *           Clamped to TIME_STRETCH_MIN_RATIO..TIME_STRETCH_MAX_RATIO.
+	 */
+	void SetTempo(float aRatio);
+
+	/**
+	 * Fetch the file being processed.
+	 */
+	inline ISDWavFile* GetSource()
+	{
+		return mpSource;
+	}
+
+	/**
+	 * Close the source file.
+	 */
+	virtual void Close();
+
+	/**
+	 * Fetch the source's file handle.
+	 */
+	virtual File& GetFileHandle();
+
+	/**
+	 * Fetch the source's file header.
+	 */
+	virtual const tWavFileHeader& GetHeader();
+
+	/**
+	 * Fetch the source's data block header.
+	 */
+	virtual const tWavDataHeader& GetDataHeader();
+
+	/**
+	 * Restart the source and drop all grains.
+	 */
+	virtual bool SeekStartOfData();
+
+	/**
+	 * Move the source to any sample and drop all grains.
+	 * Args:
+	 *  aSample - Source sample to continue from
+	 */
+	virtual bool SeekToSample(unsigned long aSample);
+
+	/**
+	 * Fetch how many bytes the source has left. The number of samples
+	 * rendered from them depends on the tempo.
+	 */
+	virtual int Available();
+
+	/**
+	 * Fetch processed samples.
+	 * Args:
+	 *   apBuffer - Pointer to buffer to fill with data
+	 *   aNumSamples - How many samples to read
+	 * Returns: Number of samples filled
+	 */
+	virtual int Fetch16BitSamples(int16_t* apBuffer, int aNumSamples);
+
+	/**
+	 * Render processed samples.
+	 */
+	virtual int Render(int16_t* apBuffer, int aNumFrames, int aNumChannels = 1, bool* apEnded = nullptr);
+
+	/**
+	 * Fetch the source's format. The length depends on the tempo so it is
+	 * not exact, rendering is done natively.
+	 */
+	virtual tAudioFormat GetFormat();
+
+	/**
+	 * Set the source's volume.
+	 */
+	virtual void SetVolume(float aVolume);
+
+	/**
+	 * Enable/Disable looping of the source. Grains run straight across the loop point.
+	 */
+	virtual void SetLooping(bool aLoopingEnable);
+
+	/**
+	 * Pause the source.
+	 */
+	virtual void Pause();
+
+	/**
+	 * Check if the source is paused.
+	 */
+	virtual bool IsPaused();
+
+	/**
+	 * Unpause the source.
+	 */
+	virtual void UnPause();
+
+	/**
+	 * Check if the source has run out of data and the last grain has finished.
+	 */
+	virtual bool IsEnded();
+
+	/**
+	 * Enable/Disable the source's De-pop algorithm.
+	 */
+	virtual void SetDePop(bool aStart, bool aEnd);
+
+	/**
+	 * Skip processed samples.
+	 * Args:
+	 *  aNumSamples - Number of 16-bit samples to skip.
+	 */
+	virtual void Skip16BitSamples(int aNumSamples);
+
+	/**
+	 * Register the source with an I/O scheduler.
+	 */
+	virtual void SetIOScheduler(IOScheduler* apScheduler, uint32_t aBytesPerSecond);
+
+	/**
+	 * Fetch how fast the source is read. This follows the tempo, the pitch
+	 * only changes how each grain is resampled.
+	 */
+	virtual float GetPlaybackSpeed();
+
+	/**
+	 * Pass on the source's events as this file's events. The source is read
+	 * ahead of the output, so events are reported up to about
+	 * TIME_STRETCH_GRAIN_SIZE * pitch samples early.
+	 */
+	virtual void SetEventSink(IWavFileEventSink* apSink);
+
+	/**
+	 * Skip the grain alignment search below eeQualityFull (plain overlap-add).
+	 * Args:
+	 *   aLevel - Quality level the player is mixing at
+	 */
+	virtual void SetQuality(EQualityLevel aLevel);
+
+protected:
+
+	//A windowed slice of the source being played
+	struct tGrain
+	{
+		//Source sample being read (whole part)
+		uint32_t mReadPos;
+		//Fraction of a sample past mReadPos (Q16)
+		uint32_t mReadFrac;
+		//Position in the window, TIME_STRETCH_GRAIN_SIZE when the grain is done
+		int mWindowPos;
+	};
+
+	/**
+	 * Receives events from the source and reports them as coming from this file.
+	 */
+	virtual void OnWavFileEvent(ISDWavFile* apSource, EWavFileEvent aEvent, unsigned long aSamplePosition);
+
+	/**
+	 * Drop all grains and buffered source samples.
+	 */
+	void Reset();
+
+	/**
+	 * Render source samples into the buffer until it holds aEndPos.
+	 * Args:
+	 *  aEndPos - Source sample position just past the last one needed
+	 */
+	void FillBuffer(uint32_t aEndPos);
+
+	/**
+	 * Start a new grain at the current analysis position, unless the source
+	 * has run out of data there.
+	 */
+	void StartGrain();
+
+	/**
+	 * Search around a source position for the best match with the samples
+	 * the playing grain will read next.
+	 * Args:
+	 *  aPos - Nominal start position of the new grain
+	 *  aMatchPos - Position the playing grain is reading from
+	 * Returns: Start position with the highest correlation
+	 */
+	uint32_t FindBestMatch(uint32_t aPos, uint32_t aMatchPos);
+
+	//File being processed
+	ISDWavFile* mpSource;
+
+	//Source samples, indexed by source position modulo the buffer size
+	int16_t maBuffer[TIME_STRETCH_BUFFER_SIZE];
+	//Source position just past the last sample in the buffer
+	uint32_t mBufferEnd;
+
+	//TRUE once the source has run out of data
+	bool mIsSourceEnded;
+	//Source position just past the last real sample (valid once mIsSourceEnded is set)
+	uint32_t mSourceEnd;
+
+	//Grains being played (two at a time, overlapping by half)
+	tGrain maGrains[2];
+
+	//Where the next grain starts in the source (whole part and Q16 fraction)
+	uint32_t mAnalysisPos;
+	uint32_t mAnalysisFrac;
+
+	//Output samples since the last grain started
+	int mHopPos;
+
+	//Source samples read per output sample (Q16)
+	uint32_t mPitchStep;
+	//Source samples moved between grain starts (Q16)
+	uint32_t mAnalysisStep;
+
+	//Receiver of playback events (nullptr if none)
+	IWavFileEventSink* mpEventSink;
+
+	//Quality level the player is mixing at
+	EQualityLevel mQuality;
+
+	//Hann window shared by all instances (Q15)
+	static int16_t saWindow[TIME_STRETCH_GRAIN_SIZE];
+	static bool sIsWindowReady;
+};
+
+#endif /* _TIMESTRETCHWAVFILE_H_ */
@@ -0,0 +1,122 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * WavFileAudioSink.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "WavFileAudioSink.h"
+
+WavFileAudioSink::WavFileAudioSink(const char* apFilePath)
+{
+	mpFilePath = apFilePath;
+	mNumFrames = 0;
+	mSampleRate = ee2205;
+	mIsRunning = false;
+}
+
+WavFileAudioSink::~WavFileAudioSink()
+{
+	Stop();
+}
+
+bool WavFileAudioSink::Begin()
+{
+	return true;
+}
+
+void WavFileAudioSink::SetSampleRate(ESampleRate aSampleRate)
+{
+	mSampleRate = aSampleRate;
+}
+
+void WavFileAudioSink::Start()
+{
+	Stop();
+
+	if(SD.exists(mpFilePath))
+	{
+		SD.remove(mpFilePath);
+	}
+
+	mFileHandle = SD.open(mpFilePath, FILE_WRITE);
+	mNumFrames = 0;
+	mIsRunning = (bool)mFileHandle;
+
+	//Sizes are filled in by Stop()
+	if(mIsRunning)
+	{
+		WriteHeader();
+	}
+}
+
+void WavFileAudioSink::Stop()
+{
+	if(!mIsRunning)
+	{
+		return;
+	}
+
+	mFileHandle.seek(0);
+	WriteHeader();
+	mFileHandle.close();
+	mIsRunning = false;
+}
+
+int32_t* WavFileAudioSink::GetFreeBuffer()
+{
+	return mIsRunning ? maBuffer : nullptr;
+}
+
+void WavFileAudioSink::SubmitBuffer(int32_t* apBuffer)
+{
+	//Frames are already laid out like 16-bit stereo wav data: left, then right
+	mFileHandle.write((uint8_t*)apBuffer, sizeof(int32_t) * I2S_BUF_SIZE);
+	mNumFrames += I2S_BUF_SIZE;
+}
+
+void WavFileAudioSink::Silence()
+{
+	//Nothing is kept
+}
+
+void WavFileAudioSink::WriteHeader()
+{
+	uint32_t lSampleRate = SampleRateToHz(mSampleRate);
+	uint32_t lDataSize = mNumFrames * sizeof(int32_t);
+
+	tWavFileHeader lHeader;
+	memcpy(lHeader.mChunkID, "RIFF", 4);
+	lHeader.mChunkSize = sizeof(tWavFileHeader) - 8 + sizeof(tWavDataHeader) + lDataSize;
+	memcpy(lHeader.mFormat, "WAVE", 4);
+	memcpy(lHeader.mSubchunk1ID, "fmt ", 4);
+	lHeader.subchunk1Size = 16;
+	lHeader.audioFormat = 1; //PCM
+	lHeader.numChannels = 2;
+	lHeader.sampleRate = lSampleRate;
+	lHeader.byteRate = lSampleRate * sizeof(int32_t);
+	lHeader.blockAlign = sizeof(int32_t);
+	lHeader.bitsPerSample = 16;
+
+	tWavDataHeader lDataHeader;
+	memcpy(lDataHeader.mID, "data", 4);
+	lDataHeader.mSize = lDataSize;
+
+	mFileHandle.write((uint8_t*)&lHeader, sizeof(lHeader));
+	mFileHandle.write((uint8_t*)&lDataHeader, sizeof(lDataHeader));
+}
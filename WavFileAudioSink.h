@@ -0,0 +1,123 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * WavFileAudioSink.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _WAVFILEAUDIOSINK_H_
+#define _WAVFILEAUDIOSINK_H_
+
+#include <Arduino.h>
+#include <SD.h>
+#include "IAudioSink.h"
+#include "ISDWavFile.h"
+
+/**
+ * Writes the mixed audio to a 16-bit stereo .wav file instead of playing it.
+ * Like the NullAudioSink it always has a free buffer once started, so the
+ * player mixes as fast as it can. On a host build this records exactly what
+ * the hardware would have played.
+ *
+ * The file is created by Start() and the header sizes are written by Stop(),
+ * so stop the sink before reading the file.
+ */
+class WavFileAudioSink : public IAudioSink
+{
+public:
+	/**
+	 * Constructor.
+	 * Args:
+	 *  apFilePath - File to write, replaced if it exists
+	 */
+	WavFileAudioSink(const char* apFilePath);
+
+	/**
+	 * Destructor. Finishes the file if the sink is still started.
+	 */
+	virtual ~WavFileAudioSink();
+
+	/**
+	 * Nothing to set up.
+	 */
+	virtual bool Begin();
+
+	/**
+	 * Set the sample rate written to the header.
+	 */
+	virtual void SetSampleRate(ESampleRate aSampleRate);
+
+	/**
+	 * Create the file.
+	 */
+	virtual void Start();
+
+	/**
+	 * Write the header and close the file.
+	 */
+	virtual void Stop();
+
+	/**
+	 * Fetch the buffer, always free while the file is open.
+	 */
+	virtual int32_t* GetFreeBuffer();
+
+	/**
+	 * Append the buffer to the file.
+	 */
+	virtual void SubmitBuffer(int32_t* apBuffer);
+
+	/**
+	 * Nothing to do, buffers are written as soon as they are handed over.
+	 */
+	virtual void Silence();
+
+	/**
+	 * Fetch how many frames have been written to the file.
+	 */
+	inline uint32_t GetNumFrames()
+	{
+		return mNumFrames;
+	}
+
+protected:
+
+	/**
+	 * Write the header at the current position in the file.
+	 */
+	void WriteHeader();
+
+	//Path of the file to write
+	const char* mpFilePath;
+
+	//File being written
+	File mFileHandle;
+
+	//The only buffer
+	int32_t maBuffer[I2S_BUF_SIZE];
+
+	//Frames written so far
+	uint32_t mNumFrames;
+
+	//Rate written to the header
+	ESampleRate mSampleRate;
+
+	//TRUE while the file is open
+	bool mIsRunning;
+};
+
+#endif /* _WAVFILEAUDIOSINK_H_ */
@@ -0,0 +1,83 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+
+/*
+ * WavFileHandle.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#include "WavFileHandle.h"
+#include "ISDWavFile.h"
+
+WavFileHandle::WavFileHandle(ISDWavFile* apWavFile)
+{
+	mpWavFile = apWavFile;
+}
+
+WavFileHandle::WavFileHandle(WavFileHandle&& arOther)
+{
+	mpWavFile = arOther.Release();
+}
+
+WavFileHandle& WavFileHandle::operator=(WavFileHandle&& arOther)
+{
+	if(this != &arOther)
+	{
+		Reset(arOther.Release());
+	}
+
+	return *this;
+}
+
+WavFileHandle::~WavFileHandle()
+{
+	Destroy(mpWavFile);
+}
+
+ISDWavFile* WavFileHandle::Release()
+{
+	ISDWavFile* lpWavFile = mpWavFile;
+	mpWavFile = nullptr;
+
+	return lpWavFile;
+}
+
+void WavFileHandle::Reset(ISDWavFile* apWavFile)
+{
+	ISDWavFile* lpOldFile = mpWavFile;
+	mpWavFile = apWavFile;
+
+	if(lpOldFile != apWavFile)
+	{
+		Destroy(lpOldFile);
+	}
+}
+
+void WavFileHandle::Destroy(ISDWavFile* apWavFile)
+{
+	if(nullptr == apWavFile)
+	{
+		return;
+	}
+
+#ifdef NRF52AUDIO_STATIC_ALLOC
+	//The storage belongs to whoever built the file there
+	apWavFile->~ISDWavFile();
+#else
+	delete apWavFile;
+#endif
+}
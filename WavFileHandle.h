@@ -0,0 +1,116 @@
+/******************************************************************************
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ******************************************************************************/
+/*
+ * WavFileHandle.h
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: JakeSoft
+ */
+
+#ifndef _WAVFILEHANDLE_H_
+#define _WAVFILEHANDLE_H_
+
+#include <utility>
+#include "AudioAlloc.h"
+
+class ISDWavFile;
+
+/*
+ * Owns one wav file and destroys it when the handle goes away. Handles can be
+ * moved but not copied, so a file always has exactly one owner. Hand a file
+ * to the player by moving its handle into I2SWavPlayer::SetWavFile():
+ *
+ *   WavFileHandle lHum(new SDWavFile("hum.wav"));
+ *   lHum->SetLooping(true);
+ *   gPlayer.SetWavFile(std::move(lHum), 0); //lHum is empty now
+ *
+ * Files are destroyed the same way the player destroys the files it owns:
+ * with delete, or when NRF52AUDIO_STATIC_ALLOC is defined, by calling only the
+ * destructor (the storage belongs to whoever built the file there).
+ */
+class WavFileHandle
+{
+public:
+	/**
+	 * Constructor.
+	 * Args:
+	 *   apWavFile - (optional) File to take over, nullptr for an empty handle
+	 */
+	explicit WavFileHandle(ISDWavFile* apWavFile = nullptr);
+
+	/**
+	 * Move constructor. Takes the file over from arOther, which is left empty.
+	 */
+	WavFileHandle(WavFileHandle&& arOther);
+
+	/**
+	 * Move assignment. Destroys the file this handle had and takes the file
+	 * over from arOther, which is left empty.
+	 */
+	WavFileHandle& operator=(WavFileHandle&& arOther);
+
+	WavFileHandle(const WavFileHandle&) = delete;
+	WavFileHandle& operator=(const WavFileHandle&) = delete;
+
+	/**
+	 * Destructor. Destroys the file, if there is one.
+	 */
+	~WavFileHandle();
+
+	/**
+	 * Fetch the file without giving it up.
+	 */
+	inline ISDWavFile* Get() const
+	{
+		return mpWavFile;
+	}
+
+	inline ISDWavFile* operator->() const
+	{
+		return mpWavFile;
+	}
+
+	inline explicit operator bool() const
+	{
+		return nullptr != mpWavFile;
+	}
+
+	/**
+	 * Give the file up without destroying it. Whoever gets it is now
+	 * responsible for it.
+	 * Returns: The file, or nullptr if the handle was empty
+	 */
+	ISDWavFile* Release();
+
+	/**
+	 * Destroy the file and take over another one.
+	 * Args:
+	 *   apWavFile - (optional) File to take over, nullptr to leave the handle empty
+	 */
+	void Reset(ISDWavFile* apWavFile = nullptr);
+
+	/**
+	 * End the life of a file, as a handle does when it lets go of one.
+	 * Args:
+	 *   apWavFile - File to destroy, may be nullptr
+	 */
+	static void Destroy(ISDWavFile* apWavFile);
+
+protected:
+	//The file this handle owns
+	ISDWavFile* mpWavFile;
+};
+
+#endif /* _WAVFILEHANDLE_H_ */
@@ -0,0 +1,543 @@
+#include "Arduino.h"
+#include <malloc.h>
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+#define PIN_SPI_CS  11
+#define PIN_SCL 16
+#define PIN_SDA 15
+
+//How many I2S blocks to mix for each scenario
+//(40 blocks of 2048 samples is roughly 3.7 seconds at 22.05KHz)
+#define BENCH_BLOCKS 40
+
+//Files used by the scenarios. Change these to match the files on your SD card.
+#define FILE_SIMPLE   "441/CANT2.WAV"
+#define FILE_FONT     "2205/font.wav"
+#define FILE_HUM      "2205/hum.wav"
+#define FILE_CANT     "2205/CANT2.WAV"
+#define FILE_SWING    "2205/swing1.wav"
+#define FILE_LOCKUP   "2205/lockup.wav"
+#define FILE_PITCH    "2205/i_font1/swng01.wav"
+#define FILE_POWERON  "2205/pfont1/poweron3.wav"
+#define FILE_CHAINHUM "2205/pfont1/hum.wav"
+#define FILE_SWINGL   "2205/pfont1/swingl1.wav"
+#define FILE_SWINGH   "2205/pfont1/swingh1.wav"
+
+//mu-law copies of the poly 5 files, made with extras/encode_g711.py
+#define FILE_FONT_ULAW   "2205/ulaw/font.wav"
+#define FILE_HUM_ULAW    "2205/ulaw/hum.wav"
+#define FILE_CANT_ULAW   "2205/ulaw/CANT2.WAV"
+#define FILE_SWING_ULAW  "2205/ulaw/swing1.wav"
+#define FILE_LOCKUP_ULAW "2205/ulaw/lockup.wav"
+
+//How many bytes to decode and read when comparing codec cost against SD reads
+#define CODEC_BENCH_BYTES 65536
+
+//How many samples to run through a biquad when measuring its cost
+#define BIQUAD_BENCH_SAMPLES 65536
+
+//How many samples to run through the master limiter when measuring its cost
+#define LIMITER_BENCH_SAMPLES 65536
+
+//How many samples to render through a time-stretch voice when measuring its cost
+#define TIME_STRETCH_BENCH_SAMPLES 65536
+
+//Heap allocation tracking. Every call to new made by the library
+//(or by this sketch) is counted here.
+static volatile unsigned long sNumAllocs = 0;
+
+void* operator new(size_t aSize)
+{
+	sNumAllocs++;
+	return malloc(aSize);
+}
+
+void* operator new[](size_t aSize)
+{
+	sNumAllocs++;
+	return malloc(aSize);
+}
+
+void operator delete(void* apPtr)
+{
+	free(apPtr);
+}
+
+void operator delete[](void* apPtr)
+{
+	free(apPtr);
+}
+
+//Files loaded by the scenario currently running
+ISDWavFile* gapFiles[MAX_WAV_FILES];
+
+//Files wrapped by effect chains in the scenario currently running
+ISDWavFile* gapSourceFiles[MAX_WAV_FILES];
+
+//Pitch shifted file for the rate sweep scenario
+PitchShiftSDWavFile* gpPitchFile = nullptr;
+
+//Per-voice low-pass filters for the filtered scenario
+BiquadFilter gaFilters[MAX_WAV_FILES];
+
+//Time-stretch voices for the time-stretch scenario
+TimeStretchWavFile* gapStretchFiles[MAX_WAV_FILES];
+
+//Swing pair for the smooth swing scenario
+SmoothSwingWavFile* gpSmoothSwing = nullptr;
+
+//Player shared by all scenarios
+I2SWavPlayer* gpPlayer = nullptr;
+
+//I/O scheduler for the scheduled scenario
+IOScheduler gIOScheduler;
+
+//Loads a looping file into a player channel
+void LoadLoopingFile(ISDWavFile* apFile, int aIndex)
+{
+	apFile->SetLooping(true);
+	gapFiles[aIndex] = apFile;
+	gpPlayer->SetWavFile(apFile, aIndex);
+}
+
+void SetupSimple()
+{
+	LoadLoopingFile(new SDWavFile(FILE_SIMPLE), 0);
+}
+
+void SetupPoly3()
+{
+	LoadLoopingFile(new SDWavFile(FILE_FONT), 0);
+	LoadLoopingFile(new SDWavFile(FILE_HUM), 1);
+	LoadLoopingFile(new SDWavFile(FILE_CANT), 2);
+}
+
+void SetupPoly5()
+{
+	SetupPoly3();
+	LoadLoopingFile(new SDWavFile(FILE_SWING), 3);
+	LoadLoopingFile(new SDWavFile(FILE_LOCKUP), 4);
+}
+
+void SetupPoly5Scheduled()
+{
+	gIOScheduler.ResetStats();
+	gpPlayer->SetIOScheduler(&gIOScheduler);
+	SetupPoly5();
+}
+
+void SetupPoly5MuLaw()
+{
+	LoadLoopingFile(new SDWavFile(FILE_FONT_ULAW), 0);
+	LoadLoopingFile(new SDWavFile(FILE_HUM_ULAW), 1);
+	LoadLoopingFile(new SDWavFile(FILE_CANT_ULAW), 2);
+	LoadLoopingFile(new SDWavFile(FILE_SWING_ULAW), 3);
+	LoadLoopingFile(new SDWavFile(FILE_LOCKUP_ULAW), 4);
+}
+
+//Loads a looping file into a player channel through a low-pass filter
+void LoadFilteredFile(ISDWavFile* apFile, int aIndex)
+{
+	gaFilters[aIndex] = BiquadFilter();
+	gaFilters[aIndex].Configure(eeLowPass, 4000.0, 0.707, apFile->GetHeader().sampleRate);
+
+	EffectChainWavFile* lpChain = new EffectChainWavFile(apFile);
+	lpChain->AddEffect(&gaFilters[aIndex]);
+
+	gapSourceFiles[aIndex] = apFile;
+	LoadLoopingFile(lpChain, aIndex);
+}
+
+void SetupPoly3Filtered()
+{
+	LoadFilteredFile(new SDWavFile(FILE_FONT), 0);
+	LoadFilteredFile(new SDWavFile(FILE_HUM), 1);
+	LoadFilteredFile(new SDWavFile(FILE_CANT), 2);
+}
+
+void UpdateFilterSweep(unsigned long aBlock)
+{
+	//Sweep the cutoff like a swing speeding up and slowing down
+	float lSwing = (aBlock % 10) / 10.0;
+	for(int lIdx = 0; lIdx < 3; lIdx++)
+	{
+		gaFilters[lIdx].Configure(eeLowPass, 300.0 + 5000.0 * lSwing, 0.707,
+								  gapSourceFiles[lIdx]->GetHeader().sampleRate);
+	}
+}
+
+void SetupPitchSweep()
+{
+	gpPitchFile = new PitchShiftSDWavFile(FILE_PITCH);
+	LoadLoopingFile(gpPitchFile, 0);
+}
+
+void UpdatePitchSweep(unsigned long aBlock)
+{
+	//Sweep the rate from -1.0 to +1.0 over the course of the run
+	float lRate = -1.0 + (2.0 * aBlock) / BENCH_BLOCKS;
+	gpPitchFile->SetRate(lRate);
+}
+
+//Loads a looping file into a player channel through a time-stretch
+void LoadStretchedFile(ISDWavFile* apFile, int aIndex)
+{
+	gapStretchFiles[aIndex] = new TimeStretchWavFile(apFile);
+	gapSourceFiles[aIndex] = apFile;
+	LoadLoopingFile(gapStretchFiles[aIndex], aIndex);
+}
+
+void SetupPoly3Stretched()
+{
+	LoadStretchedFile(new SDWavFile(FILE_FONT), 0);
+	LoadStretchedFile(new SDWavFile(FILE_HUM), 1);
+	LoadStretchedFile(new SDWavFile(FILE_SWING), 2);
+}
+
+void UpdateStretchSweep(unsigned long aBlock)
+{
+	//Pitch and tempo move independently: pitch sweeps up while tempo sweeps down
+	float lPosition = (float)aBlock / BENCH_BLOCKS;
+	for(int lIdx = 0; lIdx < 3; lIdx++)
+	{
+		gapStretchFiles[lIdx]->SetPitch(0.75 + 0.75 * lPosition);
+		gapStretchFiles[lIdx]->SetTempo(1.5 - 0.75 * lPosition);
+	}
+}
+
+void SetupSmoothSwing()
+{
+	LoadLoopingFile(new SDWavFile(FILE_HUM), 0);
+	gpSmoothSwing = new SmoothSwingWavFile(FILE_SWINGL, FILE_SWINGH);
+	LoadLoopingFile(gpSmoothSwing, 1);
+}
+
+void UpdateSmoothSwing(unsigned long aBlock)
+{
+	//Swing back and forth, speeding up and slowing down
+	float lSwing = (aBlock % 10) / 10.0;
+	gpSmoothSwing->SetSwing(lSwing);
+	gpSmoothSwing->SetVolume(lSwing < 0.5 ? 2.0 * lSwing : 2.0 - 2.0 * lSwing);
+}
+
+void SetupChain()
+{
+	LoadLoopingFile(new ChainedSDWavFile(FILE_POWERON, FILE_CHAINHUM), 0);
+}
+
+struct tBenchScenario
+{
+	//Name printed in the report
+	const char* mpName;
+	//Creates the files and loads them into the player
+	void (*mpSetup)();
+	//(optional) Called once for every mixed block to automate parameters
+	void (*mpUpdate)(unsigned long aBlock);
+};
+
+tBenchScenario gaScenarios[] =
+{
+	{"SimpleWavPlayer",     SetupSimple,     nullptr},
+	{"Polyphonic 3 voices", SetupPoly3,      nullptr},
+	{"Polyphonic 5 voices", SetupPoly5,      nullptr},
+	{"Poly 5 + IOScheduler", SetupPoly5Scheduled, nullptr},
+	{"Poly 5 mu-law",       SetupPoly5MuLaw, nullptr},
+	{"Poly 3 + low-pass",   SetupPoly3Filtered, UpdateFilterSweep},
+	{"PitchShift sweep",    SetupPitchSweep, UpdatePitchSweep},
+	{"Poly 3 time-stretch", SetupPoly3Stretched, UpdateStretchSweep},
+	{"Hum + smooth swing",  SetupSmoothSwing, UpdateSmoothSwing},
+	{"WavChain",            SetupChain,      nullptr},
+};
+
+//Closes and frees all files loaded by a scenario
+void CleanupScenario()
+{
+	gpPlayer->ClearAllWavFiles();
+
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+	{
+		if(nullptr != gapFiles[lIdx])
+		{
+			gapFiles[lIdx]->Close();
+			delete gapFiles[lIdx];
+			gapFiles[lIdx] = nullptr;
+		}
+
+		if(nullptr != gapSourceFiles[lIdx])
+		{
+			delete gapSourceFiles[lIdx];
+			gapSourceFiles[lIdx] = nullptr;
+		}
+	}
+
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+	{
+		gapStretchFiles[lIdx] = nullptr;
+	}
+
+	gpPitchFile = nullptr;
+	gpSmoothSwing = nullptr;
+	gpPlayer->SetIOScheduler(nullptr);
+}
+
+void RunScenario(const tBenchScenario& arScenario)
+{
+	arScenario.mpSetup();
+
+	gpPlayer->StartPlayback();
+	gpPlayer->ResetMixStats();
+	BufferedFileReader::ResetNumReadCalls();
+	sNumAllocs = 0;
+	int lPeakHeap = mallinfo().uordblks;
+
+	unsigned long lStartTime = millis();
+	unsigned long lLastBlock = 0;
+
+	while(gpPlayer->GetMixStats().mBlocksMixed < BENCH_BLOCKS)
+	{
+		gpPlayer->ContinuePlayback();
+
+		unsigned long lBlock = gpPlayer->GetMixStats().mBlocksMixed;
+		if(lBlock != lLastBlock)
+		{
+			lLastBlock = lBlock;
+
+			if(nullptr != arScenario.mpUpdate)
+			{
+				arScenario.mpUpdate(lBlock);
+			}
+
+			int lHeap = mallinfo().uordblks;
+			if(lHeap > lPeakHeap)
+			{
+				lPeakHeap = lHeap;
+			}
+		}
+	}
+
+	float lElapsedSec = (millis() - lStartTime) / 1000.0;
+	gpPlayer->StopPlayback();
+
+	const I2SWavPlayer::tMixStats& lrStats = gpPlayer->GetMixStats();
+
+	Serial.print(arScenario.mpName);
+	Serial.print(": mix us/block avg=");
+	Serial.print(lrStats.mTotalMixMicros / lrStats.mBlocksMixed);
+	Serial.print(" max=");
+	Serial.print(lrStats.mMaxMixMicros);
+	Serial.print(", SD reads/s=");
+	Serial.print(BufferedFileReader::GetNumReadCalls() / lElapsedSec);
+	Serial.print(", allocs/s=");
+	Serial.print(sNumAllocs / lElapsedSec);
+	Serial.print(", peak heap=");
+	Serial.println(lPeakHeap);
+
+	if(SetupPoly5Scheduled == arScenario.mpSetup)
+	{
+		const tIOSchedulerStats& lrIOStats = gIOScheduler.GetStats();
+		Serial.print("  I/O: max queue depth=");
+		Serial.print(lrIOStats.mMaxQueueDepth);
+		Serial.print(", worst slack us=");
+		Serial.print(lrIOStats.mWorstSlackMicros);
+		Serial.print(", bursts=");
+		Serial.print(lrIOStats.mNumBursts);
+		Serial.print(", misses=");
+		Serial.println(lrIOStats.mNumMisses);
+	}
+
+	CleanupScenario();
+}
+
+//Compares the cost of decoding a mu-law sample against the cost of reading
+//the extra byte a 16-bit sample would need from the SD card
+void RunCodecBenchmark()
+{
+	static uint8_t saBlock[DATA_BLOCK_SIZE];
+	volatile int32_t lSink = 0;
+
+	for(int lIdx = 0; lIdx < DATA_BLOCK_SIZE; lIdx++)
+	{
+		saBlock[lIdx] = lIdx;
+	}
+
+	unsigned long lStartTime = micros();
+	for(int lByte = 0; lByte < CODEC_BENCH_BYTES; lByte++)
+	{
+		lSink += G711DecodeMuLaw(saBlock[lByte % DATA_BLOCK_SIZE]);
+	}
+	float lDecodeNs = (micros() - lStartTime) * 1000.0 / CODEC_BENCH_BYTES;
+
+	File lFile = SD.open(FILE_HUM);
+	lStartTime = micros();
+	int lBytesRead = 0;
+	while(lBytesRead < CODEC_BENCH_BYTES)
+	{
+		if(lFile.available() < DATA_BLOCK_SIZE)
+		{
+			lFile.seek(0);
+		}
+		lBytesRead += lFile.read(saBlock, DATA_BLOCK_SIZE);
+	}
+	float lReadNs = (micros() - lStartTime) * 1000.0 / CODEC_BENCH_BYTES;
+	lFile.close();
+
+	Serial.print("mu-law decode ns/sample=");
+	Serial.print(lDecodeNs);
+	Serial.print(", SD read ns/byte=");
+	Serial.print(lReadNs);
+	Serial.print(", net saving ns/sample=");
+	Serial.println(lReadNs - lDecodeNs);
+}
+
+//Measures how many CPU cycles one biquad filter stage takes per sample
+void RunBiquadBenchmark()
+{
+	static int16_t saBlock[EFFECT_CHAIN_BLOCK_SIZE];
+	BiquadFilter lFilter;
+	lFilter.Configure(eeLowPass, 1000.0, 0.707, 22050);
+
+	for(int lIdx = 0; lIdx < EFFECT_CHAIN_BLOCK_SIZE; lIdx++)
+	{
+		saBlock[lIdx] = (lIdx * 1024) - 16384;
+	}
+
+	unsigned long lStartTime = micros();
+	for(int lSample = 0; lSample < BIQUAD_BENCH_SAMPLES; lSample += EFFECT_CHAIN_BLOCK_SIZE)
+	{
+		lFilter.Process(saBlock, EFFECT_CHAIN_BLOCK_SIZE);
+	}
+	unsigned long lElapsedMicros = micros() - lStartTime;
+
+	Serial.print("Biquad cycles/sample=");
+	Serial.println((float)lElapsedMicros * (F_CPU / 1000000) / BIQUAD_BENCH_SAMPLES);
+}
+
+//Compares the cost of the master limiter against the cost of fetching one voice
+void RunLimiterBenchmark()
+{
+	static int32_t saLeft[MIX_CHUNK_SIZE];
+	static int32_t saRight[MIX_CHUNK_SIZE];
+	static int32_t saOut[MIX_CHUNK_SIZE];
+	MasterLimiter lLimiter;
+
+	unsigned long lStartTime = micros();
+	for(int lSample = 0; lSample < LIMITER_BENCH_SAMPLES; lSample += MIX_CHUNK_SIZE)
+	{
+		//Loud enough to keep the limiter working
+		for(int lIdx = 0; lIdx < MIX_CHUNK_SIZE; lIdx++)
+		{
+			saLeft[lIdx] = (lIdx & 1) ? 60000 : -60000;
+			saRight[lIdx] = -saLeft[lIdx];
+		}
+		lLimiter.Process(saLeft, saRight, saOut, MIX_CHUNK_SIZE);
+	}
+	float lLimiterCycles = (float)(micros() - lStartTime) * (F_CPU / 1000000) / LIMITER_BENCH_SAMPLES;
+
+	SDWavFile lVoice(FILE_HUM);
+	lVoice.SetLooping(true);
+	int16_t lSample16 = 0;
+
+	lStartTime = micros();
+	for(int lSample = 0; lSample < LIMITER_BENCH_SAMPLES; lSample++)
+	{
+		lVoice.Fetch16BitSamples(&lSample16, 1);
+	}
+	float lVoiceCycles = (float)(micros() - lStartTime) * (F_CPU / 1000000) / LIMITER_BENCH_SAMPLES;
+	lVoice.Close();
+
+	Serial.print("Limiter cycles/sample=");
+	Serial.print(lLimiterCycles);
+	Serial.print(", one voice fetch cycles/sample=");
+	Serial.println(lVoiceCycles);
+}
+
+//Measures the cost of one time-stretch voice on top of the file it reads from
+void RunTimeStretchBenchmark()
+{
+	static int16_t saBlock[MIX_CHUNK_SIZE];
+
+	SDWavFile lVoice(FILE_HUM);
+	lVoice.SetLooping(true);
+
+	unsigned long lStartTime = micros();
+	for(int lSample = 0; lSample < TIME_STRETCH_BENCH_SAMPLES; lSample += MIX_CHUNK_SIZE)
+	{
+		lVoice.Render(saBlock, MIX_CHUNK_SIZE);
+	}
+	float lVoiceCycles = (float)(micros() - lStartTime) * (F_CPU / 1000000) / TIME_STRETCH_BENCH_SAMPLES;
+
+	TimeStretchWavFile lStretch(&lVoice);
+	lStretch.SetPitch(1.26); //Up 4 semitones...
+	lStretch.SetTempo(0.8);  //...and slower
+
+	lStartTime = micros();
+	for(int lSample = 0; lSample < TIME_STRETCH_BENCH_SAMPLES; lSample += MIX_CHUNK_SIZE)
+	{
+		lStretch.Render(saBlock, MIX_CHUNK_SIZE);
+	}
+	float lStretchCycles = (float)(micros() - lStartTime) * (F_CPU / 1000000) / TIME_STRETCH_BENCH_SAMPLES;
+	lVoice.Close();
+
+	//The stretched voice reads 0.8 source samples per output sample
+	Serial.print("Time-stretch cycles/sample per voice=");
+	Serial.print(lStretchCycles - 0.8 * lVoiceCycles);
+	Serial.print(", including the source=");
+	Serial.println(lStretchCycles);
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	//Initialize SD card. Make sure to do this before creating any SDWavFile objects or
+	//trying to play anything or we won't be able to read the data from the SD card
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return; //Punt. We can't work without SD card
+	}
+	Serial.println("SD init completed.");
+
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+	{
+		gapFiles[lIdx] = nullptr;
+		gapSourceFiles[lIdx] = nullptr;
+		gapStretchFiles[lIdx] = nullptr;
+	}
+
+	gpPlayer = new I2SWavPlayer(PIN_I2S_MCK,
+								PIN_I2S_BCLK,
+								PIN_I2S_LRCK,
+								PIN_I2S_DIN,
+								PIN_I2S_SD);
+	gpPlayer->Init();
+	gpPlayer->Configure_I2S_Speed(ee2205);
+	gpPlayer->SetVolume(0.1);
+
+	Serial.println("Benchmark started.");
+
+	for(unsigned int lIdx = 0; lIdx < sizeof(gaScenarios)/sizeof(gaScenarios[0]); lIdx++)
+	{
+		RunScenario(gaScenarios[lIdx]);
+	}
+
+	RunCodecBenchmark();
+	RunBiquadBenchmark();
+	RunLimiterBenchmark();
+	RunTimeStretchBenchmark();
+
+	Serial.println("Benchmark finished.");
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+//Add your repeated code here
+}
@@ -0,0 +1,125 @@
+#include "Arduino.h"
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+#define PIN_SPI_CS  11
+#define PIN_SCL 16
+#define PIN_SDA 15
+
+//Controls playback from a timer that runs in a different task than the
+//playback loop, the way motion processing code usually does. Every timer
+//tick queues a batch of commands that the player applies together at the
+//start of its next block, so the mixer never sees half of an update.
+
+//How often the "motion" timer fires (milliseconds)
+#define MOTION_PERIOD_MS 10
+
+//How long to run before printing the results (milliseconds)
+#define RUN_TIME_MS 30000
+
+//Files to play. Change these to match the files on your SD card.
+#define FILE_HUM   "2205/hum.wav"
+#define FILE_SWING "2205/i_font1/swng01.wav"
+
+I2SWavPlayer* gpPlayer = nullptr;
+SDWavFile* gpHumFile = nullptr;
+PitchShiftSDWavFile* gpSwingFile = nullptr;
+
+//Timer that simulates motion processing
+SoftwareTimer gMotionTimer;
+
+//Number of motion ticks and batches that could not be queued in full
+volatile unsigned long gNumTicks = 0;
+volatile unsigned long gNumFullBatches = 0;
+
+//Runs in the timer task, never touches the player directly
+void MotionTimerCallback(TimerHandle_t aTimerHandle)
+{
+	//Fake a swing that speeds up and slows down every two seconds
+	float lSwingSpeed = 0.5 + 0.5 * sin(millis() * 2.0 * PI / 2000.0);
+
+	gpPlayer->BeginCommandBatch();
+	bool lAllQueued = gpPlayer->QueueSetFileRate(gpSwingFile, lSwingSpeed - 0.5);
+	lAllQueued &= gpPlayer->QueueSetFileVolume(gpSwingFile, lSwingSpeed);
+	lAllQueued &= gpPlayer->QueueSetFileVolume(gpHumFile, 1.0 - 0.5 * lSwingSpeed);
+	gpPlayer->EndCommandBatch();
+
+	gNumTicks++;
+	if(!lAllQueued)
+	{
+		gNumFullBatches++;
+	}
+}
+
+void PlayWavFiles()
+{
+	gpHumFile = new SDWavFile(FILE_HUM);
+	gpSwingFile = new PitchShiftSDWavFile(FILE_SWING);
+	gpHumFile->SetLooping(true);
+	gpSwingFile->SetLooping(true);
+
+	//Create a new I2S Player
+	gpPlayer = new I2SWavPlayer(PIN_I2S_MCK,
+								PIN_I2S_BCLK,
+								PIN_I2S_LRCK,
+								PIN_I2S_DIN,
+								PIN_I2S_SD);
+
+	gpPlayer->Init();
+	gpPlayer->Configure_I2S_Speed(ee2205);
+	gpPlayer->SetVolume(0.2);
+
+	//Files can be queued too, they are loaded when the first block is mixed
+	gpPlayer->QueueSetWavFile(gpHumFile, 0);
+	gpPlayer->QueueSetWavFile(gpSwingFile, 1);
+	gpPlayer->StartPlayback();
+
+	gMotionTimer.begin(MOTION_PERIOD_MS, MotionTimerCallback);
+	gMotionTimer.start();
+
+	Serial.println("Playback started.");
+	unsigned long lStartTime = millis();
+
+	while(millis() - lStartTime < RUN_TIME_MS)
+	{
+		gpPlayer->ContinuePlayback();
+	}
+
+	gMotionTimer.stop();
+	gpPlayer->StopPlayback();
+
+	Serial.print("Motion ticks=");
+	Serial.print(gNumTicks);
+	Serial.print(", incomplete batches=");
+	Serial.print(gNumFullBatches);
+	Serial.print(", dropped commands=");
+	Serial.println(gpPlayer->GetNumDroppedCommands());
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	//Initialize SD card. Make sure to do this before creating any SDWavFile objects or
+	//trying to play anything or we won't be able to read the data from the SD card
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return; //Punt. We can't work without SD card
+	}
+	Serial.println("SD init completed.");
+
+	PlayWavFiles();
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+//Add your repeated code here
+}
@@ -0,0 +1,84 @@
+#include "Arduino.h"
+#include <Adafruit_SPIFlash.h>
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+
+//Plays wav files straight out of the nRF52840's QSPI flash. Build an image with
+//  extras/pack_wav_image.py image.bin hum.wav swing.wav
+//and write it to the start of the QSPI flash (for example with the
+//Adafruit_SPIFlash flash_manipulator sketch).
+
+//QSPI flash transport. Setting it up also enables memory-mapped (XIP) reads.
+Adafruit_FlashTransport_QSPI gFlashTransport;
+Adafruit_SPIFlash gFlash(&gFlashTransport);
+
+//Plays two files from the flash image at the same time
+void PlayWavFiles()
+{
+	const uint8_t* lpImage = (const uint8_t*)MAPPED_WAV_QSPI_XIP_BASE;
+
+	//The image starts at the start of the flash, so it can't be bigger than the flash
+	uint32_t lImageSize = gFlash.size();
+
+	//Change "hum.wav" and "swing.wav" to match the names stored in your image.
+	MappedWavFile* lpWavFile0 = new MappedWavFile(lpImage, lImageSize, "hum.wav");
+	MappedWavFile* lpWavFile1 = new MappedWavFile(lpImage, lImageSize, "swing.wav");
+
+	lpWavFile0->SetLooping(true);
+	lpWavFile1->SetLooping(true);
+
+	//Create a new I2S Player
+	I2SWavPlayer* lpPlayer = new I2SWavPlayer(PIN_I2S_MCK,
+			  	  	  	  	  	  	  	  	  PIN_I2S_BCLK,
+											  PIN_I2S_LRCK,
+											  PIN_I2S_DIN,
+											  PIN_I2S_SD);
+
+	lpPlayer->Init();                      //Initializes I2S playback hardware
+	lpPlayer->Configure_I2S_Speed(ee2205); //Set I2S clock speed (sample rate of the file)
+
+	lpPlayer->SetWavFile(lpWavFile0, 0);   //Set file object to play for channel 0
+	lpPlayer->SetWavFile(lpWavFile1, 1);   //Set file object to play for channel 1
+	lpPlayer->SetVolume(0.2);              //set master volume, 0.0 (mute) to 1.0 (full volume)
+	lpPlayer->StartPlayback();             //Begin playing the wave files
+
+	Serial.println("Playback started.");
+	unsigned long lStartTime = millis();
+
+	//Play for 30 seconds
+	while(false == lpPlayer->ContinuePlayback() && millis() - lStartTime < 30000)
+	{
+		//Wait for playback to end
+	}
+
+	//Cleanup code
+	Serial.println("Playback ended.");
+	lpPlayer->StopPlayback();
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	if(!gFlash.begin())
+	{
+		Serial.println("QSPI flash init failed.");
+		return; //Punt. We can't work without the flash
+	}
+	Serial.println("QSPI flash init completed.");
+
+	PlayWavFiles();
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+//Add your repeated code here
+}
@@ -0,0 +1,90 @@
+#include "Arduino.h"
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+#define PIN_SPI_CS  11
+#define PIN_SCL 16
+#define PIN_SDA 15
+
+//Plays sounds out of a font bundle. Build the bundle on your computer with
+//  extras/pack_font_bundle.py font1.bnd poweron.wav hum.wav swing.wav
+//and copy it to the SD card.
+void PlayFontBundle()
+{
+	//Open the bundle. This is the only file that gets opened, no matter
+	//how many sounds are played from it.
+	FontBundle* lpBundle = new FontBundle("font1.bnd");
+	if(!lpBundle->IsValid())
+	{
+		Serial.println("Could not read font bundle.");
+		return;
+	}
+
+	Serial.print("Sounds in bundle: ");
+	Serial.println(lpBundle->GetNumSounds());
+
+	//Change these names to match the sounds in your bundle
+	BundleWavFile* lpHum = new BundleWavFile(lpBundle, "hum.wav");
+	BundleWavFile* lpSwing = new BundleWavFile(lpBundle, "swing.wav");
+
+	lpHum->SetLooping(true);
+	lpSwing->SetLooping(true);
+	lpSwing->SetVolume(0.5);
+
+	//Create a new I2S Player
+	I2SWavPlayer* lpPlayer = new I2SWavPlayer(PIN_I2S_MCK,
+			  	  	  	  	  	  	  	  	  PIN_I2S_BCLK,
+											  PIN_I2S_LRCK,
+											  PIN_I2S_DIN,
+											  PIN_I2S_SD);
+
+	lpPlayer->Init();                      //Initializes I2S playback hardware
+	lpPlayer->Configure_I2S_Speed(ee2205); //Set I2S clock speed (sample rate of the file)
+
+	lpPlayer->SetWavFile(lpHum, 0);        //Set file object to play for channel 0
+	lpPlayer->SetWavFile(lpSwing, 1);      //Set file object to play for channel 1
+	lpPlayer->SetVolume(0.2);              //set master volume, 0.0 (mute) to 1.0 (full volume)
+	lpPlayer->StartPlayback();             //Begin playing the sounds
+
+	Serial.println("Playback started.");
+	unsigned long lStartTime = millis();
+
+	//Play for 30 seconds
+	while(false == lpPlayer->ContinuePlayback() && millis() - lStartTime < 30000)
+	{
+		//Wait for playback to end
+	}
+
+	//Cleanup code
+	Serial.println("Playback ended.");
+	lpPlayer->StopPlayback();
+	lpBundle->Close();
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	//Initialize SD card. Make sure to do this before creating any SDWavFile objects or
+	//trying to play anything or we won't be able to read the data from the SD card
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return; //Punt. We can't work without SD card
+	}
+	Serial.println("SD init completed.");
+
+	PlayFontBundle();
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+//Add your repeated code here
+}
@@ -0,0 +1,257 @@
+#include "Arduino.h"
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+#define PIN_SPI_CS  11
+#define PIN_SCL 16
+#define PIN_SDA 15
+
+//Renders fixed scenarios through the mixer and compares the output against
+//golden PCM files stored on the SD card. The first time a scenario is run
+//(or whenever its golden file is deleted) the output is recorded as the
+//new golden file instead.
+
+//How many blocks of I2S_BUF_SIZE samples to render for each scenario
+#define GOLDEN_BLOCKS 8
+
+//Largest allowed difference between a rendered sample and the golden sample.
+//Set to 0 to require bit-exact output.
+#define GOLDEN_TOLERANCE 0
+
+//Files used by the scenarios. Change these to match the files on your SD card.
+#define FILE_SIMPLE   "441/CANT2.WAV"
+#define FILE_FONT     "2205/font.wav"
+#define FILE_HUM      "2205/hum.wav"
+#define FILE_CANT     "2205/CANT2.WAV"
+#define FILE_PITCH    "2205/i_font1/swng01.wav"
+#define FILE_POWERON  "2205/pfont1/poweron3.wav"
+#define FILE_CHAINHUM "2205/pfont1/hum.wav"
+
+//Files loaded by the scenario currently running
+ISDWavFile* gapFiles[MAX_WAV_FILES];
+
+//Pitch shifted file for the pitch scenario
+PitchShiftSDWavFile* gpPitchFile = nullptr;
+
+//Player shared by all scenarios (hardware is never started)
+I2SWavPlayer* gpPlayer = nullptr;
+
+//Block of rendered samples
+int32_t gaRendered[I2S_BUF_SIZE];
+
+//Block of golden samples
+int32_t gaGolden[I2S_BUF_SIZE];
+
+//Loads a file into a player channel
+void LoadFile(ISDWavFile* apFile, int aIndex, bool aLooping, float aVolume)
+{
+	apFile->SetLooping(aLooping);
+	apFile->SetVolume(aVolume);
+	gapFiles[aIndex] = apFile;
+	gpPlayer->SetWavFile(apFile, aIndex);
+}
+
+void SetupSimple()
+{
+	LoadFile(new SDWavFile(FILE_SIMPLE), 0, false, 1.0);
+}
+
+void SetupPoly3()
+{
+	LoadFile(new SDWavFile(FILE_FONT), 0, true, 0.5);
+	LoadFile(new SDWavFile(FILE_HUM), 1, true, 1.0);
+	LoadFile(new SDWavFile(FILE_CANT), 2, true, 0.7);
+}
+
+void SetupPitch()
+{
+	gpPitchFile = new PitchShiftSDWavFile(FILE_PITCH);
+	LoadFile(gpPitchFile, 0, true, 1.0);
+}
+
+void UpdatePitch(int aBlock)
+{
+	//Speed up for the first half, slow down for the second half
+	if(aBlock < GOLDEN_BLOCKS / 2)
+	{
+		gpPitchFile->SetRate(0.5);
+	}
+	else
+	{
+		gpPitchFile->SetRate(-0.5);
+	}
+}
+
+void SetupChain()
+{
+	LoadFile(new ChainedSDWavFile(FILE_POWERON, FILE_CHAINHUM), 0, true, 1.0);
+}
+
+struct tGoldenScenario
+{
+	//Name printed in the report
+	const char* mpName;
+	//Golden file on the SD card
+	const char* mpGoldenPath;
+	//Creates the files and loads them into the player
+	void (*mpSetup)();
+	//(optional) Called before each block is rendered to automate parameters
+	void (*mpUpdate)(int aBlock);
+};
+
+tGoldenScenario gaScenarios[] =
+{
+	{"Simple",     "golden/simple.pcm", SetupSimple, nullptr},
+	{"Polyphonic", "golden/poly3.pcm",  SetupPoly3,  nullptr},
+	{"PitchShift", "golden/pitch.pcm",  SetupPitch,  UpdatePitch},
+	{"WavChain",   "golden/chain.pcm",  SetupChain,  nullptr},
+};
+
+//Closes and frees all files loaded by a scenario
+void CleanupScenario()
+{
+	gpPlayer->ClearAllWavFiles();
+
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+	{
+		if(nullptr != gapFiles[lIdx])
+		{
+			gapFiles[lIdx]->Close();
+			delete gapFiles[lIdx];
+			gapFiles[lIdx] = nullptr;
+		}
+	}
+
+	gpPitchFile = nullptr;
+}
+
+//Compares one 16-bit channel of a rendered I2S word against the golden word
+int ChannelDiff(int32_t aRendered, int32_t aGolden, int aChannel)
+{
+	int16_t* lpRendered16 = (int16_t*)&aRendered;
+	int16_t* lpGolden16 = (int16_t*)&aGolden;
+
+	return abs(lpRendered16[aChannel] - lpGolden16[aChannel]);
+}
+
+//Renders a scenario and checks or records its golden file.
+//Returns: TRUE if the output matched (or was recorded), FALSE otherwise
+bool RunScenario(const tGoldenScenario& arScenario)
+{
+	bool lIsRecording = !SD.exists(arScenario.mpGoldenPath);
+	File lGoldenFile = SD.open(arScenario.mpGoldenPath, lIsRecording ? FILE_WRITE : FILE_READ);
+	if(!lGoldenFile)
+	{
+		Serial.print(arScenario.mpName);
+		Serial.println(": could not open golden file.");
+		return false;
+	}
+
+	arScenario.mpSetup();
+
+	int lMaxDiff = 0;
+	unsigned long lNumMismatches = 0;
+
+	for(int lBlock = 0; lBlock < GOLDEN_BLOCKS; lBlock++)
+	{
+		if(nullptr != arScenario.mpUpdate)
+		{
+			arScenario.mpUpdate(lBlock);
+		}
+
+		gpPlayer->Render(gaRendered, I2S_BUF_SIZE);
+
+		if(lIsRecording)
+		{
+			lGoldenFile.write((uint8_t*)gaRendered, sizeof(gaRendered));
+			continue;
+		}
+
+		memset(gaGolden, 0, sizeof(gaGolden));
+		lGoldenFile.read(gaGolden, sizeof(gaGolden));
+
+		for(int lIdx = 0; lIdx < I2S_BUF_SIZE; lIdx++)
+		{
+			for(int lChannel = 0; lChannel < 2; lChannel++)
+			{
+				int lDiff = ChannelDiff(gaRendered[lIdx], gaGolden[lIdx], lChannel);
+				if(lDiff > lMaxDiff)
+				{
+					lMaxDiff = lDiff;
+				}
+				if(lDiff > GOLDEN_TOLERANCE)
+				{
+					lNumMismatches++;
+				}
+			}
+		}
+	}
+
+	lGoldenFile.close();
+	CleanupScenario();
+
+	Serial.print(arScenario.mpName);
+	if(lIsRecording)
+	{
+		Serial.println(": RECORDED");
+		return true;
+	}
+
+	bool lPassed = (0 == lNumMismatches);
+	Serial.print(lPassed ? ": PASS" : ": FAIL");
+	Serial.print(" max diff=");
+	Serial.print(lMaxDiff);
+	Serial.print(" mismatched samples=");
+	Serial.println(lNumMismatches);
+
+	return lPassed;
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	//Initialize SD card. Make sure to do this before creating any SDWavFile objects or
+	//trying to play anything or we won't be able to read the data from the SD card
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return; //Punt. We can't work without SD card
+	}
+	Serial.println("SD init completed.");
+
+	for(int lIdx = 0; lIdx < MAX_WAV_FILES; lIdx++)
+	{
+		gapFiles[lIdx] = nullptr;
+	}
+
+	//Make sure there is somewhere to record golden files
+	if(!SD.exists("golden"))
+	{
+		SD.mkdir("golden");
+	}
+
+	//The player is only used for mixing, the I2S hardware is never started
+	gpPlayer = new I2SWavPlayer();
+	gpPlayer->Configure_I2S_Speed(ee2205);
+
+	bool lAllPassed = true;
+	for(unsigned int lIdx = 0; lIdx < sizeof(gaScenarios)/sizeof(gaScenarios[0]); lIdx++)
+	{
+		lAllPassed &= RunScenario(gaScenarios[lIdx]);
+	}
+
+	Serial.println(lAllPassed ? "All scenarios passed." : "Some scenarios FAILED.");
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+//Add your repeated code here
+}
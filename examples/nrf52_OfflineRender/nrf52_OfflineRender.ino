@@ -0,0 +1,109 @@
+#include "Arduino.h"
+#include <nRF52Audio.h>
+
+#define PIN_SPI_CS  11
+
+//Renders a short sound design timeline to a wav file on the SD card as fast
+//as the CPU allows, then reports how long it took compared to playing it.
+//Nothing is played, the I2S hardware is never started.
+
+//Files used by the timeline. Change these to match the files on your SD card.
+#define FILE_HUM   "2205/hum.wav"
+#define FILE_SWING "2205/i_font1/swng01.wav"
+#define FILE_CLASH "2205/clash1.wav"
+
+//Where the result goes
+#define FILE_OUTPUT "RENDER.WAV"
+
+//Output rate and length of the timeline
+#define RENDER_RATE    ee2205
+#define RENDER_SECONDS 10
+
+//Automation is updated this often (in output samples)
+#define RENDER_STEP 1024
+
+//The output buffers are far too big for the stack
+WavFileAudioSink gOutput(FILE_OUTPUT);
+I2SWavPlayer gPlayer;
+
+//Sets the volume and swing rate for a point on the timeline
+void Automate(I2SWavPlayer* apPlayer, PitchShiftSDWavFile* apSwing, uint32_t aFrame, uint32_t aNumFrames)
+{
+	float lPosition = (float)aFrame / aNumFrames;
+
+	//Sweep the swing up and down twice over the timeline
+	apSwing->SetRate(sin(lPosition * 4.0 * PI) * 0.5);
+
+	//Fade out over the last tenth
+	apPlayer->SetVolume(lPosition < 0.9 ? 0.5 : (1.0 - lPosition) * 5.0);
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return;
+	}
+
+	gPlayer.Configure_I2S_Speed(RENDER_RATE);
+	gOutput.SetSampleRate(RENDER_RATE);
+
+	//Moving the handle in hands the hum over to the player
+	WavFileHandle lHum(new SDWavFile(FILE_HUM));
+	lHum->SetLooping(true);
+	gPlayer.SetWavFile(std::move(lHum), 0);
+
+	PitchShiftSDWavFile* lpSwing = new PitchShiftSDWavFile(FILE_SWING);
+	lpSwing->SetLooping(true);
+	gPlayer.SetWavFile(lpSwing, 1, true);
+
+	//A clash lands exactly 2 seconds in
+	SDWavFile lClash(FILE_CLASH);
+	gPlayer.ScheduleStart(&lClash, 2, SampleRateToHz(RENDER_RATE) * 2);
+
+	uint32_t lNumFrames = SampleRateToHz(RENDER_RATE) * RENDER_SECONDS;
+	gPlayer.ResetMixStats();
+	unsigned long lStart = millis();
+
+	//The sink only writes the file, rendering fills its buffer directly
+	gOutput.Start();
+	for(uint32_t lFrame = 0; lFrame < lNumFrames; lFrame += I2S_BUF_SIZE)
+	{
+		int32_t* lpBuffer = gOutput.GetFreeBuffer();
+		if(nullptr == lpBuffer)
+		{
+			Serial.println("Could not create " FILE_OUTPUT);
+			break;
+		}
+
+		for(int lStep = 0; lStep < I2S_BUF_SIZE; lStep += RENDER_STEP)
+		{
+			Automate(&gPlayer, lpSwing, lFrame + lStep, lNumFrames);
+			gPlayer.Render(&lpBuffer[lStep], RENDER_STEP);
+		}
+
+		gOutput.SubmitBuffer(lpBuffer);
+	}
+	gOutput.Stop();
+
+	//The clash is not owned by the player, take it out before it goes away
+	gPlayer.ClearAllWavFiles();
+
+	Serial.print("Rendered ");
+	Serial.print(RENDER_SECONDS);
+	Serial.print(" s in ");
+	Serial.print(millis() - lStart);
+	Serial.print(" ms (");
+	Serial.print(gPlayer.GetMixStats().mTotalMixMicros / 1000);
+	Serial.println(" ms of that mixing).");
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+}
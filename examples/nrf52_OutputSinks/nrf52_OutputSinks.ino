@@ -0,0 +1,70 @@
+#include "Arduino.h"
+#include <nRF52Audio.h>
+
+#define PIN_PWM_LEFT  A0
+#define PIN_PWM_RIGHT A1
+#define PIN_SPI_CS  11
+
+//The sinks hold their output buffers, which are far too big for the stack
+//Plain speaker/RC filter on two GPIOs, no I2S amp needed
+PWMAudioSink gPWM(PIN_PWM_LEFT, PIN_PWM_RIGHT);
+
+//Mixes as fast as the SD card allows and writes the result to a file
+WavFileAudioSink gRecorder("MIXED.WAV");
+
+//Mixes as fast as the CPU allows and throws the result away
+NullAudioSink gNull;
+
+//Plays a file through whatever output the player is given until it ends
+void PlayThrough(IAudioSink* apSink, const char* apName)
+{
+	I2SWavPlayer* lpPlayer = new I2SWavPlayer();
+	lpPlayer->SetOutputSink(apSink);       //Set before Init(), nullptr goes back to I2S
+	lpPlayer->Init();
+	lpPlayer->Configure_I2S_Speed(ee2205);
+
+	lpPlayer->SetWavFile(new SDWavFile("441/CANT2.WAV"), 0, true);
+	lpPlayer->SetVolume(0.2);
+
+	unsigned long lStart = millis();
+	lpPlayer->StartPlayback();
+
+	while(false == lpPlayer->ContinuePlayback())
+	{
+		//Wait for playback to end
+	}
+
+	lpPlayer->StopPlayback();
+
+	Serial.print(apName);
+	Serial.print(" done in ");
+	Serial.print(millis() - lStart);
+	Serial.println(" ms");
+
+	delete lpPlayer; //Also closes the file, the player owns it
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return;
+	}
+
+	PlayThrough(&gPWM, "PWM");
+	PlayThrough(&gRecorder, "Recording");
+	PlayThrough(&gNull, "Null");
+	Serial.print("Null sink mixed ");
+	Serial.print(gNull.GetPlayedMillis());
+	Serial.println(" ms of audio");
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+}
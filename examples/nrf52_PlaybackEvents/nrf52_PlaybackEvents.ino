@@ -0,0 +1,137 @@
+#include "Arduino.h"
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+#define PIN_SPI_CS  11
+#define PIN_SCL 16
+#define PIN_SDA 15
+
+//Runs an ignite -> hum -> retract sequence driven by playback events instead
+//of polling. The hum starts within one block of the ignite sound ending, and
+//playback stops as soon as the retract sound is done.
+
+//How long to hum before retracting (milliseconds)
+#define HUM_TIME_MS 10000
+
+//Files to play. Change these to match the files on your SD card.
+#define FILE_IGNITE  "2205/pfont1/poweron3.wav"
+#define FILE_HUM     "2205/pfont1/hum.wav"
+#define FILE_RETRACT "2205/pfont1/pwroff.wav"
+
+enum ESaberState
+{
+	eeStateIgnite,
+	eeStateHum,
+	eeStateRetract,
+	eeStateOff
+};
+
+I2SWavPlayer* gpPlayer = nullptr;
+SDWavFile* gpIgniteFile = nullptr;
+SDWavFile* gpHumFile = nullptr;
+SDWavFile* gpRetractFile = nullptr;
+
+volatile ESaberState gState = eeStateIgnite;
+unsigned long gNumHumLoops = 0;
+
+//Called by the player right after each block is mixed
+void PlaybackEventCallback(const tPlayerEvent& arEvent, void* apContext)
+{
+	if(eeWavFileLooped == arEvent.mType)
+	{
+		gNumHumLoops++;
+	}
+	else if(eeWavFileEnded == arEvent.mType)
+	{
+		if(eeStateIgnite == gState)
+		{
+			gpPlayer->SetWavFile(gpHumFile, 0);
+			gState = eeStateHum;
+		}
+		else if(eeStateRetract == gState)
+		{
+			gState = eeStateOff;
+		}
+	}
+}
+
+void PlayWavFiles()
+{
+	gpIgniteFile = new SDWavFile(FILE_IGNITE);
+	gpHumFile = new SDWavFile(FILE_HUM);
+	gpRetractFile = new SDWavFile(FILE_RETRACT);
+	gpHumFile->SetLooping(true);
+
+	//Create a new I2S Player
+	gpPlayer = new I2SWavPlayer(PIN_I2S_MCK,
+								PIN_I2S_BCLK,
+								PIN_I2S_LRCK,
+								PIN_I2S_DIN,
+								PIN_I2S_SD);
+
+	gpPlayer->Init();
+	gpPlayer->Configure_I2S_Speed(ee2205);
+	gpPlayer->SetVolume(0.2);
+	gpPlayer->SetEventCallback(PlaybackEventCallback);
+
+	gpPlayer->SetWavFile(gpIgniteFile, 0);
+	gpPlayer->StartPlayback();
+
+	Serial.println("Ignite.");
+	unsigned long lHumStartTime = 0;
+
+	while(eeStateOff != gState)
+	{
+		gpPlayer->ContinuePlayback();
+
+		if(eeStateHum == gState)
+		{
+			if(0 == lHumStartTime)
+			{
+				Serial.println("Hum.");
+				lHumStartTime = millis();
+			}
+			else if(millis() - lHumStartTime > HUM_TIME_MS)
+			{
+				Serial.println("Retract.");
+				gState = eeStateRetract;
+				gpPlayer->SetWavFile(gpRetractFile, 0);
+			}
+		}
+	}
+
+	gpPlayer->StopPlayback();
+
+	Serial.print("Off. Hum looped ");
+	Serial.print(gNumHumLoops);
+	Serial.print(" times, dropped events=");
+	Serial.println(gpPlayer->GetNumDroppedEvents());
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	//Initialize SD card. Make sure to do this before creating any SDWavFile objects or
+	//trying to play anything or we won't be able to read the data from the SD card
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return; //Punt. We can't work without SD card
+	}
+	Serial.println("SD init completed.");
+
+	PlayWavFiles();
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+//Add your repeated code here
+}
@@ -0,0 +1,92 @@
+#include "Arduino.h"
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+#define PIN_SPI_CS  11
+#define PIN_SCL 16
+#define PIN_SDA 15
+
+//Plays files from FreeRTOS tasks instead of calling ContinuePlayback() in a loop.
+//The audio task mixes whenever the I2S hardware needs data and the I/O task reads
+//from the SD card in between, so loop() is free to do other work.
+
+//Files to play. Change these to match the files on your SD card.
+#define FILE_HUM   "2205/hum.wav"
+#define FILE_SWING "2205/swing1.wav"
+
+//The runtime is woken by the I2S interrupt
+AUDIO_RUNTIME_I2S_IRQ_HANDLER()
+
+I2SWavPlayer* gpPlayer = nullptr;
+SDWavFile* gpSwingFile = nullptr;
+IOScheduler gIOScheduler;
+AudioRuntime* gpRuntime = nullptr;
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	//Initialize SD card. Make sure to do this before creating any SDWavFile objects or
+	//trying to play anything or we won't be able to read the data from the SD card
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return; //Punt. We can't work without SD card
+	}
+	Serial.println("SD init completed.");
+
+	SDWavFile* lpHumFile = new SDWavFile(FILE_HUM);
+	gpSwingFile = new SDWavFile(FILE_SWING);
+	lpHumFile->SetLooping(true);
+	gpSwingFile->SetLooping(true);
+
+	//Create a new I2S Player
+	gpPlayer = new I2SWavPlayer(PIN_I2S_MCK,
+								PIN_I2S_BCLK,
+								PIN_I2S_LRCK,
+								PIN_I2S_DIN,
+								PIN_I2S_SD);
+
+	gpPlayer->Init();
+	gpPlayer->Configure_I2S_Speed(ee2205);
+	gpPlayer->SetVolume(0.2);
+	gpPlayer->SetWavFile(lpHumFile, 0);
+	gpPlayer->SetWavFile(gpSwingFile, 1);
+
+	//Starts playback, the tasks keep it going from here on
+	gpRuntime = new AudioRuntime(gpPlayer, &gIOScheduler);
+	if(!gpRuntime->Begin())
+	{
+		Serial.println("Could not start audio tasks.");
+		return;
+	}
+
+	Serial.println("Playback started.");
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+	if(nullptr == gpRuntime || !gpRuntime->IsRunning())
+	{
+		return;
+	}
+
+	//The player belongs to the audio task now, so use the queued calls
+	gpPlayer->QueuePause(gpSwingFile);
+	delay(1000);
+	gpPlayer->QueueUnPause(gpSwingFile);
+	delay(1000);
+
+	const tIOSchedulerStats& lrStats = gIOScheduler.GetStats();
+	Serial.print("Blocks mixed=");
+	Serial.print(gpRuntime->GetNumBlocks());
+	Serial.print(", read misses=");
+	Serial.println(lrStats.mNumMisses);
+}
@@ -0,0 +1,225 @@
+#include "Arduino.h"
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+#define PIN_SPI_CS  11
+
+//Qualifies an SD card for playback. Streams a number of voices from the card
+//in real time while timing every SD card read, then reports the read latency
+//(p50, p99 and max) and how much buffering it takes to ride out the slowest
+//reads. Cards that need more than the player has will underrun in the field.
+//
+//The raw histogram is printed too. Save the serial output to a file and run
+//extras/sd_latency_report.py on it to compare cards or combine several runs.
+
+//How many voices to stream at once (up to MAX_WAV_FILES)
+#define QUAL_VOICES 5
+
+//How long to stream for
+#define QUAL_SECONDS 60
+
+//Output rate
+#define QUAL_RATE ee2205
+
+//File every voice streams. Use a long file, each voice starts at a different
+//spot so the reads are spread over the card like they are with separate files.
+#define QUAL_FILE "2205/hum.wav"
+
+//Read times are recorded here
+ReadLatencyHistogram gHistogram;
+
+//The player's output buffers are far too big for the stack
+I2SWavPlayer gPlayer(PIN_I2S_MCK, PIN_I2S_BCLK, PIN_I2S_LRCK, PIN_I2S_DIN, PIN_I2S_SD);
+
+//Prints one line of the latency summary
+void PrintLatency(const char* apLabel, int aSizeClass)
+{
+	Serial.print(apLabel);
+	Serial.print(": reads=");
+	Serial.print(gHistogram.GetCount(aSizeClass));
+	Serial.print(" p50=");
+	Serial.print(gHistogram.GetPercentile(50.0, aSizeClass));
+	Serial.print("us p99=");
+	Serial.print(gHistogram.GetPercentile(99.0, aSizeClass));
+	Serial.print("us max=");
+	Serial.print(gHistogram.GetMax(aSizeClass));
+	Serial.println("us");
+}
+
+//Prints how much buffering it takes to ride out a read of a given latency
+void PrintDepth(const char* apLabel, uint32_t aLatencyMicros, uint32_t aMixMicros, uint32_t aBytesPerSecond)
+{
+	uint32_t lRate = SampleRateToHz(QUAL_RATE);
+
+	//Without read-ahead, reads happen while mixing, so one output block
+	//has to last through a normal mix plus the slow read
+	uint32_t lBlockFrames = ((uint64_t)(aLatencyMicros + aMixMicros) * lRate + 999999) / 1000000;
+
+	//With an IOScheduler each voice plays from its read-ahead blocks while a
+	//read is stuck, plus the block being read
+	uint32_t lPrefetchBlocks = ((uint64_t)aLatencyMicros * aBytesPerSecond / 1000000 + DATA_BLOCK_SIZE - 1) / DATA_BLOCK_SIZE + 1;
+
+	Serial.print(apLabel);
+	Serial.print(": output block >= ");
+	Serial.print(lBlockFrames);
+	Serial.print(" frames (have ");
+	Serial.print(I2S_BUF_SIZE);
+	Serial.print(lBlockFrames <= I2S_BUF_SIZE ? ", OK)" : ", TOO SMALL)");
+	Serial.print(", read-ahead >= ");
+	Serial.print(lPrefetchBlocks);
+	Serial.print(" blocks per voice (have ");
+	Serial.print(IO_SCHEDULER_PREFETCH_BLOCKS);
+	Serial.println(lPrefetchBlocks <= IO_SCHEDULER_PREFETCH_BLOCKS ? ", OK)" : ", TOO SMALL)");
+}
+
+//Prints the raw histogram for extras/sd_latency_report.py
+void PrintRaw(uint32_t aBytesPerSecond)
+{
+	Serial.print("RUN,");
+	Serial.print(QUAL_VOICES);
+	Serial.print(",");
+	Serial.print(SampleRateToHz(QUAL_RATE));
+	Serial.print(",");
+	Serial.print(aBytesPerSecond);
+	Serial.print(",");
+	Serial.print(I2S_BUF_SIZE);
+	Serial.print(",");
+	Serial.println(DATA_BLOCK_SIZE);
+
+	for(int lSizeClass = 0; lSizeClass < LATENCY_SIZE_CLASSES; lSizeClass++)
+	{
+		for(int lBucket = 0; lBucket < LATENCY_NUM_BUCKETS; lBucket++)
+		{
+			uint32_t lCount = gHistogram.GetBucketCount(lSizeClass, lBucket);
+			if(lCount > 0)
+			{
+				Serial.print("LAT,");
+				Serial.print(ReadLatencyHistogram::GetSizeClassLimit(lSizeClass));
+				Serial.print(",");
+				Serial.print(ReadLatencyHistogram::GetBucketLimit(lBucket));
+				Serial.print(",");
+				Serial.println(lCount);
+			}
+		}
+
+		if(gHistogram.GetCount(lSizeClass) > 0)
+		{
+			Serial.print("MAX,");
+			Serial.print(ReadLatencyHistogram::GetSizeClassLimit(lSizeClass));
+			Serial.print(",");
+			Serial.println(gHistogram.GetMax(lSizeClass));
+		}
+	}
+
+	Serial.println("END");
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return;
+	}
+
+	gPlayer.Init();
+	gPlayer.Configure_I2S_Speed(QUAL_RATE);
+	gPlayer.SetVolume(0.0); //Nobody needs to listen
+
+	//Every voice has to be streamed the whole time, so never drop one to catch up
+	gPlayer.SetAdaptiveQuality(false);
+
+	uint32_t lBytesPerSecond = 0;
+	for(int lIdx = 0; lIdx < QUAL_VOICES; lIdx++)
+	{
+		SDWavFile* lpFile = new SDWavFile(QUAL_FILE);
+		lpFile->SetLooping(true);
+		lpFile->SeekToSample(lpFile->GetFormat().mNumSamples / QUAL_VOICES * lIdx);
+		lBytesPerSecond = lpFile->GetHeader().byteRate;
+		gPlayer.SetWavFile(lpFile, lIdx, true);
+	}
+
+	Serial.print("Streaming ");
+	Serial.print(QUAL_VOICES);
+	Serial.print(" voices for ");
+	Serial.print(QUAL_SECONDS);
+	Serial.println(" s...");
+
+	//Only time reads made while streaming, not the ones made opening the files
+	gHistogram.Reset();
+	BufferedFileReader::SetLatencyHistogram(&gHistogram);
+
+	unsigned long lNumLate = 0;
+	unsigned long lLastBlock = 0;
+	unsigned long lBlockMicros = (uint64_t)I2S_BUF_SIZE * 1000000 / SampleRateToHz(QUAL_RATE);
+	unsigned long lStart = millis();
+
+	gPlayer.StartPlayback();
+	while(millis() - lStart < QUAL_SECONDS * 1000UL)
+	{
+		gPlayer.ContinuePlayback();
+
+		//A block that took longer to mix (SD card reads included) than to play is an underrun
+		const I2SWavPlayer::tMixStats& lrStats = gPlayer.GetMixStats();
+		if(lrStats.mBlocksMixed != lLastBlock)
+		{
+			lLastBlock = lrStats.mBlocksMixed;
+			if(lrStats.mLastMixMicros > lBlockMicros)
+			{
+				lNumLate++;
+			}
+		}
+	}
+	gPlayer.StopPlayback();
+	gPlayer.ClearAllWavFiles(); //Closes the files, the player owns them
+
+	BufferedFileReader::SetLatencyHistogram(nullptr);
+
+	for(int lSizeClass = 0; lSizeClass < LATENCY_SIZE_CLASSES; lSizeClass++)
+	{
+		if(gHistogram.GetCount(lSizeClass) > 0)
+		{
+			char lLabel[24];
+			uint32_t lLimit = ReadLatencyHistogram::GetSizeClassLimit(lSizeClass);
+			if(0 == lLimit)
+			{
+				snprintf(lLabel, sizeof(lLabel), "Reads > %lu B", (unsigned long)ReadLatencyHistogram::GetSizeClassLimit(lSizeClass - 1));
+			}
+			else
+			{
+				snprintf(lLabel, sizeof(lLabel), "Reads <= %lu B", (unsigned long)lLimit);
+			}
+			PrintLatency(lLabel, lSizeClass);
+		}
+	}
+	PrintLatency("All reads", -1);
+
+	uint32_t lStreamBytesPerSecond = lBytesPerSecond * QUAL_VOICES;
+	const I2SWavPlayer::tMixStats& lrStats = gPlayer.GetMixStats();
+	uint32_t lMixMicros = lrStats.mBlocksMixed > 0 ? lrStats.mTotalMixMicros / lrStats.mBlocksMixed : 0;
+	PrintDepth("To survive p99", gHistogram.GetPercentile(99.0), lMixMicros, lBytesPerSecond);
+	PrintDepth("To survive max", gHistogram.GetMax(), lMixMicros, lBytesPerSecond);
+
+	Serial.print("Streamed ");
+	Serial.print(lStreamBytesPerSecond);
+	Serial.print(" B/s, ");
+	Serial.print(lNumLate);
+	Serial.print(" of ");
+	Serial.print(lLastBlock);
+	Serial.println(" blocks were late.");
+
+	PrintRaw(lBytesPerSecond);
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+}
@@ -0,0 +1,99 @@
+#include "Arduino.h"
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+#define PIN_SPI_CS  11
+#define PIN_SCL 16
+#define PIN_SDA 15
+
+//Layers a clash out of two sounds that start a fixed number of samples
+//apart, every time. The starts are scheduled on the player's playback clock,
+//so the layering doesn't depend on when the loop gets around to it.
+
+//How far apart the two layers start (samples at 22.05 KHz, 110 = 5ms)
+#define LAYER_OFFSET_SAMPLES 110
+
+//How often to play the clash (milliseconds)
+#define CLASH_PERIOD_MS 1500
+
+//How long to run (milliseconds)
+#define RUN_TIME_MS 30000
+
+//Files to play. Change these to match the files on your SD card.
+#define FILE_HUM    "2205/pfont1/hum.wav"
+#define FILE_CLASH1 "2205/pfont1/clash1.wav"
+#define FILE_CLASH2 "2205/pfont1/clash2.wav"
+
+void PlayWavFiles()
+{
+	SDWavFile* lpHumFile = new SDWavFile(FILE_HUM);
+	SDWavFile* lpClashFile1 = new SDWavFile(FILE_CLASH1);
+	SDWavFile* lpClashFile2 = new SDWavFile(FILE_CLASH2);
+	lpHumFile->SetLooping(true);
+
+	//Create a new I2S Player
+	I2SWavPlayer* lpPlayer = new I2SWavPlayer(PIN_I2S_MCK,
+											  PIN_I2S_BCLK,
+											  PIN_I2S_LRCK,
+											  PIN_I2S_DIN,
+											  PIN_I2S_SD);
+
+	lpPlayer->Init();
+	lpPlayer->Configure_I2S_Speed(ee2205);
+	lpPlayer->SetVolume(0.2);
+
+	lpPlayer->SetWavFile(lpHumFile, 0);
+	lpPlayer->StartPlayback();
+
+	Serial.println("Playback started.");
+	unsigned long lStartTime = millis();
+	unsigned long lLastClashTime = lStartTime;
+
+	while(millis() - lStartTime < RUN_TIME_MS)
+	{
+		lpPlayer->ContinuePlayback();
+
+		if(millis() - lLastClashTime > CLASH_PERIOD_MS)
+		{
+			lLastClashTime = millis();
+
+			//Start far enough ahead that the mixer hasn't passed that point yet
+			uint64_t lClashTime = lpPlayer->GetPlaybackClock() + 2 * I2S_BUF_SIZE;
+
+			//Both layers play in the right channel (odd numbered channels)
+			lpPlayer->ScheduleStart(lpClashFile1, 1, lClashTime);
+			lpPlayer->ScheduleStart(lpClashFile2, 3, lClashTime + LAYER_OFFSET_SAMPLES);
+		}
+	}
+
+	lpPlayer->StopPlayback();
+	Serial.println("Playback ended.");
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	//Initialize SD card. Make sure to do this before creating any SDWavFile objects or
+	//trying to play anything or we won't be able to read the data from the SD card
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return; //Punt. We can't work without SD card
+	}
+	Serial.println("SD init completed.");
+
+	PlayWavFiles();
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+//Add your repeated code here
+}
@@ -0,0 +1,95 @@
+#include "Arduino.h"
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+#define PIN_SPI_CS  11
+#define PIN_SCL 16
+#define PIN_SDA 15
+
+//Plays a hum with a "smooth swing" pair on top. Both swing loops play in one
+//player channel and are crossfaded from the swing direction, while the swing
+//speed sets how loud they are. The motion here is made up; on a saber it
+//would come from the gyro.
+
+//How long one simulated swing takes (milliseconds)
+#define SWING_PERIOD_MS 1200
+
+//How long to run (milliseconds)
+#define RUN_TIME_MS 30000
+
+//Files to play. Change these to match the files on your SD card.
+#define FILE_HUM    "2205/pfont1/hum.wav"
+#define FILE_SWINGL "2205/pfont1/swingl1.wav"
+#define FILE_SWINGH "2205/pfont1/swingh1.wav"
+
+void PlayWavFiles()
+{
+	SDWavFile* lpHumFile = new SDWavFile(FILE_HUM);
+	lpHumFile->SetLooping(true);
+
+	//Swing pair, silent until the blade moves
+	SmoothSwingWavFile* lpSwing = new SmoothSwingWavFile(FILE_SWINGL, FILE_SWINGH);
+	lpSwing->SetVolume(0.0);
+
+	//Create a new I2S Player
+	I2SWavPlayer* lpPlayer = new I2SWavPlayer(PIN_I2S_MCK,
+											  PIN_I2S_BCLK,
+											  PIN_I2S_LRCK,
+											  PIN_I2S_DIN,
+											  PIN_I2S_SD);
+
+	lpPlayer->Init();
+	lpPlayer->Configure_I2S_Speed(ee2205);
+	lpPlayer->SetVolume(0.2);
+
+	lpPlayer->SetWavFile(lpHumFile, 0);
+	lpPlayer->SetWavFile(lpSwing, 1);
+	lpPlayer->StartPlayback();
+
+	Serial.println("Playback started.");
+	unsigned long lStartTime = millis();
+
+	while(millis() - lStartTime < RUN_TIME_MS)
+	{
+		lpPlayer->ContinuePlayback();
+
+		//Simulated swing: the angle goes back and forth, speed peaks mid-swing
+		float lPhase = (float)((millis() - lStartTime) % SWING_PERIOD_MS) / SWING_PERIOD_MS;
+		float lAngle = 0.5 - 0.5 * cos(2.0 * PI * lPhase);
+		float lSpeed = fabs(sin(2.0 * PI * lPhase));
+
+		lpSwing->SetSwing(lAngle);
+		lpSwing->SetVolume(lSpeed);
+	}
+
+	lpPlayer->StopPlayback();
+	Serial.println("Playback ended.");
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	//Initialize SD card. Make sure to do this before creating any SDWavFile objects or
+	//trying to play anything or we won't be able to read the data from the SD card
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return; //Punt. We can't work without SD card
+	}
+	Serial.println("SD init completed.");
+
+	PlayWavFiles();
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+//Add your repeated code here
+}
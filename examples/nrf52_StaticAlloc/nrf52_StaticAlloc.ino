@@ -0,0 +1,232 @@
+#include "Arduino.h"
+#include <malloc.h>
+#include <nRF52Audio.h>
+
+#define PIN_I2S_MCK 13
+#define PIN_I2S_BCLK (A2) // A4
+#define PIN_I2S_LRCK (A3) // A5
+#define PIN_I2S_DIN 18 // A6
+#define PIN_I2S_SD  10 // 27
+#define PIN_SPI_CS  11
+#define PIN_SCL 16
+#define PIN_SDA 15
+
+//Plays a hum, a chained ignition and a smooth swing pair without the library
+//using the heap. The player and files are built in static storage and the
+//library keeps everything it needs inside them. Every call to new is counted,
+//and so is every call to malloc() and free() when they are wrapped (see
+//below). The SD library mallocs a small handle for each file it opens, which
+//the library can't avoid, so those are reported on their own. While the voices
+//play the heap is watched and must never grow past where it started.
+//
+//Uncomment NRF52AUDIO_STATIC_ALLOC in AudioAlloc.h (in the library folder)
+//before building this. Without it the files allocate their read buffers and
+//the counts below won't be zero.
+//
+//malloc() and free() are only counted if the linker wraps them. Add these to
+//the link flags (build_flags in PlatformIO, or compiler.c.elf.extra_flags in
+//platform.local.txt for the Arduino IDE):
+//   -Wl,--wrap=malloc -Wl,--wrap=free
+//Without them the sketch says so, and only counts new and heap growth.
+
+//How long to run (milliseconds)
+#define RUN_TIME_MS 10000
+
+//Files to play. Change these to match the files on your SD card.
+#define FILE_HUM    "2205/pfont1/hum.wav"
+#define FILE_POWER  "2205/pfont1/poweron.wav"
+#define FILE_SWINGL "2205/pfont1/swingl1.wav"
+#define FILE_SWINGH "2205/pfont1/swingh1.wav"
+
+//Number of times new was called
+static volatile unsigned long sNumAllocs = 0;
+
+//Number of times malloc() and free() were called (only when wrapped)
+static volatile unsigned long sNumMallocs = 0;
+static volatile unsigned long sNumFrees = 0;
+
+extern "C"
+{
+void* __real_malloc(size_t aSize);
+void __real_free(void* apPtr);
+
+void* __wrap_malloc(size_t aSize)
+{
+	sNumMallocs++;
+	return __real_malloc(aSize);
+}
+
+void __wrap_free(void* apPtr)
+{
+	if(nullptr != apPtr)
+	{
+		sNumFrees++;
+	}
+	__real_free(apPtr);
+}
+}
+
+void* operator new(size_t aSize)
+{
+	sNumAllocs++;
+	return malloc(aSize);
+}
+
+void* operator new[](size_t aSize)
+{
+	sNumAllocs++;
+	return malloc(aSize);
+}
+
+void operator delete(void* apPtr)
+{
+	free(apPtr);
+}
+
+void operator delete[](void* apPtr)
+{
+	free(apPtr);
+}
+
+//Check that malloc() really goes through __wrap_malloc()
+bool IsMallocCounted()
+{
+	unsigned long lStartMallocs = sNumMallocs;
+
+	//volatile so the compiler can't drop the pair
+	void* volatile lpProbe = malloc(4);
+	free(lpProbe);
+
+	return sNumMallocs != lStartMallocs;
+}
+
+//Storage for everything the sketch creates
+static uint8_t saPlayerStorage[sizeof(I2SWavPlayer)] __attribute__((aligned(8)));
+static uint8_t saHumStorage[sizeof(SDWavFile)] __attribute__((aligned(8)));
+static uint8_t saIgnitionStorage[sizeof(ChainedSDWavFile)] __attribute__((aligned(8)));
+static uint8_t saSwingStorage[sizeof(SmoothSwingWavFile)] __attribute__((aligned(8)));
+
+void PlayWavFiles()
+{
+	bool lIsMallocCounted = IsMallocCounted();
+	if(!lIsMallocCounted)
+	{
+		Serial.println("malloc() is not counted, link with -Wl,--wrap=malloc -Wl,--wrap=free to count it.");
+	}
+
+	unsigned long lStartAllocs = sNumAllocs;
+	unsigned long lStartMallocs = sNumMallocs;
+	unsigned long lStartFrees = sNumFrees;
+	int lStartHeap = mallinfo().uordblks;
+
+	SDWavFile* lpHumFile = new(saHumStorage) SDWavFile(FILE_HUM);
+	lpHumFile->SetLooping(true);
+
+	ChainedSDWavFile* lpIgnition = new(saIgnitionStorage) ChainedSDWavFile(FILE_POWER, FILE_HUM);
+
+	SmoothSwingWavFile* lpSwing = new(saSwingStorage) SmoothSwingWavFile(FILE_SWINGL, FILE_SWINGH);
+	lpSwing->SetVolume(0.5);
+	lpSwing->SetSwing(0.5);
+
+	I2SWavPlayer* lpPlayer = new(saPlayerStorage) I2SWavPlayer(PIN_I2S_MCK,
+															   PIN_I2S_BCLK,
+															   PIN_I2S_LRCK,
+															   PIN_I2S_DIN,
+															   PIN_I2S_SD);
+
+	lpPlayer->Init();
+	lpPlayer->Configure_I2S_Speed(ee2205);
+	lpPlayer->SetVolume(0.2);
+
+	lpPlayer->SetWavFile(lpHumFile, 0);
+	lpPlayer->SetWavFile(lpIgnition, 1);
+	lpPlayer->SetWavFile(lpSwing, 2);
+
+	//Whatever was allocated so far came from opening the files
+	unsigned long lOpenMallocs = sNumMallocs - lStartMallocs;
+	int lOpenHeap = mallinfo().uordblks;
+
+	unsigned long lPlayMallocs = sNumMallocs;
+	int lPeakHeap = lOpenHeap;
+
+	lpPlayer->StartPlayback();
+
+	Serial.println("Playback started.");
+	unsigned long lStartTime = millis();
+
+	while(millis() - lStartTime < RUN_TIME_MS)
+	{
+		lpPlayer->ContinuePlayback();
+
+		int lHeap = mallinfo().uordblks;
+		if(lHeap > lPeakHeap)
+		{
+			lPeakHeap = lHeap;
+		}
+	}
+
+	lpPlayer->StopPlayback();
+	Serial.println("Playback ended.");
+
+	lPlayMallocs = sNumMallocs - lPlayMallocs;
+
+	//Tear down by hand, nothing here came from new
+	lpPlayer->ClearAllWavFiles();
+	lpPlayer->~I2SWavPlayer();
+	lpSwing->~SmoothSwingWavFile();
+	lpIgnition->~ChainedSDWavFile();
+	lpHumFile->~SDWavFile();
+
+	Serial.print("Calls to new: ");
+	Serial.println(sNumAllocs - lStartAllocs);
+	if(lIsMallocCounted)
+	{
+		Serial.print("Calls to malloc/free: ");
+		Serial.print(sNumMallocs - lStartMallocs);
+		Serial.print("/");
+		Serial.println(sNumFrees - lStartFrees);
+		Serial.print("Calls to malloc while opening files (SD library): ");
+		Serial.println(lOpenMallocs);
+		Serial.print("Calls to malloc while playing: ");
+		Serial.println(lPlayMallocs);
+	}
+	Serial.print("Heap used while setting up (bytes): ");
+	Serial.println(lOpenHeap - lStartHeap);
+	Serial.print("Peak heap growth while playing (bytes): ");
+	Serial.println(lPeakHeap - lOpenHeap);
+	Serial.print("Heap left after teardown (bytes): ");
+	Serial.println(mallinfo().uordblks - lStartHeap);
+
+	if(sNumAllocs == lStartAllocs && 0 == lPlayMallocs && lPeakHeap == lOpenHeap)
+	{
+		Serial.println("PASS: the library used no heap.");
+	}
+	else
+	{
+		Serial.println("FAIL: the heap was used. Is NRF52AUDIO_STATIC_ALLOC defined?");
+	}
+}
+
+//The setup function is called once at startup of the sketch
+void setup()
+{
+	delay(1000);
+	Serial.begin(115200);
+
+	//Initialize SD card. Make sure to do this before creating any SDWavFile objects or
+	//trying to play anything or we won't be able to read the data from the SD card
+	if(!SD.begin(8000000, PIN_SPI_CS))
+	{
+		Serial.println("SD init failed.");
+		return; //Punt. We can't work without SD card
+	}
+	Serial.println("SD init completed.");
+
+	PlayWavFiles();
+}
+
+// The loop function is called in an endless loop
+void loop()
+{
+//Add your repeated code here
+}
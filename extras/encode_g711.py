@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# Converts a 16-bit PCM wav file to 8-bit G.711 (mu-law or A-law) with a
+# canonical 44 byte header. Files from other tools, which usually add an
+# extended fmt chunk and a "fact" chunk for these formats, play as well.
+#
+# Usage: encode_g711.py [--alaw] input.wav output.wav
+
+import struct
+import sys
+
+WAVE_FORMAT_PCM = 1
+WAVE_FORMAT_ALAW = 6
+WAVE_FORMAT_MULAW = 7
+
+MULAW_BIAS = 0x84
+MULAW_CLIP = 32635
+
+
+def encode_mulaw(aSample):
+    lSign = 0x80 if aSample < 0 else 0
+    lMagnitude = min(abs(aSample), MULAW_CLIP) + MULAW_BIAS
+    lExponent = 7
+    while lExponent > 0 and not (lMagnitude & (0x4000 >> (7 - lExponent))):
+        lExponent -= 1
+    lMantissa = (lMagnitude >> (lExponent + 3)) & 0x0F
+    return ~(lSign | (lExponent << 4) | lMantissa) & 0xFF
+
+
+def encode_alaw(aSample):
+    lSign = 0x80 if aSample >= 0 else 0
+    lMagnitude = min(abs(aSample) if aSample >= 0 else -aSample - 1, 0x7FFF) >> 3
+    if lMagnitude < 32:
+        lByte = lMagnitude >> 1
+    else:
+        lExponent = 1
+        while lMagnitude >= (64 << (lExponent - 1)) and lExponent < 7:
+            lExponent += 1
+        lByte = (lExponent << 4) | ((lMagnitude >> lExponent) & 0x0F)
+    return (lSign | lByte) ^ 0x55
+
+
+def read_wav(aPath):
+    """Returns (fmt bytes, data bytes) for a wav file."""
+    with open(aPath, "rb") as lFile:
+        lRaw = lFile.read()
+
+    if lRaw[0:4] != b"RIFF" or lRaw[8:12] != b"WAVE":
+        raise ValueError("Not a wav file: %s" % aPath)
+
+    lFmt = None
+    lData = None
+    lPos = 12
+    while lPos + 8 <= len(lRaw):
+        lId, lSize = struct.unpack_from("<4sI", lRaw, lPos)
+        lBody = lRaw[lPos + 8:lPos + 8 + lSize]
+        if lId == b"fmt ":
+            lFmt = lBody[0:16]
+        elif lId == b"data":
+            lData = lBody
+        lPos += 8 + lSize + (lSize & 1)
+
+    if lFmt is None or lData is None:
+        raise ValueError("Missing fmt or data chunk: %s" % aPath)
+
+    return lFmt, lData
+
+
+def main(aArgs):
+    lFormat = WAVE_FORMAT_MULAW
+    if aArgs and aArgs[0] == "--alaw":
+        lFormat = WAVE_FORMAT_ALAW
+        aArgs = aArgs[1:]
+
+    if len(aArgs) != 2:
+        print("Usage: encode_g711.py [--alaw] input.wav output.wav")
+        return 1
+
+    try:
+        lFmt, lData = read_wav(aArgs[0])
+    except ValueError as lError:
+        print(lError)
+        return 1
+
+    lAudioFormat, lChannels, lRate = struct.unpack_from("<HHI", lFmt, 0)
+    lBits = struct.unpack_from("<H", lFmt, 14)[0]
+    if lAudioFormat != WAVE_FORMAT_PCM or lBits != 16:
+        print("Input must be 16-bit PCM: %s" % aArgs[0])
+        return 1
+
+    lEncode = encode_mulaw if lFormat == WAVE_FORMAT_MULAW else encode_alaw
+    lNumSamples = len(lData) // 2
+    lSamples = struct.unpack("<%dh" % lNumSamples, lData[0:lNumSamples * 2])
+    lEncoded = bytes(lEncode(lSample) for lSample in lSamples)
+
+    with open(aArgs[1], "wb") as lOut:
+        lOut.write(struct.pack("<4sI4s4sIHHIIHH4sI",
+                               b"RIFF", 36 + len(lEncoded), b"WAVE",
+                               b"fmt ", 16, lFormat, lChannels, lRate,
+                               lRate * lChannels, lChannels, 8,
+                               b"data", len(lEncoded)))
+        lOut.write(lEncoded)
+
+    print("Encoded %d samples into %s" % (lNumSamples, aArgs[1]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# Packs the wav files of a sound font into a single bundle file that
+# FontBundle/BundleWavFile can play from with one open file handle.
+#
+# Bundle layout (all values little-endian):
+#   "NFNT"                  4 bytes magic
+#   version                 uint32 (1)
+#   sound count             uint32
+#   entries[count]          24 byte null terminated name, uint32 offset, uint32 size,
+#                           uint32 sample rate, uint16 channels, uint16 bits per sample,
+#                           uint32 loop start, uint32 loop end
+#   sounds                  each one a canonical 44 byte header wav file starting
+#                           on a 512 byte (SD sector) boundary
+#
+# Loop points are taken from the wav file's "smpl" chunk if it has one,
+# otherwise the whole file is looped.
+#
+# Usage: pack_font_bundle.py output.bnd file1.wav [file2.wav ...]
+# Sounds are stored under their base name unless given as NAME=path.
+# A bundle holds at most 64 sounds, FontBundle won't open a bigger one.
+
+import os
+import struct
+import sys
+
+NAME_SIZE = 24
+HEADER_FORMAT = "<4sII"
+ENTRY_FORMAT = "<%dsIIIHHII" % NAME_SIZE
+VERSION = 1
+ALIGNMENT = 512
+MAX_SOUNDS = 64  # FONT_BUNDLE_MAX_SOUNDS in FontBundle.h
+
+
+def align(aValue):
+    return (aValue + ALIGNMENT - 1) & ~(ALIGNMENT - 1)
+
+
+def read_wav(aPath):
+    """Returns (fmt bytes, data bytes, loop start, loop end) for a wav file."""
+    with open(aPath, "rb") as lFile:
+        lRaw = lFile.read()
+
+    if lRaw[0:4] != b"RIFF" or lRaw[8:12] != b"WAVE":
+        raise ValueError("Not a wav file: %s" % aPath)
+
+    lFmt = None
+    lData = None
+    lLoop = None
+    lPos = 12
+    while lPos + 8 <= len(lRaw):
+        lId, lSize = struct.unpack_from("<4sI", lRaw, lPos)
+        lBody = lRaw[lPos + 8:lPos + 8 + lSize]
+        if lId == b"fmt ":
+            lFmt = lBody[0:16]
+        elif lId == b"data":
+            lData = lBody
+        elif lId == b"smpl" and len(lBody) >= 60:
+            lNumLoops = struct.unpack_from("<I", lBody, 28)[0]
+            if lNumLoops > 0:
+                lLoop = struct.unpack_from("<II", lBody, 36 + 8)
+        lPos += 8 + lSize + (lSize & 1)
+
+    if lFmt is None or lData is None:
+        raise ValueError("Missing fmt or data chunk: %s" % aPath)
+
+    lBlockAlign = struct.unpack_from("<H", lFmt, 12)[0] or 1
+    lNumSamples = len(lData) // lBlockAlign
+    if lLoop is None:
+        lLoopStart, lLoopEnd = 0, lNumSamples
+    else:
+        lLoopStart, lLoopEnd = lLoop[0], min(lLoop[1] + 1, lNumSamples)
+
+    return lFmt, lData, lLoopStart, lLoopEnd
+
+
+def main(aArgs):
+    if len(aArgs) < 2:
+        print("Usage: pack_font_bundle.py output.bnd file1.wav [file2.wav ...]")
+        return 1
+
+    lOutputPath = aArgs[0]
+    if len(aArgs) - 1 > MAX_SOUNDS:
+        print("Too many sounds (%d), a bundle can hold at most %d (FONT_BUNDLE_MAX_SOUNDS)"
+              % (len(aArgs) - 1, MAX_SOUNDS))
+        return 1
+
+    lSounds = []
+    for lArg in aArgs[1:]:
+        if "=" in lArg:
+            lName, lPath = lArg.split("=", 1)
+        else:
+            lName, lPath = os.path.basename(lArg), lArg
+
+        if len(lName.encode()) >= NAME_SIZE:
+            print("Name too long (max %d characters): %s" % (NAME_SIZE - 1, lName))
+            return 1
+
+        try:
+            lSounds.append((lName,) + read_wav(lPath))
+        except ValueError as lError:
+            print(lError)
+            return 1
+
+    lOffset = align(struct.calcsize(HEADER_FORMAT) + struct.calcsize(ENTRY_FORMAT) * len(lSounds))
+    lEntries = []
+    lWavs = []
+    for lName, lFmt, lData, lLoopStart, lLoopEnd in lSounds:
+        lWav = (struct.pack("<4sI4s4sI", b"RIFF", 36 + len(lData), b"WAVE", b"fmt ", 16)
+                + lFmt + struct.pack("<4sI", b"data", len(lData)) + lData)
+        lChannels, lRate = struct.unpack_from("<HI", lFmt, 2)
+        lBits = struct.unpack_from("<H", lFmt, 14)[0]
+        lEntries.append(struct.pack(ENTRY_FORMAT, lName.encode(), lOffset, len(lWav),
+                                    lRate, lChannels, lBits, lLoopStart, lLoopEnd))
+        lWavs.append(lWav)
+        lOffset = align(lOffset + len(lWav))
+
+    with open(lOutputPath, "wb") as lOut:
+        lOut.write(struct.pack(HEADER_FORMAT, b"NFNT", VERSION, len(lSounds)))
+        for lEntry in lEntries:
+            lOut.write(lEntry)
+        for lWav in lWavs:
+            lOut.write(b"\0" * (align(lOut.tell()) - lOut.tell()))
+            lOut.write(lWav)
+
+    print("Packed %d sounds into %s (%d bytes)" % (len(lSounds), lOutputPath, lOffset))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
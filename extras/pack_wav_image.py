@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# Packs a set of wav files into a single indexed image that MappedWavFile
+# can play straight out of memory-mapped (XIP) QSPI flash.
+#
+# Image layout (all values little-endian):
+#   "NWAV"                  4 bytes magic
+#   entry count             uint32
+#   entries[count]          24 byte null terminated name, uint32 offset, uint32 size
+#   wav files               each one starts on a 4 byte boundary
+#
+# Usage: pack_wav_image.py output.bin file1.wav [file2.wav ...]
+# Files are stored under their base name unless given as NAME=path.
+
+import os
+import struct
+import sys
+
+NAME_SIZE = 24
+HEADER_FORMAT = "<4sI"
+ENTRY_FORMAT = "<%dsII" % NAME_SIZE
+ALIGNMENT = 4
+
+
+def align(aValue):
+    return (aValue + ALIGNMENT - 1) & ~(ALIGNMENT - 1)
+
+
+def main(aArgs):
+    if len(aArgs) < 2:
+        print("Usage: pack_wav_image.py output.bin file1.wav [file2.wav ...]")
+        return 1
+
+    lOutputPath = aArgs[0]
+    lFiles = []
+    for lArg in aArgs[1:]:
+        if "=" in lArg:
+            lName, lPath = lArg.split("=", 1)
+        else:
+            lName, lPath = os.path.basename(lArg), lArg
+
+        if len(lName.encode()) >= NAME_SIZE:
+            print("Name too long (max %d characters): %s" % (NAME_SIZE - 1, lName))
+            return 1
+
+        with open(lPath, "rb") as lFile:
+            lData = lFile.read()
+
+        if lData[0:4] != b"RIFF" or lData[8:12] != b"WAVE":
+            print("Not a wav file: %s" % lPath)
+            return 1
+
+        lFiles.append((lName, lData))
+
+    lOffset = align(struct.calcsize(HEADER_FORMAT) + struct.calcsize(ENTRY_FORMAT) * len(lFiles))
+    lEntries = []
+    for lName, lData in lFiles:
+        lEntries.append(struct.pack(ENTRY_FORMAT, lName.encode(), lOffset, len(lData)))
+        lOffset = align(lOffset + len(lData))
+
+    with open(lOutputPath, "wb") as lOut:
+        lOut.write(struct.pack(HEADER_FORMAT, b"NWAV", len(lFiles)))
+        for lEntry in lEntries:
+            lOut.write(lEntry)
+        for lName, lData in lFiles:
+            lOut.write(b"\0" * (align(lOut.tell()) - lOut.tell()))
+            lOut.write(lData)
+
+    print("Packed %d files into %s (%d bytes)" % (len(lFiles), lOutputPath, lOffset))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
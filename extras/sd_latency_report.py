@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# Summarizes SD card read latency captured with the nrf52_SDQualify example.
+# Save the sketch's serial output to a file per card, then run this on the
+# files to compare the cards side by side. Several runs in one file (for
+# example with the card warm and cold) are combined.
+#
+# The sketch prints the raw histogram as:
+#   RUN,voices,output rate,bytes per second per voice,I2S_BUF_SIZE,DATA_BLOCK_SIZE
+#   LAT,largest read size (0 = no limit),bucket top (us),count
+#   MAX,largest read size (0 = no limit),longest read (us)
+#   END
+#
+# For each card this prints p50, p99 and max read latency per read size, the
+# output block and read-ahead depth it takes to ride out the p99 and max
+# reads, and whether the card fits the buffers the sketch ran with.
+#
+# Usage: sd_latency_report.py [--mix-ms N] card1.log [card2.log ...]
+#   --mix-ms  Normal time to mix one block (default 10), added to the read
+#             latency when working out the output block size
+
+import sys
+
+PREFETCH_BLOCKS = 4  # IO_SCHEDULER_PREFETCH_BLOCKS
+
+
+class CardLog(object):
+    def __init__(self, aPath):
+        self.mPath = aPath
+        self.mBuckets = {}  # read size -> {bucket top: count}
+        self.mMax = {}      # read size -> longest read
+        self.mVoices = 0
+        self.mRate = 0
+        self.mBytesPerSecond = 0
+        self.mBlockFrames = 0
+        self.mDataBlockSize = 0
+        self.mNumRuns = 0
+
+
+def read_log(aPath):
+    lLog = CardLog(aPath)
+    with open(aPath, "r", errors="replace") as lFile:
+        for lLine in lFile:
+            lFields = lLine.strip().split(",")
+            try:
+                if lFields[0] == "RUN" and len(lFields) >= 6:
+                    lLog.mVoices, lLog.mRate, lLog.mBytesPerSecond, lLog.mBlockFrames, lLog.mDataBlockSize = \
+                        [int(lValue) for lValue in lFields[1:6]]
+                    lLog.mNumRuns += 1
+                elif lFields[0] == "LAT" and len(lFields) >= 4:
+                    lSize, lTop, lCount = [int(lValue) for lValue in lFields[1:4]]
+                    lBuckets = lLog.mBuckets.setdefault(lSize, {})
+                    lBuckets[lTop] = lBuckets.get(lTop, 0) + lCount
+                elif lFields[0] == "MAX" and len(lFields) >= 3:
+                    lSize, lMax = int(lFields[1]), int(lFields[2])
+                    lLog.mMax[lSize] = max(lLog.mMax.get(lSize, 0), lMax)
+            except ValueError:
+                continue  # Garbled serial line
+    return lLog
+
+
+def merge(aBucketSets):
+    lMerged = {}
+    for lBuckets in aBucketSets:
+        for lTop, lCount in lBuckets.items():
+            lMerged[lTop] = lMerged.get(lTop, 0) + lCount
+    return lMerged
+
+
+def percentile(aBuckets, aMax, aPercentile):
+    """Latency (us) that aPercentile percent of reads stayed under, rounded up to the bucket top."""
+    lCount = sum(aBuckets.values())
+    if lCount == 0:
+        return 0
+    lTarget = max(1, -(-lCount * aPercentile // 100))
+    lSeen = 0
+    for lTop in sorted(aBuckets):
+        lSeen += aBuckets[lTop]
+        if lSeen >= lTarget:
+            return min(lTop, aMax)
+    return aMax
+
+
+def block_frames(aLog, aLatency, aMixMicros):
+    return -(-(aLatency + aMixMicros) * aLog.mRate // 1000000)
+
+
+def prefetch_blocks(aLog, aLatency):
+    return -(-aLatency * aLog.mBytesPerSecond // (1000000 * aLog.mDataBlockSize)) + 1
+
+
+def size_label(aSize):
+    return "<= %d B" % aSize if aSize else "larger"
+
+
+def report(aLog, aMixMicros):
+    print("%s (%d run%s, %d voices at %d Hz)" % (aLog.mPath, aLog.mNumRuns, "" if aLog.mNumRuns == 1 else "s",
+                                                 aLog.mVoices, aLog.mRate))
+
+    lSizes = sorted(aLog.mBuckets, key=lambda lSize: lSize if lSize else 1 << 32)
+    lRows = [(size_label(lSize), aLog.mBuckets[lSize], aLog.mMax.get(lSize, 0)) for lSize in lSizes]
+    lAll = merge(aLog.mBuckets.values())
+    lAllMax = max(aLog.mMax.values()) if aLog.mMax else 0
+    lRows.append(("all reads", lAll, lAllMax))
+
+    print("  %-10s %10s %10s %10s %10s" % ("reads", "count", "p50 (us)", "p99 (us)", "max (us)"))
+    for lLabel, lBuckets, lMax in lRows:
+        print("  %-10s %10d %10d %10d %10d" % (lLabel, sum(lBuckets.values()), percentile(lBuckets, lMax, 50),
+                                              percentile(lBuckets, lMax, 99), lMax))
+
+    lFits = True
+    for lLabel, lLatency in (("p99", percentile(lAll, lAllMax, 99)), ("max", lAllMax)):
+        lFrames = block_frames(aLog, lLatency, aMixMicros)
+        lBlocks = prefetch_blocks(aLog, lLatency)
+        print("  to survive %s: output block >= %d frames (have %d), read-ahead >= %d blocks per voice (have %d)"
+              % (lLabel, lFrames, aLog.mBlockFrames, lBlocks, PREFETCH_BLOCKS))
+        lFits = lFits and lFrames <= aLog.mBlockFrames
+
+    print("  verdict: %s" % ("PASS" if lFits else "FAIL, reads outlast the output block"))
+    print("")
+    return lFits
+
+
+def main(aArgs):
+    lMixMicros = 10000
+    lPaths = []
+    lIdx = 0
+    while lIdx < len(aArgs):
+        if aArgs[lIdx] == "--mix-ms" and lIdx + 1 < len(aArgs):
+            lMixMicros = int(float(aArgs[lIdx + 1]) * 1000)
+            lIdx += 2
+        else:
+            lPaths.append(aArgs[lIdx])
+            lIdx += 1
+
+    if not lPaths:
+        print("Usage: sd_latency_report.py [--mix-ms N] card1.log [card2.log ...]")
+        return 1
+
+    lAllPassed = True
+    for lPath in lPaths:
+        lLog = read_log(lPath)
+        if lLog.mNumRuns == 0:
+            print("%s: no RUN line found, is this nrf52_SDQualify output?" % lPath)
+            lAllPassed = False
+            continue
+        lAllPassed = report(lLog, lMixMicros) and lAllPassed
+
+    return 0 if lAllPassed else 2
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -27,9 +27,32 @@
 	#include <SD.h>
 #endif
 
+#include "AudioAlloc.h"
+#include "PlayerCommandQueue.h"
+#include "MasterLimiter.h"
+#include "IAudioSink.h"
+#include "I2SAudioSink.h"
+#include "PWMAudioSink.h"
+#include "NullAudioSink.h"
+#include "WavFileAudioSink.h"
 #include "I2SWavPlayer.h"
+#include "AudioRuntime.h"
+#include "SharedFileTable.h"
+#include "IOScheduler.h"
+#include "ReadLatencyHistogram.h"
+#include "G711.h"
+#include "IWavFileEventSink.h"
+#include "WavFileHandle.h"
 #include "SDWavFile.h"
 #include "PitchShiftSDWavFile.h"
 #include "ChainedSDWavFile.h"
+#include "MappedWavFile.h"
+#include "FontBundle.h"
+#include "BundleWavFile.h"
+#include "IAudioEffect.h"
+#include "BiquadFilter.h"
+#include "EffectChainWavFile.h"
+#include "TimeStretchWavFile.h"
+#include "SmoothSwingWavFile.h"
 
 #endif